@@ -15,10 +15,22 @@
 
 /*--------------------------------------------- INCLUDES --------------------------------------------------*/
 #include "SCI_uart.h"
+#include "TIM_timers.h"
 #include "LOG_uartLogger.h"
 
 /*----------------------------------------- MACROS Definitions --------------------------------------------*/
 
+#define LOG_u8RING_MASK			(LOG_u8RING_SIZE - 1U)
+/* SYNC + LEN + CHK around the LEN counted bytes */
+#define LOG_u8FRAME_OVERHEAD	3U
+/* SIG + FMT_ID + TIME_MS */
+#define LOG_u8FRAME_HEADER		7U
+#define LOG_u8MAX_FRAME_SIZE	(LOG_u8FRAME_OVERHEAD + LOG_u8FRAME_HEADER + (LOG_u8MAX_ARGS * 4U))
+
+#if ((LOG_u8RING_SIZE & LOG_u8RING_MASK) != 0U) || (LOG_u8RING_SIZE > 128U)
+#error "LOG_u8RING_SIZE must be a power of two not larger than 128"
+#endif
+
 /*-------------------------------------Static functions Declarations --------------------------------------*/
 
 static void uart_putchar(char c, FILE *stream);
@@ -31,6 +43,15 @@ FILE uart_output = FDEV_SETUP_STREAM(uart_putchar, NULL, _FDEV_SETUP_WRITE);
 FILE uart_input = FDEV_SETUP_STREAM(NULL, uart_getchar, _FDEV_SETUP_READ);
 FILE uart_io = FDEV_SETUP_STREAM(uart_putchar, uart_getchar, _FDEV_SETUP_RW);
 
+#if (LOG_MODE == LOG_MODE_DEFERRED)
+/* deferred records ring, filled from any context (ISRs included) and drained by LOG_vidDrain only */
+static uint8 au8LogRing[LOG_u8RING_SIZE];
+static volatile uint8 u8LogHead = 0;
+static volatile uint8 u8LogTail = 0;
+/* records dropped on a full ring and not reported yet */
+static uint16 u16LogLost = 0;
+#endif
+
 /*-------------------------------------Static functions Definitions ---------------------------------------*/
 
 static void uart_putchar(char c, FILE *stream) {
@@ -44,6 +65,25 @@ static char uart_getchar(FILE *stream) {
 	return UART_recieveByte();
 }
 
+#if (LOG_MODE == LOG_MODE_DEFERRED)
+/* Append a frame around the LEN counted bytes in au8Body to the ring, interrupts must be disabled */
+static void LOG_vidPushFrame(const uint8 *pu8Body, uint8 u8Len)
+{
+	uint8 u8Head = u8LogHead;
+	uint8 u8Chk = u8Len;
+	uint8 u8Index;
+
+	au8LogRing[u8Head++ & LOG_u8RING_MASK] = LOG_u8FRAME_SYNC;
+	au8LogRing[u8Head++ & LOG_u8RING_MASK] = u8Len;
+	for (u8Index = 0; u8Index < u8Len; u8Index++){
+		au8LogRing[u8Head++ & LOG_u8RING_MASK] = pu8Body[u8Index];
+		u8Chk ^= pu8Body[u8Index];
+	}
+	au8LogRing[u8Head++ & LOG_u8RING_MASK] = u8Chk;
+	u8LogHead = u8Head;
+}
+#endif
+
 /*------------------------------------ Global Functions Definitions----------------------------------------*/
 
 /************************************************************************************************************
@@ -64,31 +104,30 @@ extern void LOG_vidInit(void){
 
 
 /************************************************************************************************************
-* Function				: LOG_vidPrint
-* Description			: Print a string to the UART terminal.
-* Parameters[in]		: Multiple arguments that will be appended into a string and sent to the UART channel
+* Function				: LOG_vidPrint_P
+* Description			: Print a string to the UART terminal, the format string is read from flash.
+						  Normally used through the LOG_vidPrint macro which places the literal in flash.
+* Parameters[in]		: [pcFormat] format string located in flash (PSTR / PROGMEM)
+						  [...] arguments of the format string
 * Parameters[in/out]	: None
 * Parameters[out]		: None
 *
 Note : This function will initialize the default UART peripheral if it is not initialized
 *************************************************************************************************************/
-extern void LOG_vidPrint(char * format, ...){
+extern void LOG_vidPrint_P(const char * pcFormat, ...){
 	if ( bLoggerInitialized == FALSE ){
 		LOG_vidInit();
-		bLoggerInitialized = TRUE;
 	}
-	char debugMsg[DBG_BUF_MAX_SIZE];
 	va_list ap;
-	va_start(ap, format);
-	vsnprintf(debugMsg, DBG_BUF_MAX_SIZE, format, ap);
-	printf(debugMsg);
+	va_start(ap, pcFormat);
+	vfprintf_P(stdout, pcFormat, ap);
 	va_end(ap);
-
 }
 
 /************************************************************************************************************
 * Function				: LOG_vidPrintLn
-* Description			: Print a string in one line to the UART terminal.
+* Description			: Print a string in one line to the UART terminal, for format strings built in RAM at
+						  run time (literals should go through INFO).
 * Parameters[in]		: Multiple arguments that will be appended into a string and sent to the UART channel
 * Parameters[in/out]	: None
 * Parameters[out]		: None
@@ -106,4 +145,149 @@ extern void LOG_vidPrintLn(char * format, ...){
 	vsnprintf(debugMsg, DBG_BUF_MAX_SIZE, format, ap);
 	printf("%s\r",debugMsg);
 	va_end(ap);
-}
\ No newline at end of file
+}
+
+/************************************************************************************************************
+* Function				: LOG_vidPrintLn_P
+* Description			: Print a string in one line to the UART terminal, the format string is read from
+						  flash. Normally used through the INFO macro which places the literal in flash.
+* Parameters[in]		: [pcFormat] format string located in flash (PSTR / PROGMEM)
+						  [...] arguments of the format string
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+Note : This function will initialize the default UART peripheral if it is not initialized
+*************************************************************************************************************/
+extern void LOG_vidPrintLn_P(const char * pcFormat, ...){
+	if ( bLoggerInitialized == FALSE ){
+		LOG_vidInit();
+	}
+	/* formatted straight to the UART stream, no RAM copy of the format nor of the message */
+	va_list ap;
+	va_start(ap, pcFormat);
+	vfprintf_P(stdout, pcFormat, ap);
+	va_end(ap);
+	putchar('\r');
+}
+
+/************************************************************************************************************
+* Function				: LOG_vidDeferredPrintLn
+* Description			: Record one line in the deferred log ring without formatting it, safe to be called
+						  from ISRs. Use it through the INFO macro which builds the argument signature.
+* Parameters[in]		: [pcFormat] format string located in flash (its address is the record ID)
+						  [u8ArgSig] argument signature (see frame layout in LOG_uartLogger.h)
+						  [...] up to LOG_u8MAX_ARGS arguments
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+Note : If the ring is full the record is dropped and reported by a lost-records frame later on
+*************************************************************************************************************/
+extern void LOG_vidDeferredPrintLn(const char * pcFormat, uint8 u8ArgSig, ...){
+#if (LOG_MODE == LOG_MODE_DEFERRED)
+	uint8 au8Body[LOG_u8FRAME_HEADER + (LOG_u8MAX_ARGS * 4U)];
+	uint8 u8Len = LOG_u8FRAME_HEADER;
+	uint8 u8ArgCount = u8ArgSig >> 4;
+	uint8 u8LongMask = u8ArgSig;
+	uint16 u16FmtId = (uint16)(uintptr_t)pcFormat;
+	uint32 u32Value = TIM_u32GetMillis();
+	uint8 au8Lost[LOG_u8FRAME_HEADER + 2U];
+	uint8 u8Free;
+	uint8 u8Sreg;
+	va_list ap;
+
+	au8Body[0] = u8ArgSig;
+	au8Body[1] = (uint8)u16FmtId;
+	au8Body[2] = (uint8)(u16FmtId >> 8);
+	au8Body[3] = (uint8)u32Value;
+	au8Body[4] = (uint8)(u32Value >> 8);
+	au8Body[5] = (uint8)(u32Value >> 16);
+	au8Body[6] = (uint8)(u32Value >> 24);
+
+	va_start(ap, u8ArgSig);
+	while (u8ArgCount != 0U){
+		if (u8LongMask & 0x01U){
+			u32Value = (uint32)va_arg(ap, unsigned long);
+			au8Body[u8Len++] = (uint8)u32Value;
+			au8Body[u8Len++] = (uint8)(u32Value >> 8);
+			au8Body[u8Len++] = (uint8)(u32Value >> 16);
+			au8Body[u8Len++] = (uint8)(u32Value >> 24);
+		} else {
+			u32Value = (uint16)va_arg(ap, unsigned int);
+			au8Body[u8Len++] = (uint8)u32Value;
+			au8Body[u8Len++] = (uint8)(u32Value >> 8);
+		}
+		u8LongMask >>= 1;
+		u8ArgCount--;
+	}
+	va_end(ap);
+
+	/* this may preempt (or be preempted by) another producer, so claim the ring with interrupts off */
+	u8Sreg = SREG;
+	cli();
+	u8Free = (uint8)(LOG_u8RING_SIZE - (uint8)(u8LogHead - u8LogTail));
+	if ((u16LogLost != 0U) && (u8Free >= (uint8)(sizeof(au8Lost) + LOG_u8FRAME_OVERHEAD + u8Len + LOG_u8FRAME_OVERHEAD))){
+		/* report the lost records before this one: ID 0, one int argument */
+		au8Lost[0] = 0x10U;
+		au8Lost[1] = 0U;
+		au8Lost[2] = 0U;
+		au8Lost[3] = au8Body[3];
+		au8Lost[4] = au8Body[4];
+		au8Lost[5] = au8Body[5];
+		au8Lost[6] = au8Body[6];
+		au8Lost[7] = (uint8)u16LogLost;
+		au8Lost[8] = (uint8)(u16LogLost >> 8);
+		LOG_vidPushFrame(au8Lost, sizeof(au8Lost));
+		u16LogLost = 0U;
+		u8Free -= (uint8)(sizeof(au8Lost) + LOG_u8FRAME_OVERHEAD);
+	}
+	if ((u16LogLost == 0U) && (u8Free >= (uint8)(u8Len + LOG_u8FRAME_OVERHEAD))){
+		LOG_vidPushFrame(au8Body, u8Len);
+	} else if (u16LogLost != 0xFFFFU){
+		u16LogLost++;
+	} else {
+		/* saturated */
+	}
+	SREG = u8Sreg;
+#else
+	(void)pcFormat;
+	(void)u8ArgSig;
+#endif
+}
+
+/************************************************************************************************************
+* Function				: LOG_vidDrain
+* Description			: Move complete deferred log frames to the UART TX ring as long as they fit. Call it
+						  from the main loop (low priority), it never blocks. Does nothing in text mode.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void LOG_vidDrain(void){
+#if (LOG_MODE == LOG_MODE_DEFERRED)
+	uint8 au8Frame[LOG_u8MAX_FRAME_SIZE];
+	uint8 u8Tail = u8LogTail;
+	uint8 u8Size;
+	uint8 u8Index;
+
+	if ( bLoggerInitialized == FALSE ){
+		LOG_vidInit();
+	}
+	/* only whole frames are handed to the UART so text printed in between never splits a frame */
+	while (u8Tail != u8LogHead){
+		u8Size = au8LogRing[(uint8)(u8Tail + 1U) & LOG_u8RING_MASK] + LOG_u8FRAME_OVERHEAD;
+		if (u8Size > UART_u8GetTxFree()){
+			break;
+		}
+		for (u8Index = 0; u8Index < u8Size; u8Index++){
+			au8Frame[u8Index] = au8LogRing[(uint8)(u8Tail + u8Index) & LOG_u8RING_MASK];
+		}
+		/* an ISR may have taken TX space since the check, the frame stays queued unless all of it fits */
+		if (UART_u8WriteAll(au8Frame, u8Size) == 0U){
+			break;
+		}
+		u8Tail = (uint8)(u8Tail + u8Size);
+		u8LogTail = u8Tail;
+	}
+#endif
+}
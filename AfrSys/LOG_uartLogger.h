@@ -18,12 +18,66 @@
 /*--------------------------------------------- INCLUDES --------------------------------------------------*/
 #include <stdio.h>
 #include <stdarg.h>
+#include "Std_Types.h"
+#include "MCU.h"
 
 /*----------------------------------------- MACROS Definitions --------------------------------------------*/
 #define SERIAL_DEBUGGER_BAUD_RATE__ 9600u
 #define DBG_BUF_MAX_SIZE 100U
-/* wrapper to print one line to the UART terminal*/
-#define INFO(...) LOG_vidPrintLn((char*)__VA_ARGS__)
+
+/* Logging modes:
+   LOG_MODE_TEXT     : INFO formats the message and queues the text on the UART right away.
+   LOG_MODE_DEFERRED : INFO only stores the flash address of the format string, a time stamp and the raw
+					   arguments in a RAM ring; LOG_vidDrain sends them later as binary frames which are
+					   turned back into text on the host by tools/LOG_decoder. */
+#define LOG_MODE_TEXT		0U
+#define LOG_MODE_DEFERRED	1U
+
+#ifndef LOG_MODE
+#define LOG_MODE			LOG_MODE_TEXT
+#endif
+
+/* deferred mode RAM ring size, must be a power of two not larger than 128 bytes */
+#define LOG_u8RING_SIZE		128U
+
+/* deferred mode frame layout (multi-byte fields are little endian):
+   | SYNC | LEN | SIG | FMT_ID (2) | TIME_MS (4) | ARGS (0..16) | CHK |
+   LEN : number of bytes from SIG up to the last argument byte
+   SIG : high nibble = number of arguments, bit n of the low nibble set = argument n is 4 bytes wide
+		 (long), otherwise 2 bytes wide (int, char, pointer)
+   CHK : XOR of all bytes from LEN up to the last argument byte
+   A frame with FMT_ID 0 reports records lost on a full ring, its only argument is the lost count. */
+#define LOG_u8FRAME_SYNC	0xA5U
+#define LOG_u8MAX_ARGS		4U
+
+#if (LOG_MODE == LOG_MODE_DEFERRED)
+
+/* argument signature computed at compile time, arguments are taken after default promotion */
+#define LOG_ARG_IS_LONG(ARG)			((sizeof((ARG) + 0) > sizeof(int)) ? 1U : 0U)
+#define LOG_SIG0(F)						(0x00U)
+#define LOG_SIG1(F,A)					(0x10U | LOG_ARG_IS_LONG(A))
+#define LOG_SIG2(F,A,B)					(0x20U | LOG_ARG_IS_LONG(A) | (LOG_ARG_IS_LONG(B)<<1))
+#define LOG_SIG3(F,A,B,C)				(0x30U | LOG_ARG_IS_LONG(A) | (LOG_ARG_IS_LONG(B)<<1) | \
+										 (LOG_ARG_IS_LONG(C)<<2))
+#define LOG_SIG4(F,A,B,C,D)				(0x40U | LOG_ARG_IS_LONG(A) | (LOG_ARG_IS_LONG(B)<<1) | \
+										 (LOG_ARG_IS_LONG(C)<<2) | (LOG_ARG_IS_LONG(D)<<3))
+#define LOG_SIG_SELECT(F,A,B,C,D,SIG,...)	SIG
+/* more than LOG_u8MAX_ARGS arguments fail to compile on the macro arity */
+#define LOG_ARGS_SIG(...)				LOG_SIG_SELECT(__VA_ARGS__,LOG_SIG4,LOG_SIG3,LOG_SIG2,LOG_SIG1,LOG_SIG0,~)(__VA_ARGS__)
+
+/* wrapper to record one line, cheap enough to be used inside ISRs. %s arguments are recorded as their
+   RAM address (the string itself is not copied), %f is not supported */
+#define INFO(FMT, ...) LOG_vidDeferredPrintLn(PSTR(FMT), LOG_ARGS_SIG(FMT, ##__VA_ARGS__), ##__VA_ARGS__)
+
+#else
+
+/* wrapper to print one line to the UART terminal, the format string is placed in flash */
+#define INFO(FMT, ...) LOG_vidPrintLn_P(PSTR(FMT), ##__VA_ARGS__)
+
+#endif
+
+/* print to the UART terminal, the format string is placed in flash */
+#define LOG_vidPrint(FMT, ...) LOG_vidPrint_P(PSTR(FMT), ##__VA_ARGS__)
 
 /*------------------------------------------ Global Variables ---------------------------------------------*/
 
@@ -41,19 +95,22 @@
 extern void LOG_vidInit(void);
 
 /************************************************************************************************************
-* Function				: LOG_vidPrint
-* Description			: Print a string to the UART terminal.
-* Parameters[in]		: Multiple arguments that will be appended into a string and sent to the UART channel
+* Function				: LOG_vidPrint_P
+* Description			: Print a string to the UART terminal, the format string is read from flash.
+						  Normally used through the LOG_vidPrint macro which places the literal in flash.
+* Parameters[in]		: [pcFormat] format string located in flash (PSTR / PROGMEM)
+						  [...] arguments of the format string
 * Parameters[in/out]	: None
 * Parameters[out]		: None
 *
 Note : This function will initialize the default UART peripheral if it is not initialized
 *************************************************************************************************************/
-extern void LOG_vidPrint(char * format, ...);
+extern void LOG_vidPrint_P(const char * pcFormat, ...);
 
 /************************************************************************************************************
 * Function				: LOG_vidPrintLn
-* Description			: Print a string in one line to the UART terminal.
+* Description			: Print a string in one line to the UART terminal, for format strings built in RAM at
+						  run time (literals should go through INFO).
 * Parameters[in]		: Multiple arguments that will be appended into a string and sent to the UART channel
 * Parameters[in/out]	: None
 * Parameters[out]		: None
@@ -62,6 +119,44 @@ Note : This function will initialize the default UART peripheral if it is not in
 *************************************************************************************************************/
 extern void LOG_vidPrintLn(char * format, ...);
 
+/************************************************************************************************************
+* Function				: LOG_vidPrintLn_P
+* Description			: Print a string in one line to the UART terminal, the format string is read from
+						  flash. Normally used through the INFO macro which places the literal in flash.
+* Parameters[in]		: [pcFormat] format string located in flash (PSTR / PROGMEM)
+						  [...] arguments of the format string
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+Note : This function will initialize the default UART peripheral if it is not initialized
+*************************************************************************************************************/
+extern void LOG_vidPrintLn_P(const char * pcFormat, ...);
+
+/************************************************************************************************************
+* Function				: LOG_vidDeferredPrintLn
+* Description			: Record one line in the deferred log ring without formatting it, safe to be called
+						  from ISRs. Use it through the INFO macro which builds the argument signature.
+* Parameters[in]		: [pcFormat] format string located in flash (its address is the record ID)
+						  [u8ArgSig] argument signature (see frame layout above)
+						  [...] up to LOG_u8MAX_ARGS arguments
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+Note : If the ring is full the record is dropped and reported by a lost-records frame later on
+*************************************************************************************************************/
+extern void LOG_vidDeferredPrintLn(const char * pcFormat, uint8 u8ArgSig, ...);
+
+/************************************************************************************************************
+* Function				: LOG_vidDrain
+* Description			: Move complete deferred log frames to the UART TX ring as long as they fit. Call it
+						  from the main loop (low priority), it never blocks. Does nothing in text mode.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void LOG_vidDrain(void);
+
 
 
 
@@ -17,20 +17,195 @@
 /*------------------------------------------------- INCLUDES ----------------------------------------------*/
 #include "DIO.h"
 #include "LOG_uartLogger.h"
+#include "SCI_uart.h"
+#include "TIM_timers.h"
 
 #include "ADC.h"
 
 /*--------------------------------------------- MACROS Definitions -----------------------------------------*/
 
+/* owner of the ADC */
+#define ADC_u8STATE_IDLE		0U
+#define ADC_u8STATE_SCAN		1U
+#define ADC_u8STATE_SINGLE		2U		/* ADC_u16Read, for all the samples of the read	*/
+#define ADC_u8STATE_ASYNC		3U		/* ADC_eStartConversion						*/
 
+/* ADC clock division factor of ADC_PRESCALER (ADPS = 0 divides by 2 like ADPS = 1) */
+#define ADC_u16CLK_DIV			(uint16)((ADC_PRESCALER == 0U) ? 2U : (1U << ADC_PRESCALER))
+/* I/O clock halted by one conversion in the ADC sleep mode: 13 ADC clocks */
+#define ADC_u16SLEEP_US			(uint16)((13UL * ADC_u16CLK_DIV * 1000000UL) / F_CPU)
 
 
 /*---------------------------------------------- Global Variables -----------------------------------------*/
 
+static volatile uint8 u8AdcState = ADC_u8STATE_IDLE;
+
+/* scan engine */
+static uint8 au8AdcScanCh[ADC_u8SCAN_MAX_CH];
+static uint8 u8AdcScanNoOfCh = 0U;
+static ADC_tpfvidScanClbk pfvAdcScanClbk = NULL;
+static uint8 u8AdcScanMode;
+/* channel being converted */
+static uint8 u8AdcScanIndex;
+/* double buffer: the ISR fills au16AdcScanBuf[u8AdcScanBack], the other one holds the last sweep */
+static uint16 au16AdcScanBuf[2][ADC_u8SCAN_MAX_CH];
+static uint8 u8AdcScanBack;
+static volatile uint8 u8AdcScanNew = FALSE;
+
+/* conversion of ADC_u16Read completed by the ISR */
+static volatile uint8 u8AdcSingleDone;
+
+/* asynchronous conversion */
+static uint8 u8AdcAsyncCh;
+static ADC_tpfvidConvClbk pfvAdcConvClbk;
+
+/* oversampling extra bits per channel */
+static uint8 au8AdcOsBits[ADC_u8NO_OF_CH];
+/* running oversampling accumulation of the scanned channel */
+static uint16 u16AdcOsAcc;
+static uint8 u8AdcOsLeft;
+
 
 /*-------------------------------------------- FUNCTION Definitions ---------------------------------------*/
 
 
+/* select the channel of the next conversion, the reference and adjust bits are kept */
+static void ADC_vidSelectChannel(uint8 u8ChannelNum)
+{
+	ADMUX = (ADMUX & (uint8)~ADC_u8MUX_MASK) | (u8ChannelNum & ADC_u8MUX_MASK);
+}
+
+/* extra bits of a channel, the band gap / GND channels are never oversampled */
+static uint8 ADC_u8OsBits(uint8 u8ChannelNum)
+{
+	return (u8ChannelNum < ADC_u8NO_OF_CH) ? au8AdcOsBits[u8ChannelNum] : ADC_u8OS_10_BIT;
+}
+
+/* one conversion of the selected channel, spinning on ADIF */
+static uint16 ADC_u16ConvertPolled(void)
+{
+	/* Start Single conversion */
+	ADCSRA |= (1<<ADSC);
+
+	/* Wait for conversion to complete */
+	while(!(ADCSRA & (1<<ADIF)));
+
+	/* Clear ADIF by writing one to it */
+	ADCSRA|=(1<<ADIF);
+
+	return ADC;
+}
+
+/* one conversion of the selected channel */
+static uint16 ADC_u16Convert(void)
+{
+#if (ADC_READ_MODE == ADC_READ_NOISE_REDUCTION)
+	uint16 u16Result;
+	boolean bSlept = FALSE;
+
+	if ((SREG & (1<<SREG_I)) == 0U){
+		/* ISR or critical section of the caller: the sleep would enable the interrupts */
+		u16Result = ADC_u16ConvertPolled();
+	} else {
+		MCU_vidDisableInterrupts();
+		u8AdcSingleDone = FALSE;
+		ADCSRA |= (1<<ADIF);
+		ADCSRA |= (1<<ADIE);
+		/* entering the ADC sleep mode starts the conversion, other interrupts may wake the CPU before the
+		   end of it: they are served and the CPU goes back to sleep, the running conversion is not restarted */
+		while (u8AdcSingleDone == FALSE){
+			/* the USART stops with the I/O clock, a frame cut in the middle would be received as garbage */
+			UART_vidTxFlush();
+			if (MCU_eSleep(SLEEP_MODE_ADC) == STD_ERR_OK){
+				bSlept = TRUE;
+			} else {
+				/* refused by MCU_eSleep, finish the conversion by polling */
+				ADCSRA &= (uint8)~(1<<ADIE);
+				if ((ADCSRA & (1<<ADSC)) == 0U){
+					ADCSRA |= (1<<ADSC);
+				}
+				while(!(ADCSRA & (1<<ADIF)));
+				ADCSRA|=(1<<ADIF);
+				u8AdcSingleDone = TRUE;
+			}
+		}
+		if (bSlept != FALSE){
+			/* Timer 0 did not count during the conversion */
+			TIM_vidT0AddHaltedUs(ADC_u16SLEEP_US);
+		}
+		u16Result = ADC;
+		MCU_vidEnableInterrupts();
+	}
+	return u16Result;
+#else
+	return ADC_u16ConvertPolled();
+#endif
+}
+
+/* select a channel and arm its oversampling: 4^n = 1 << 2n samples */
+static void ADC_vidArmChannel(uint8 u8ChannelNum)
+{
+	ADC_vidSelectChannel(u8ChannelNum);
+	u16AdcOsAcc = 0U;
+	u8AdcOsLeft = (uint8)(1U << (ADC_u8OsBits(u8ChannelNum) << 1));
+}
+
+/************************************************************************************************************
+Function			: ADC_vect ISR routine
+Description			: ADC conversion complete, stores the result and starts the next channel of the sweep.
+Parameters[in]		: None
+Parameters[in/out]	: None
+Parameters[out]		: None
+*************************************************************************************************************/
+ISR(ADC_vect)
+{
+	uint16 *pu16Back;
+
+	if (u8AdcState == ADC_u8STATE_SINGLE){
+		/* ADC_u16Read reads the result, just wake it up (only enabled by a sleeping read) */
+		ADCSRA &= (uint8)~(1<<ADIE);
+		u8AdcSingleDone = TRUE;
+	} else if (u8AdcState == ADC_u8STATE_ASYNC){
+		u16AdcOsAcc += ADC;
+		if (--u8AdcOsLeft != 0U){
+			ADCSRA |= (1<<ADSC);
+		} else {
+			/* free the ADC first, the call back may start the next conversion */
+			ADCSRA &= (uint8)~(1<<ADIE);
+			u8AdcState = ADC_u8STATE_IDLE;
+			pfvAdcConvClbk(u16AdcOsAcc >> ADC_u8OsBits(u8AdcAsyncCh));
+		}
+	} else if (u8AdcState == ADC_u8STATE_SCAN){
+		u16AdcOsAcc += ADC;
+		if (--u8AdcOsLeft != 0U){
+			/* next sample of the same channel */
+			ADCSRA |= (1<<ADSC);
+			return;
+		}
+		pu16Back = au16AdcScanBuf[u8AdcScanBack];
+		/* decimation: sum of 4^n samples >> n */
+		pu16Back[u8AdcScanIndex] = u16AdcOsAcc >> ADC_u8OsBits(au8AdcScanCh[u8AdcScanIndex]);
+		u8AdcScanIndex++;
+		if (u8AdcScanIndex >= u8AdcScanNoOfCh){
+			/* sweep complete: publish the back buffer */
+			u8AdcScanBack ^= 1U;
+			u8AdcScanNew = TRUE;
+			u8AdcScanIndex = 0U;
+			if (u8AdcScanMode != ADC_SCAN_CONTINUOUS){
+				u8AdcState = ADC_u8STATE_IDLE;
+				ADCSRA &= (uint8)~(1<<ADIE);
+			}
+			if (pfvAdcScanClbk != NULL){
+				pfvAdcScanClbk(pu16Back);
+			}
+		}
+		if (u8AdcState == ADC_u8STATE_SCAN){
+			ADC_vidArmChannel(au8AdcScanCh[u8AdcScanIndex]);
+			ADCSRA |= (1<<ADSC);
+		}
+	}
+}
+
 /************************************************************************************************************
 * Function				: ADC_vidInit
 * Description			: ADC initialization routine.
@@ -83,29 +258,209 @@ extern void ADC_vidInit(void)
 /************************************************************************************************************
 * Function				: ADC_u16Read
 * Description			: Start Single conversion and return the ADC reading for selected channel.
+						  With ADC_READ_NOISE_REDUCTION the CPU sleeps during each conversion. The I/O clock
+						  is halted too: Timer 0 and a UART frame being sent are paused for about 104 us per
+						  sample. Called from inside a critical section it falls back to polling.
 * Parameters[in]		: [u8ChannelNum] selected channel to get reading for
-						  Range (0-5)
+						  Range (0-7, 14, 15)
 * Parameters[in/out]	: None
 * Parameters[out]		: [uint16] ADC reading.
+						  ADC_u16INVALID_READ while the ADC is busy (scan, ADC_eStartConversion, another read)
 *
 *************************************************************************************************************/
 extern uint16 ADC_u16Read(uint8 u8ChannelNum)
 {
-   //Select ADC Channel ch must be 0-5
-   u8ChannelNum = u8ChannelNum & 0x05;
-   ADMUX |= u8ChannelNum;
+	uint8 u8Bits;
+	uint8 u8Samples;
+	uint16 u16Acc = 0U;
+	uint8 u8Sreg = SREG;
 
-	MCU_vidDelay_10_us();
-	
-   /* Start Single conversion */
-   ADCSRA |= (1<<ADSC);
-
-   /* Wait for conversion to complete */
-   while(!(ADCSRA & (1<<ADIF)));
-
-   /* Clear ADIF by writing one to it */
-   ADCSRA|=(1<<ADIF);
-   //INFO("ADCL %d",ADCL);
-   //INFO("ADCH %d",ADCH);
-   return ADC;
-}
\ No newline at end of file
+	/* claim the ADC for all the samples, ADC_eStartConversion may be called from an ISR meanwhile */
+	cli();
+	if ((u8AdcState != ADC_u8STATE_IDLE) || ((ADCSRA & (1<<ADSC)) != 0U)){
+		SREG = u8Sreg;
+		return ADC_u16INVALID_READ;
+	}
+	u8AdcState = ADC_u8STATE_SINGLE;
+	SREG = u8Sreg;
+
+	/* Select ADC Channel, the previous channel bits are cleared first */
+	ADC_vidSelectChannel(u8ChannelNum);
+	u8Bits = ADC_u8OsBits(u8ChannelNum & ADC_u8MUX_MASK);
+
+	for (u8Samples = (uint8)(1U << (u8Bits << 1)); u8Samples != 0U; u8Samples--){
+		u16Acc += ADC_u16Convert();
+	}
+	u8AdcState = ADC_u8STATE_IDLE;
+	/* decimation: sum of 4^n samples >> n */
+	return u16Acc >> u8Bits;
+}
+
+/************************************************************************************************************
+* Function				: ADC_eSetOversampling
+* Description			: Set the resolution of a channel for ADC_u16Read and the scan engine. The 4^n samples
+						  are summed then decimated by a right shift of n bits, a conversion takes 4^n times
+						  longer (64 * 104 us at 125 kHz ADC clock for 13 bits). Oversampling only adds
+						  resolution if the input carries about 1 LSB of noise.
+* Parameters[in]		: [u8ChannelNum] Range (0-7)
+						  [u8ExtraBits] Range (ADC_u8OS_10_BIT, ADC_u8OS_11_BIT, ADC_u8OS_12_BIT, ADC_u8OS_13_BIT)
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on invalid parameters
+*
+*************************************************************************************************************/
+extern STD_ERR_T ADC_eSetOversampling(uint8 u8ChannelNum, uint8 u8ExtraBits)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint8 u8Sreg;
+
+	if ((u8ChannelNum < ADC_u8NO_OF_CH) && (u8ExtraBits <= ADC_u8OS_13_BIT)){
+		/* read by the ISR between the samples of a channel */
+		u8Sreg = SREG;
+		cli();
+		au8AdcOsBits[u8ChannelNum] = u8ExtraBits;
+		SREG = u8Sreg;
+		errRetVal = STD_ERR_OK;
+	}
+	return errRetVal;
+}
+
+/************************************************************************************************************
+* Function				: ADC_eScanInit
+* Description			: Set the channel list converted by the scan engine (stops a running scan).
+* Parameters[in]		: [pu8Channels] channels in conversion order, Range (0-7, 14, 15)
+						  [u8NoOfChannels] Range (1 - ADC_u8SCAN_MAX_CH)
+						  [pfvClbk] called from the ADC ISR at the end of every sweep, may be NULL
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on invalid parameters
+*
+*************************************************************************************************************/
+extern STD_ERR_T ADC_eScanInit(const uint8 *pu8Channels, uint8 u8NoOfChannels, ADC_tpfvidScanClbk pfvClbk)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint8 u8Index;
+
+	if ((pu8Channels != NULL) && (u8NoOfChannels != 0U) && (u8NoOfChannels <= ADC_u8SCAN_MAX_CH)){
+		ADC_vidScanStop();
+		for (u8Index = 0U; u8Index < u8NoOfChannels; u8Index++){
+			au8AdcScanCh[u8Index] = pu8Channels[u8Index] & ADC_u8MUX_MASK;
+		}
+		u8AdcScanNoOfCh = u8NoOfChannels;
+		pfvAdcScanClbk = pfvClbk;
+		u8AdcScanNew = FALSE;
+		errRetVal = STD_ERR_OK;
+	}
+	return errRetVal;
+}
+
+/************************************************************************************************************
+* Function				: ADC_eScanStart
+* Description			: Start converting the channel list back to back from the ADC ISR, the CPU never waits.
+						  Each sweep is written to the back buffer of a double buffer that is swapped when
+						  the sweep completes.
+* Parameters[in]		: [u8Mode] Range (ADC_SCAN_SINGLE, ADC_SCAN_CONTINUOUS)
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if a conversion is already running or no channel list is set
+*
+*************************************************************************************************************/
+extern STD_ERR_T ADC_eScanStart(uint8 u8Mode)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint8 u8Sreg = SREG;
+
+	cli();
+	/* ADSC still set: a polled conversion is running */
+	if ((u8AdcState == ADC_u8STATE_IDLE) && (u8AdcScanNoOfCh != 0U) && ((ADCSRA & (1<<ADSC)) == 0U)){
+		u8AdcScanMode = u8Mode;
+		u8AdcScanIndex = 0U;
+		u8AdcState = ADC_u8STATE_SCAN;
+		ADC_vidArmChannel(au8AdcScanCh[0]);
+		/* clear a stale flag so the ISR only sees our conversion */
+		ADCSRA |= (1<<ADIF);
+		ADCSRA |= (1<<ADIE) | (1<<ADSC);
+		errRetVal = STD_ERR_OK;
+	}
+	SREG = u8Sreg;
+	return errRetVal;
+}
+
+/************************************************************************************************************
+* Function				: ADC_vidScanStop
+* Description			: Stop a continuous scan, the sweep in progress is dropped.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void ADC_vidScanStop(void)
+{
+	uint8 u8Sreg = SREG;
+
+	cli();
+	if (u8AdcState == ADC_u8STATE_SCAN){
+		u8AdcState = ADC_u8STATE_IDLE;
+		ADCSRA &= (uint8)~(1<<ADIE);
+	}
+	SREG = u8Sreg;
+	/* let a running conversion end, ADC_u16Read and ADC_eScanStart need a free ADC */
+	while (ADCSRA & (1<<ADSC));
+	ADCSRA |= (1<<ADIF);
+}
+
+/************************************************************************************************************
+* Function				: ADC_eScanRead
+* Description			: Copy the last completed sweep.
+* Parameters[in]		: None
+* Parameters[in/out]	: [pu16Results] receives one reading per channel of the list
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if no new sweep completed since the last read
+*
+*************************************************************************************************************/
+extern STD_ERR_T ADC_eScanRead(uint16 *pu16Results)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	const uint16 *pu16Front;
+	uint8 u8Index;
+	uint8 u8Sreg;
+
+	if ((pu16Results != NULL) && (u8AdcScanNew != FALSE)){
+		/* the copy is short (6 words), a swap in the middle of it would mix two sweeps */
+		u8Sreg = SREG;
+		cli();
+		pu16Front = au16AdcScanBuf[u8AdcScanBack ^ 1U];
+		for (u8Index = 0U; u8Index < u8AdcScanNoOfCh; u8Index++){
+			pu16Results[u8Index] = pu16Front[u8Index];
+		}
+		u8AdcScanNew = FALSE;
+		SREG = u8Sreg;
+		errRetVal = STD_ERR_OK;
+	}
+	return errRetVal;
+}
+
+/************************************************************************************************************
+* Function				: ADC_eStartConversion
+* Description			: Start a conversion (with the channel oversampling) and return at once, the result is
+						  given to pfvClbk from the ADC ISR. Safe to call from an ISR (e.g. a timer trigger).
+* Parameters[in]		: [u8ChannelNum] Range (0-7, 14, 15)
+						  [pfvClbk] end of conversion call back, must not be NULL
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the ADC is busy
+*
+*************************************************************************************************************/
+extern STD_ERR_T ADC_eStartConversion(uint8 u8ChannelNum, ADC_tpfvidConvClbk pfvClbk)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint8 u8Sreg = SREG;
+
+	cli();
+	if ((pfvClbk != NULL) && (u8AdcState == ADC_u8STATE_IDLE) && ((ADCSRA & (1<<ADSC)) == 0U)){
+		u8AdcAsyncCh = u8ChannelNum & ADC_u8MUX_MASK;
+		pfvAdcConvClbk = pfvClbk;
+		u8AdcState = ADC_u8STATE_ASYNC;
+		ADC_vidArmChannel(u8AdcAsyncCh);
+		ADCSRA |= (1<<ADIF);
+		ADCSRA |= (1<<ADIE) | (1<<ADSC);
+		errRetVal = STD_ERR_OK;
+	}
+	SREG = u8Sreg;
+	return errRetVal;
+}
@@ -46,18 +46,54 @@ REFS1 REFS0			Voltage Reference Selection
 #define ADC_INTERRUPT_ENABLED  1u
 #define ADC_INTERRUPT_DISABLED 0u
 
-#define ADC_PRESCALER_2    ((0<<ADPS2)|(0<<ADPS1)|(1<<ADPS1))
-#define ADC_PRESCALER_4    ((0<<ADPS2)|(1<<ADPS1)|(0<<ADPS1))
-#define ADC_PRESCALER_8    ((0<<ADPS2)|(1<<ADPS1)|(1<<ADPS1))
-#define ADC_PRESCALER_16   ((1<<ADPS2)|(0<<ADPS1)|(0<<ADPS1))
-#define ADC_PRESCALER_32   ((1<<ADPS2)|(0<<ADPS1)|(1<<ADPS1))
-#define ADC_PRESCALER_64   ((1<<ADPS2)|(1<<ADPS1)|(0<<ADPS1))
-#define ADC_PRESCALER_128  ((1<<ADPS2)|(1<<ADPS1)|(1<<ADPS1))
+#define ADC_PRESCALER_2    ((0<<ADPS2)|(0<<ADPS1)|(1<<ADPS0))
+#define ADC_PRESCALER_4    ((0<<ADPS2)|(1<<ADPS1)|(0<<ADPS0))
+#define ADC_PRESCALER_8    ((0<<ADPS2)|(1<<ADPS1)|(1<<ADPS0))
+#define ADC_PRESCALER_16   ((1<<ADPS2)|(0<<ADPS1)|(0<<ADPS0))
+#define ADC_PRESCALER_32   ((1<<ADPS2)|(0<<ADPS1)|(1<<ADPS0))
+#define ADC_PRESCALER_64   ((1<<ADPS2)|(1<<ADPS1)|(0<<ADPS0))
+#define ADC_PRESCALER_128  ((1<<ADPS2)|(1<<ADPS1)|(1<<ADPS0))
+
+/* how ADC_u16Read waits for a conversion */
+#define ADC_READ_POLLING			0u	/* spin on ADIF										*/
+#define ADC_READ_NOISE_REDUCTION	1u	/* sleep in SLEEP_MODE_ADC, woken by the ADC interrupt	*/
 
 #define ADC_VREF_TYPE	ADC_VREF_AVCC
 #define ADLAR_ADJUST	RIGHT_ADJUSTED
 #define ADC_INT_MODE	ADC_INTERRUPT_DISABLED
 #define ADC_PRESCALER	ADC_PRESCALER_8
+/* ADC_READ_NOISE_REDUCTION halts the I/O clock during every conversion (see ADC_u16Read), opt in only when
+   the UART reception and the Timer 0 phase can live with it */
+#ifndef ADC_READ_MODE
+#define ADC_READ_MODE	ADC_READ_POLLING
+#endif
+
+/* MUX3:0 channel field of ADMUX, channels 0-7 plus 14 (1.30V band gap) and 15 (GND) */
+#define ADC_u8MUX_MASK			0x0FU
+
+/* oversampling: n extra bits per channel from 4^n samples accumulated then shifted right by n */
+#define ADC_u8NO_OF_CH			8U		/* channels 0-7 can be oversampled, 14/15 are always 10 bits	*/
+#define ADC_u8OS_10_BIT			0U		/* 1 sample								*/
+#define ADC_u8OS_11_BIT			1U		/* 4 samples							*/
+#define ADC_u8OS_12_BIT			2U		/* 16 samples							*/
+#define ADC_u8OS_13_BIT			3U		/* 64 samples (64 * 1023 fits 16 bits)	*/
+
+/* returned by ADC_u16Read when the scan engine owns the ADC */
+#define ADC_u16INVALID_READ		0xFFFFU
+
+/* scan engine: max channels in a sweep (6 analog inputs on the PDIP ATmega8) */
+#define ADC_u8SCAN_MAX_CH		6U
+#define ADC_SCAN_SINGLE			0U		/* one sweep per ADC_eScanStart				*/
+#define ADC_SCAN_CONTINUOUS		1U		/* sweeps back to back until ADC_vidScanStop	*/
+
+/*------------------------------------------------- Type Definitions ----------------------------------------*/
+
+/* end of sweep notification (ADC ISR context), pu16Results[i] is the reading of the i-th channel of the list,
+   valid until the end of the next sweep */
+typedef void (*ADC_tpfvidScanClbk)(const uint16 *pu16Results);
+
+/* end of an asynchronous conversion (ADC ISR context) */
+typedef void (*ADC_tpfvidConvClbk)(uint16 u16Result);
 
 
 
@@ -80,14 +116,90 @@ extern void ADC_vidInit(void);
 /*************************************************************************************************************
 * Function				: ADC_u16Read
 * Description			: Start Single conversion and return the ADC reading for selected channel.
+						  With ADC_READ_NOISE_REDUCTION the CPU sleeps during each conversion and the I/O clock
+						  is halted for about 104 us per sample: the pending UART output is flushed before every
+						  sleep (a frame cut by the halt would be corrupted), the halted time is credited to the
+						  milli seconds count of Timer 0 (its tick phase shifts) and a frame being received
+						  during the halt is lost. From an ISR or a nested critical section it polls instead.
 * Parameters[in]		: [u8ChannelNum] selected channel to get reading for
-						  Range (0-5)
+						  Range (0-7, 14, 15)
 * Parameters[in/out]	: None
 * Parameters[out]		: [uint16] ADC reading.
-						  Range : (0 - 1023)
+						  Range : (0 - 1023), up to (0 - 8191) for an oversampled channel
+						  ADC_u16INVALID_READ while the ADC is busy (scan, ADC_eStartConversion, another read)
 *
 **************************************************************************************************************/
 extern uint16 ADC_u16Read(uint8 u8ChannelNum);
 
+/*************************************************************************************************************
+* Function				: ADC_eSetOversampling
+* Description			: Set the resolution of a channel for ADC_u16Read and the scan engine. The 4^n samples
+						  are summed then decimated by a right shift of n bits, a conversion takes 4^n times
+						  longer (64 * 104 us at 125 kHz ADC clock for 13 bits). Oversampling only adds
+						  resolution if the input carries about 1 LSB of noise.
+* Parameters[in]		: [u8ChannelNum] Range (0-7)
+						  [u8ExtraBits] Range (ADC_u8OS_10_BIT, ADC_u8OS_11_BIT, ADC_u8OS_12_BIT, ADC_u8OS_13_BIT)
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on invalid parameters
+*
+**************************************************************************************************************/
+extern STD_ERR_T ADC_eSetOversampling(uint8 u8ChannelNum, uint8 u8ExtraBits);
+
+/*************************************************************************************************************
+* Function				: ADC_eStartConversion
+* Description			: Start a conversion (with the channel oversampling) and return at once, the result is
+						  given to pfvClbk from the ADC ISR. Safe to call from an ISR (e.g. a timer trigger).
+* Parameters[in]		: [u8ChannelNum] Range (0-7, 14, 15)
+						  [pfvClbk] end of conversion call back, must not be NULL
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the ADC is busy
+*
+**************************************************************************************************************/
+extern STD_ERR_T ADC_eStartConversion(uint8 u8ChannelNum, ADC_tpfvidConvClbk pfvClbk);
+
+/*************************************************************************************************************
+* Function				: ADC_eScanInit
+* Description			: Set the channel list converted by the scan engine (stops a running scan).
+* Parameters[in]		: [pu8Channels] channels in conversion order, Range (0-7, 14, 15)
+						  [u8NoOfChannels] Range (1 - ADC_u8SCAN_MAX_CH)
+						  [pfvClbk] called from the ADC ISR at the end of every sweep, may be NULL
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on invalid parameters
+*
+**************************************************************************************************************/
+extern STD_ERR_T ADC_eScanInit(const uint8 *pu8Channels, uint8 u8NoOfChannels, ADC_tpfvidScanClbk pfvClbk);
+
+/*************************************************************************************************************
+* Function				: ADC_eScanStart
+* Description			: Start converting the channel list back to back from the ADC ISR, the CPU never waits.
+						  Each sweep is written to the back buffer of a double buffer that is swapped when
+						  the sweep completes.
+* Parameters[in]		: [u8Mode] Range (ADC_SCAN_SINGLE, ADC_SCAN_CONTINUOUS)
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if a conversion is already running or no channel list is set
+*
+**************************************************************************************************************/
+extern STD_ERR_T ADC_eScanStart(uint8 u8Mode);
+
+/*************************************************************************************************************
+* Function				: ADC_vidScanStop
+* Description			: Stop a continuous scan, the sweep in progress is dropped.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void ADC_vidScanStop(void);
+
+/*************************************************************************************************************
+* Function				: ADC_eScanRead
+* Description			: Copy the last completed sweep.
+* Parameters[in]		: None
+* Parameters[in/out]	: [pu16Results] receives one reading per channel of the list
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if no new sweep completed since the last read
+*
+**************************************************************************************************************/
+extern STD_ERR_T ADC_eScanRead(uint16 *pu16Results);
+
 
 #endif /* ADC_H_ */
\ No newline at end of file
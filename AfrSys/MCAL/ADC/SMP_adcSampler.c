@@ -0,0 +1,351 @@
+/*! \file SMP_adcSampler.c \brief Fixed rate ADC sampling pipeline with a filter stage. */
+/************************************************************************************************************
+*
+* File Name		: 'SMP_adcSampler.c'
+* Title			: Fixed rate ADC sampling pipeline with a filter stage
+* Version		: 1.0
+* Target MCU	: Atmel AVR Series
+*
+************************************************************************************************************/
+
+
+/*------------------------------------------------- INCLUDES ----------------------------------------------*/
+#include "Common_Macros.h"
+#include "TIM_timers.h"
+
+#include "SMP_adcSampler.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+#define SMP_u8RING_MASK			(uint8)(SMP_u8RING_SIZE - 1U)
+
+#if (SMP_u8RING_SIZE & (SMP_u8RING_SIZE - 1U)) || (SMP_u8RING_SIZE > 128U)
+#error "SMP_u8RING_SIZE must be a power of 2 <= 128"
+#endif
+
+/* number of Timer 2 prescaler IDs (TIM2_NO_PRESCALER .. TIM2_1024_PRESCALER) */
+#define SMP_u8NO_OF_PRESCALERS	7U
+
+/*---------------------------------------------- Global Variables -----------------------------------------*/
+
+/* Timer 2 division factor of each prescaler ID, index = ID - 1 */
+static const uint16 au16SmpPrescaler[SMP_u8NO_OF_PRESCALERS] = {1U, 8U, 32U, 64U, 128U, 256U, 1024U};
+
+static uint8 u8SmpChannel;
+static uint8 u8SmpPrescalerId = TIM2_STOP;
+static uint8 u8SmpTop;
+static uint16 (*pfSmpFilter)(uint16 u16Sample) = NULL;
+
+/* output ring: written by the ADC ISR, read by the application */
+static uint16 au16SmpRing[SMP_u8RING_SIZE];
+static volatile uint8 u8SmpHead;
+static volatile uint8 u8SmpTail;
+
+static volatile uint16 u16SmpOverruns;
+static volatile uint16 u16SmpFilterCycles;
+
+/* filter kernels state */
+static uint16 au16SmpMaHist[SMP_u8MA_LEN];
+static uint16 u16SmpMaSum;
+static uint8 u8SmpMaIndex;
+static uint16 u16SmpIirQ5;
+static uint16 u16SmpMedPrev1;
+static uint16 u16SmpMedPrev2;
+
+/*-------------------------------------------- FUNCTION Definitions ---------------------------------------*/
+
+static void SMP_vidCountOverrun(void)
+{
+	if (u16SmpOverruns != 0xFFFFU){
+		u16SmpOverruns++;
+	}
+}
+
+/* ADC ISR context: filter the sample and queue it */
+static void SMP_vidOnSample(uint16 u16Sample)
+{
+	uint8 u8Start;
+	uint8 u8End;
+	uint16 u16Cycles;
+
+	if (pfSmpFilter != NULL){
+		u8Start = TCNT2;
+		u16Sample = pfSmpFilter(u16Sample);
+		u8End = TCNT2;
+		/* Timer 2 restarts from 0 after OCR2 */
+		if (u8End < u8Start){
+			u8End += (uint8)(u8SmpTop + 1U);
+		}
+		u16Cycles = (uint16)(uint8)(u8End - u8Start) * au16SmpPrescaler[u8SmpPrescalerId - 1U];
+		if (u16Cycles > u16SmpFilterCycles){
+			u16SmpFilterCycles = u16Cycles;
+		}
+	}
+
+	if ((uint8)(u8SmpHead - u8SmpTail) < SMP_u8RING_SIZE){
+		au16SmpRing[u8SmpHead & SMP_u8RING_MASK] = u16Sample;
+		u8SmpHead++;
+	} else {
+		SMP_vidCountOverrun();
+	}
+}
+
+/* Timer 2 compare ISR context: start the conversion of this period */
+static void SMP_vidTrigger(void)
+{
+	if (ADC_eStartConversion(u8SmpChannel, SMP_vidOnSample) != STD_ERR_OK){
+		SMP_vidCountOverrun();
+	}
+}
+
+/*************************************************************************************************************
+* Function				: SMP_eInit
+* Description			: Configure the pipeline, ADC_vidInit must have been called. The sample rate is exact
+						  when F_CPU / rate is a multiple of a Timer 2 prescaler (1 kHz @ 1 MHz: /8, OCR2 = 124).
+* Parameters[in]		: [u8ChannelNum] sampled channel, Range (0-7), its oversampling setting applies
+						  [u16RateHz] samples per second, Range (4 - SMP_u16MAX_RATE_HZ)
+						  [u8Filter] Range (SMP_FILTER_NONE, SMP_FILTER_MOV_AVG, SMP_FILTER_IIR, SMP_FILTER_MEDIAN3)
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on invalid parameters or if Timer 2 runs the RTC (AS2)
+*
+**************************************************************************************************************/
+extern STD_ERR_T SMP_eInit(uint8 u8ChannelNum, uint16 u16RateHz, uint8 u8Filter)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint32 u32Ticks;
+	uint8 u8Index;
+
+	if ((u8ChannelNum < ADC_u8NO_OF_CH) && (u16RateHz != 0U) && (u16RateHz <= SMP_u16MAX_RATE_HZ) &&
+		(u8Filter <= SMP_FILTER_MEDIAN3) && ((ASSR & (1<<AS2)) == 0U)){
+		SMP_vidStop();
+		/* smallest prescaler giving a period that fits the 8-bit compare register, done once here */
+		for (u8Index = 0U; u8Index < SMP_u8NO_OF_PRESCALERS; u8Index++){
+			u32Ticks = (F_CPU / au16SmpPrescaler[u8Index]) / u16RateHz;
+			if ((u32Ticks != 0UL) && (u32Ticks <= 256UL)){
+				u8SmpTop = (uint8)(u32Ticks - 1UL);
+				u8SmpPrescalerId = u8Index + 1U;
+				errRetVal = STD_ERR_OK;
+				break;
+			}
+		}
+		if (errRetVal == STD_ERR_OK){
+			u8SmpChannel = u8ChannelNum;
+			switch (u8Filter){
+				case SMP_FILTER_MOV_AVG:
+					pfSmpFilter = SMP_u16FilterMovAvg;
+					break;
+				case SMP_FILTER_IIR:
+					pfSmpFilter = SMP_u16FilterIir;
+					break;
+				case SMP_FILTER_MEDIAN3:
+					pfSmpFilter = SMP_u16FilterMedian3;
+					break;
+				default:
+					pfSmpFilter = NULL;
+					break;
+			}
+		}
+	}
+	return errRetVal;
+}
+
+/*************************************************************************************************************
+* Function				: SMP_vidStart
+* Description			: Clear the filter state and the ring and start the trigger timer, does nothing while
+						  Timer 2 runs the RTC.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void SMP_vidStart(void)
+{
+	uint8 u8Sreg;
+
+	/* Timer 2 may have been given to the RTC since SMP_eInit */
+	if ((u8SmpPrescalerId != TIM2_STOP) && ((ASSR & (1<<AS2)) == 0U)){
+		u8Sreg = SREG;
+		cli();
+		SMP_vidFilterReset();
+		u8SmpHead = 0U;
+		u8SmpTail = 0U;
+		u16SmpOverruns = 0U;
+		u16SmpFilterCycles = 0U;
+		TIM_vidT2AttachCompInterrupt(SMP_vidTrigger);
+		TIM_vidInitT2Ctc(u8SmpPrescalerId, u8SmpTop);
+		SREG = u8Sreg;
+	}
+}
+
+/*************************************************************************************************************
+* Function				: SMP_vidStop
+* Description			: Stop the trigger timer, a conversion in progress still lands in the ring.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void SMP_vidStop(void)
+{
+	TIM_vidT2Stop();
+	TIM_vidT2AttachCompInterrupt(NULL);
+}
+
+/*************************************************************************************************************
+* Function				: SMP_u8Read
+* Description			: Pop filtered samples from the ring, oldest first.
+* Parameters[in]		: [u8MaxSamples] size of pu16Samples
+* Parameters[in/out]	: [pu16Samples] receives the samples
+* Parameters[out]		: uint8 number of samples copied
+*
+**************************************************************************************************************/
+extern uint8 SMP_u8Read(uint16 *pu16Samples, uint8 u8MaxSamples)
+{
+	uint8 u8Count = 0U;
+	uint8 u8Tail = u8SmpTail;
+
+	/* single consumer: only the head is shared with the ISR, one byte read */
+	while ((u8Count < u8MaxSamples) && (u8Tail != u8SmpHead)){
+		pu16Samples[u8Count] = au16SmpRing[u8Tail & SMP_u8RING_MASK];
+		u8Tail++;
+		u8Count++;
+	}
+	u8SmpTail = u8Tail;
+	return u8Count;
+}
+
+/*************************************************************************************************************
+* Function				: SMP_u16GetOverruns
+* Description			: Samples lost since SMP_vidStart, the ADC was busy at the trigger or the ring was full.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 lost samples (saturates)
+*
+**************************************************************************************************************/
+extern uint16 SMP_u16GetOverruns(void)
+{
+	uint16 u16RetVal;
+	uint8 u8Sreg = SREG;
+
+	cli();
+	u16RetVal = u16SmpOverruns;
+	SREG = u8Sreg;
+	return u16RetVal;
+}
+
+/*************************************************************************************************************
+* Function				: SMP_u16GetFilterCycles
+* Description			: Longest filter stage run since SMP_vidStart in CPU cycles per sample, measured with
+						  Timer 2 (resolution = the Timer 2 prescaler).
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 cycles
+*
+**************************************************************************************************************/
+extern uint16 SMP_u16GetFilterCycles(void)
+{
+	uint16 u16RetVal;
+	uint8 u8Sreg = SREG;
+
+	cli();
+	u16RetVal = u16SmpFilterCycles;
+	SREG = u8Sreg;
+	return u16RetVal;
+}
+
+/*************************************************************************************************************
+* Function				: SMP_vidFilterReset
+* Description			: Clear the state of all the filter kernels.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void SMP_vidFilterReset(void)
+{
+	uint8 u8Index;
+
+	for (u8Index = 0U; u8Index < SMP_u8MA_LEN; u8Index++){
+		au16SmpMaHist[u8Index] = 0U;
+	}
+	u16SmpMaSum = 0U;
+	u8SmpMaIndex = 0U;
+	u16SmpIirQ5 = 0U;
+	u16SmpMedPrev1 = 0U;
+	u16SmpMedPrev2 = 0U;
+}
+
+/*************************************************************************************************************
+* Function				: SMP_u16FilterMovAvg
+* Description			: Moving average of the last SMP_u8MA_LEN samples: the running sum is updated with the
+						  new sample and the oldest one, the mean is a shift. Ramps up from 0 on the first
+						  SMP_u8MA_LEN samples after a reset.
+* Parameters[in]		: [u16Sample] new input sample (up to 13 bits)
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 filter output
+*
+**************************************************************************************************************/
+extern uint16 SMP_u16FilterMovAvg(uint16 u16Sample)
+{
+	u16SmpMaSum -= au16SmpMaHist[u8SmpMaIndex];
+	u16SmpMaSum += u16Sample;
+	au16SmpMaHist[u8SmpMaIndex] = u16Sample;
+	u8SmpMaIndex = (u8SmpMaIndex + 1U) & (SMP_u8MA_LEN - 1U);
+	return u16SmpMaSum >> SMP_u8MA_LOG2;
+}
+
+/*************************************************************************************************************
+* Function				: SMP_u16FilterIir
+* Description			: First order low pass y += (x - y) >> SMP_u8IIR_SHIFT. The state keeps 5 fraction bits
+						  (Q5, 1023 << 5 fits a sint16) so small steps are not lost to the shift.
+* Parameters[in]		: [u16Sample] new input sample (up to 10 bits, oversampled channels saturate the Q5 state)
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 filter output, rounded
+*
+**************************************************************************************************************/
+extern uint16 SMP_u16FilterIir(uint16 u16Sample)
+{
+	sint16 s16Diff;
+
+	if (u16Sample > 1023U){
+		u16Sample = 1023U;
+	}
+	s16Diff = (sint16)(u16Sample << 5) - (sint16)u16SmpIirQ5;
+	/* arithmetic shift of the signed difference */
+	u16SmpIirQ5 = (uint16)((sint16)u16SmpIirQ5 + (s16Diff >> SMP_u8IIR_SHIFT));
+	return (u16SmpIirQ5 + (1U << 4)) >> 5;
+}
+
+/*************************************************************************************************************
+* Function				: SMP_u16FilterMedian3
+* Description			: Median of the new sample and the two previous ones, removes single sample spikes.
+* Parameters[in]		: [u16Sample] new input sample
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 filter output
+*
+**************************************************************************************************************/
+extern uint16 SMP_u16FilterMedian3(uint16 u16Sample)
+{
+	uint16 u16A = u16SmpMedPrev2;
+	uint16 u16B = u16SmpMedPrev1;
+	uint16 u16Med;
+
+	u16SmpMedPrev2 = u16B;
+	u16SmpMedPrev1 = u16Sample;
+
+	/* at most three compares */
+	if (u16A > u16B){
+		u16Med = u16A;
+		u16A = u16B;
+		u16B = u16Med;
+	}
+	/* u16A <= u16B */
+	if (u16Sample <= u16A){
+		u16Med = u16A;
+	} else if (u16Sample >= u16B){
+		u16Med = u16B;
+	} else {
+		u16Med = u16Sample;
+	}
+	return u16Med;
+}
@@ -0,0 +1,139 @@
+/*! \file SMP_adcSampler.h \brief Fixed rate ADC sampling pipeline with a filter stage. */
+/*************************************************************************************************************
+*
+* File Name		: 'SMP_adcSampler.h'
+* Title			: Fixed rate ADC sampling pipeline with a filter stage
+* Version		: 1.0
+* Target MCU	: Atmel AVR Series
+*
+*  Timer 2 (CTC, TOP = OCR2) triggers one conversion of the sampled channel per period, the ADC ISR runs the
+*  sample through the selected fixed point filter and pushes the output in a ring read by the application:
+*
+*	TIMER2_COMP --> ADC_eStartConversion --> ADC_vect --> filter --> ring --> SMP_u8Read
+*
+*  Timer 1 is left to the PWM outputs.
+*
+*************************************************************************************************************/
+#ifndef SMP_ADCSAMPLER_H_
+#define SMP_ADCSAMPLER_H_
+
+
+/*---------------------------------------------------- INCLUDES --------------------------------------------*/
+
+#include "MCU.h"
+#include "Std_Types.h"
+#include "ADC.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+/* filter stage */
+#define SMP_FILTER_NONE			0U
+#define SMP_FILTER_MOV_AVG		1U		/* mean of the last SMP_u8MA_LEN samples, running sum			*/
+#define SMP_FILTER_IIR			2U		/* y += (x - y) / 2^SMP_u8IIR_SHIFT, state in Q5 fixed point	*/
+#define SMP_FILTER_MEDIAN3		3U		/* median of the last 3 samples (spike rejection)				*/
+
+/* moving average length, power of 2 so the mean is a shift (8 * 8191 fits 16 bits) */
+#define SMP_u8MA_LOG2			3U
+#define SMP_u8MA_LEN			(1U << SMP_u8MA_LOG2)
+
+/* IIR coefficient alpha = 1 / 2^SMP_u8IIR_SHIFT */
+#define SMP_u8IIR_SHIFT			3U
+
+/* output ring, power of 2 <= 128 */
+#define SMP_u8RING_SIZE			32U
+
+/* a conversion takes 13 ADC clocks (104 us at 125 kHz) */
+#define SMP_u16MAX_RATE_HZ		5000U
+
+/*--------------------------------------------- FUNCTION Definitions ----------------------------------------*/
+
+/*************************************************************************************************************
+* Function				: SMP_eInit
+* Description			: Configure the pipeline, ADC_vidInit must have been called. The sample rate is exact
+						  when F_CPU / rate is a multiple of a Timer 2 prescaler (1 kHz @ 1 MHz: /8, OCR2 = 124).
+* Parameters[in]		: [u8ChannelNum] sampled channel, Range (0-7), its oversampling setting applies
+						  [u16RateHz] samples per second, Range (4 - SMP_u16MAX_RATE_HZ)
+						  [u8Filter] Range (SMP_FILTER_NONE, SMP_FILTER_MOV_AVG, SMP_FILTER_IIR, SMP_FILTER_MEDIAN3)
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on invalid parameters or if Timer 2 runs the RTC (AS2)
+*
+**************************************************************************************************************/
+extern STD_ERR_T SMP_eInit(uint8 u8ChannelNum, uint16 u16RateHz, uint8 u8Filter);
+
+/*************************************************************************************************************
+* Function				: SMP_vidStart
+* Description			: Clear the filter state and the ring and start the trigger timer, does nothing while
+						  Timer 2 runs the RTC.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void SMP_vidStart(void);
+
+/*************************************************************************************************************
+* Function				: SMP_vidStop
+* Description			: Stop the trigger timer, a conversion in progress still lands in the ring.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void SMP_vidStop(void);
+
+/*************************************************************************************************************
+* Function				: SMP_u8Read
+* Description			: Pop filtered samples from the ring, oldest first.
+* Parameters[in]		: [u8MaxSamples] size of pu16Samples
+* Parameters[in/out]	: [pu16Samples] receives the samples
+* Parameters[out]		: uint8 number of samples copied
+*
+**************************************************************************************************************/
+extern uint8 SMP_u8Read(uint16 *pu16Samples, uint8 u8MaxSamples);
+
+/*************************************************************************************************************
+* Function				: SMP_u16GetOverruns
+* Description			: Samples lost since SMP_vidStart, the ADC was busy at the trigger or the ring was full.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 lost samples (saturates)
+*
+**************************************************************************************************************/
+extern uint16 SMP_u16GetOverruns(void);
+
+/*************************************************************************************************************
+* Function				: SMP_u16GetFilterCycles
+* Description			: Longest filter stage run since SMP_vidStart in CPU cycles per sample, measured with
+						  Timer 2 (resolution = the Timer 2 prescaler).
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 cycles
+*
+**************************************************************************************************************/
+extern uint16 SMP_u16GetFilterCycles(void);
+
+/*************************************************************************************************************
+* Function				: SMP_vidFilterReset
+* Description			: Clear the state of all the filter kernels.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void SMP_vidFilterReset(void);
+
+/*************************************************************************************************************
+* Function				: SMP_u16FilterMovAvg / SMP_u16FilterIir / SMP_u16FilterMedian3
+* Description			: Filter kernels, one call per sample. Integer only: adds, subtracts and shifts, no
+						  multiplication or division. Public so they can be benchmarked on their own.
+* Parameters[in]		: [u16Sample] new input sample (up to 13 bits)
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 filter output, same scale as the input
+*
+**************************************************************************************************************/
+extern uint16 SMP_u16FilterMovAvg(uint16 u16Sample);
+extern uint16 SMP_u16FilterIir(uint16 u16Sample);
+extern uint16 SMP_u16FilterMedian3(uint16 u16Sample);
+
+
+#endif /* SMP_ADCSAMPLER_H_ */
@@ -21,8 +21,85 @@
 
 /*----------------------------------------- MACROS Definitions --------------------------------------------*/
 
+/* marks a port whose group pins need no shift */
+#define DIO_s8NO_SHIFT		((sint8)0x7F)
+
 /*------------------------------------------ Global Variables ---------------------------------------------*/
 
+static volatile uint8 * const apu8DioPortReg[DIO_u8NO_OF_PORTS] = {&PORTB, &PORTC, &PORTD};
+static volatile uint8 * const apu8DioDdrReg[DIO_u8NO_OF_PORTS]  = {&DDRB, &DDRC, &DDRD};
+static volatile uint8 * const apu8DioPinReg[DIO_u8NO_OF_PORTS]  = {&PINB, &PINC, &PIND};
+
+/*------------------------------------------ Local Functions ----------------------------------------------*/
+
+/* split a pin ID into its port ID and bit, STD_ERR_NOK if the pin does not exist */
+static STD_ERR_T DIO_eSplitPin(uint8 u8Pin, uint8 *pu8Port, uint8 *pu8Bit)
+{
+	STD_ERR_T errRetVal = STD_ERR_OK;
+
+	if (u8Pin <= DIO_PB7){
+		*pu8Port = DIO_PORTB;
+		*pu8Bit = u8Pin;
+	} else if (u8Pin <= DIO_PC6){
+		*pu8Port = DIO_PORTC;
+		*pu8Bit = u8Pin - DIO_PC0;
+	} else if (u8Pin <= DIO_PD7){
+		*pu8Port = DIO_PORTD;
+		*pu8Bit = u8Pin - DIO_PD0;
+	} else {
+		errRetVal = STD_ERR_NOK;
+	}
+	return errRetVal;
+}
+
+/* move the value bits to their port positions: a shift, or one bit at a time for a scattered port using the
+   port and mask of each pin resolved by DIO_eGroupInit */
+static uint8 DIO_u8GroupToPort(const DIO_tstrPinGroup *pstrGroup, uint8 u8Port, uint8 u8Value)
+{
+	uint8 u8PortVal = 0U;
+	uint8 u8Index;
+	sint8 s8Shift = pstrGroup->as8Shift[u8Port];
+
+	if ((pstrGroup->u8ScatterPorts & (1U << u8Port)) == 0U){
+		if (s8Shift >= 0){
+			u8PortVal = (uint8)(u8Value << s8Shift);
+		} else {
+			u8PortVal = (uint8)(u8Value >> (-s8Shift));
+		}
+	} else {
+		for (u8Index = 0U; u8Index < pstrGroup->u8NoOfPins; u8Index++){
+			if ((pstrGroup->au8PinPort[u8Index] == u8Port) && ((u8Value & (1U << u8Index)) != 0U)){
+				u8PortVal |= pstrGroup->au8PinMask[u8Index];
+			}
+		}
+	}
+	return u8PortVal & pstrGroup->au8PortMask[u8Port];
+}
+
+/* inverse of DIO_u8GroupToPort */
+static uint8 DIO_u8PortToGroup(const DIO_tstrPinGroup *pstrGroup, uint8 u8Port, uint8 u8PortVal)
+{
+	uint8 u8Value = 0U;
+	uint8 u8Index;
+	sint8 s8Shift = pstrGroup->as8Shift[u8Port];
+
+	u8PortVal &= pstrGroup->au8PortMask[u8Port];
+	if ((pstrGroup->u8ScatterPorts & (1U << u8Port)) == 0U){
+		if (s8Shift >= 0){
+			u8Value = (uint8)(u8PortVal >> s8Shift);
+		} else {
+			u8Value = (uint8)(u8PortVal << (-s8Shift));
+		}
+	} else {
+		for (u8Index = 0U; u8Index < pstrGroup->u8NoOfPins; u8Index++){
+			if ((pstrGroup->au8PinPort[u8Index] == u8Port) && ((u8PortVal & pstrGroup->au8PinMask[u8Index]) != 0U)){
+				u8Value |= (uint8)(1U << u8Index);
+			}
+		}
+	}
+	return u8Value;
+}
+
 /*---------------------------------------- FUNCTION Definitions -------------------------------------------*/
 
 /************************************************************************************************************
@@ -112,6 +189,199 @@ extern uint8 DIO_u8DigitalRead (uint8 u8Pin){
 }
 
 
+/************************************************************************************************************
+* Function				: DIO_vidPortWriteMasked
+* Description			: Write the bits of u8Value selected by u8Mask to a port in one atomic read-modify-write,
+						  the other pins of the port are not changed.
+* Parameters[in]		: [u8Port] Range : (DIO_PORTB, DIO_PORTC, DIO_PORTD)
+						  [u8Mask] pins to update
+						  [u8Value] new pins values
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void DIO_vidPortWriteMasked(uint8 u8Port, uint8 u8Mask, uint8 u8Value)
+{
+	volatile uint8 *pu8Reg;
+	uint8 u8Sreg;
+
+	if (u8Port < DIO_u8NO_OF_PORTS){
+		pu8Reg = apu8DioPortReg[u8Port];
+		u8Value &= u8Mask;
+		/* an ISR may own other pins of the same port */
+		u8Sreg = SREG;
+		cli();
+		*pu8Reg = (uint8)((*pu8Reg & (uint8)~u8Mask) | u8Value);
+		SREG = u8Sreg;
+	}
+}
+
+/************************************************************************************************************
+* Function				: DIO_u8PortRead
+* Description			: Read the input levels of all the pins of a port (PINx).
+* Parameters[in]		: [u8Port] Range : (DIO_PORTB, DIO_PORTC, DIO_PORTD)
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 PINx value, 0 for an invalid port
+*
+*************************************************************************************************************/
+extern uint8 DIO_u8PortRead(uint8 u8Port)
+{
+	uint8 u8RetVal = 0U;
+
+	if (u8Port < DIO_u8NO_OF_PORTS){
+		u8RetVal = *apu8DioPinReg[u8Port];
+	}
+	return u8RetVal;
+}
+
+/************************************************************************************************************
+* Function				: DIO_vidPortSetMode
+* Description			: Set the mode of all the pins of a port selected by u8Mask at once.
+* Parameters[in]		: [u8Port] Range : (DIO_PORTB, DIO_PORTC, DIO_PORTD)
+						  [u8Mask] pins to configure
+						  [u8Mode] Range : (INPUT, OUTPUT, or INPUT_PULLUP)
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void DIO_vidPortSetMode(uint8 u8Port, uint8 u8Mask, uint8 u8Mode)
+{
+	volatile uint8 *pu8Ddr;
+	uint8 u8Sreg;
+
+	if ((u8Port < DIO_u8NO_OF_PORTS) && ((u8Mode == INPUT) || (u8Mode == OUTPUT) || (u8Mode == INPUT_PULLUP))){
+		pu8Ddr = apu8DioDdrReg[u8Port];
+		u8Sreg = SREG;
+		cli();
+		if (u8Mode == OUTPUT){
+			*pu8Ddr |= u8Mask;
+		} else {
+			*pu8Ddr &= (uint8)~u8Mask;
+		}
+		SREG = u8Sreg;
+		if (u8Mode != OUTPUT){
+			/* pull-ups are enabled through PORTx for the inputs */
+			DIO_vidPortWriteMasked(u8Port, u8Mask, (u8Mode == INPUT_PULLUP) ? 0xFFU : 0x00U);
+		}
+	}
+}
+
+/************************************************************************************************************
+* Function				: DIO_eGroupInit
+* Description			: Build a pin group from a list of pins, the list is split into per port masks here once
+						  so writing/reading the group costs one masked access per port.
+* Parameters[in]		: [pu8Pins] pins, the first one is bit 0 of the group value
+						  Range : see PIN MAP macros defined on top of "DIO.h" file
+						  [u8NoOfPins] Range : (1 .. DIO_u8GROUP_MAX_PINS)
+* Parameters[in/out]	: [pstrGroup] group descriptor to fill
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on an invalid or duplicated pin
+*
+*************************************************************************************************************/
+extern STD_ERR_T DIO_eGroupInit(DIO_tstrPinGroup *pstrGroup, const uint8 *pu8Pins, uint8 u8NoOfPins)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint8 u8Index;
+	uint8 u8Port;
+	uint8 u8Bit;
+	sint8 s8Shift;
+
+	if ((pstrGroup != NULL) && (pu8Pins != NULL) && (u8NoOfPins != 0U) && (u8NoOfPins <= DIO_u8GROUP_MAX_PINS)){
+		errRetVal = STD_ERR_OK;
+		pstrGroup->u8NoOfPins = u8NoOfPins;
+		pstrGroup->u8ScatterPorts = 0U;
+		for (u8Port = 0U; u8Port < DIO_u8NO_OF_PORTS; u8Port++){
+			pstrGroup->au8PortMask[u8Port] = 0U;
+			pstrGroup->as8Shift[u8Port] = DIO_s8NO_SHIFT;
+		}
+		for (u8Index = 0U; (u8Index < u8NoOfPins) && (errRetVal == STD_ERR_OK); u8Index++){
+			if ((DIO_eSplitPin(pu8Pins[u8Index], &u8Port, &u8Bit) != STD_ERR_OK) ||
+				((pstrGroup->au8PortMask[u8Port] & (1U << u8Bit)) != 0U)){
+				errRetVal = STD_ERR_NOK;
+			} else {
+				pstrGroup->au8PinPort[u8Index] = u8Port;
+				pstrGroup->au8PinMask[u8Index] = (uint8)(1U << u8Bit);
+				pstrGroup->au8PortMask[u8Port] |= (uint8)(1U << u8Bit);
+				s8Shift = (sint8)u8Bit - (sint8)u8Index;
+				if (pstrGroup->as8Shift[u8Port] == DIO_s8NO_SHIFT){
+					pstrGroup->as8Shift[u8Port] = s8Shift;
+				} else if (pstrGroup->as8Shift[u8Port] != s8Shift){
+					pstrGroup->u8ScatterPorts |= (uint8)(1U << u8Port);
+				}
+			}
+		}
+		if (errRetVal != STD_ERR_OK){
+			/* leave an empty group behind, writes then do nothing */
+			for (u8Port = 0U; u8Port < DIO_u8NO_OF_PORTS; u8Port++){
+				pstrGroup->au8PortMask[u8Port] = 0U;
+			}
+			pstrGroup->u8NoOfPins = 0U;
+		}
+	}
+	return errRetVal;
+}
+
+/************************************************************************************************************
+* Function				: DIO_vidGroupSetMode
+* Description			: Set the mode of all the pins of a group.
+* Parameters[in]		: [pstrGroup] group built by DIO_eGroupInit
+						  [u8Mode] Range : (INPUT, OUTPUT, or INPUT_PULLUP)
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void DIO_vidGroupSetMode(const DIO_tstrPinGroup *pstrGroup, uint8 u8Mode)
+{
+	uint8 u8Port;
+
+	for (u8Port = 0U; u8Port < DIO_u8NO_OF_PORTS; u8Port++){
+		if (pstrGroup->au8PortMask[u8Port] != 0U){
+			DIO_vidPortSetMode(u8Port, pstrGroup->au8PortMask[u8Port], u8Mode);
+		}
+	}
+}
+
+/************************************************************************************************************
+* Function				: DIO_vidGroupWrite
+* Description			: Write a value to a group, each port is updated atomically (ports one after the other).
+* Parameters[in]		: [pstrGroup] group built by DIO_eGroupInit
+						  [u8Value] bit n drives the n-th pin of the group
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void DIO_vidGroupWrite(const DIO_tstrPinGroup *pstrGroup, uint8 u8Value)
+{
+	uint8 u8Port;
+
+	for (u8Port = 0U; u8Port < DIO_u8NO_OF_PORTS; u8Port++){
+		if (pstrGroup->au8PortMask[u8Port] != 0U){
+			DIO_vidPortWriteMasked(u8Port, pstrGroup->au8PortMask[u8Port],
+								   DIO_u8GroupToPort(pstrGroup, u8Port, u8Value));
+		}
+	}
+}
+
+/************************************************************************************************************
+* Function				: DIO_u8GroupRead
+* Description			: Read the input levels of a group.
+* Parameters[in]		: [pstrGroup] group built by DIO_eGroupInit
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 bit n is the level of the n-th pin of the group
+*
+*************************************************************************************************************/
+extern uint8 DIO_u8GroupRead(const DIO_tstrPinGroup *pstrGroup)
+{
+	uint8 u8Value = 0U;
+	uint8 u8Port;
+
+	for (u8Port = 0U; u8Port < DIO_u8NO_OF_PORTS; u8Port++){
+		if (pstrGroup->au8PortMask[u8Port] != 0U){
+			u8Value |= DIO_u8PortToGroup(pstrGroup, u8Port, *apu8DioPinReg[u8Port]);
+		}
+	}
+	return u8Value;
+}
+
 #if 0
 extern uint32	DIO_u32AnalogRead		(uint8 u8Pin){
 	
@@ -124,4 +394,3 @@ extern void		DIO_vidAnalogPinWrite	(uint8 u8Pin, uint8 u8Value){
 	
 }
 #endif
-
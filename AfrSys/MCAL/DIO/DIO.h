@@ -60,6 +60,38 @@
 #define DIO_PD7	22U
 /***********************************************************************************************************/
 
+/* port IDs for the port level (masked multi-pin) API */
+#define DIO_PORTB	0U
+#define DIO_PORTC	1U
+#define DIO_PORTD	2U
+#define DIO_u8NO_OF_PORTS	3U
+
+/* max number of pins in a DIO_tstrPinGroup, the group value is one byte */
+#define DIO_u8GROUP_MAX_PINS	8U
+
+/* compile time pin resolution, with a constant pin these fold to a fixed I/O address and a one bit mask */
+#define DIO_u8PIN_BIT(PIN)		((uint8)(((PIN) <= DIO_PB7) ? (PIN) : (((PIN) <= DIO_PC6) ? ((PIN) - DIO_PC0) : ((PIN) - DIO_PD0))))
+#define DIO_u8PIN_MASK(PIN)		((uint8)(1U << DIO_u8PIN_BIT(PIN)))
+#define DIO_PORT_REG(PIN)		(*(((PIN) <= DIO_PB7) ? &PORTB : (((PIN) <= DIO_PC6) ? &PORTC : &PORTD)))
+#define DIO_DDR_REG(PIN)		(*(((PIN) <= DIO_PB7) ? &DDRB : (((PIN) <= DIO_PC6) ? &DDRC : &DDRD)))
+#define DIO_PIN_REG(PIN)		(*(((PIN) <= DIO_PB7) ? &PINB : (((PIN) <= DIO_PC6) ? &PINC : &PIND)))
+
+/* force the fast API inline even at -O0/-Os, a call would cost more than the access itself */
+#define DIO_INLINE				static inline __attribute__((always_inline))
+
+
+/*------------------------------------------ Type Definitions ---------------------------------------------*/
+
+/* pins of a group split per port once by DIO_eGroupInit, value bit n is the n-th pin given at init */
+typedef struct{
+	uint8	au8PortMask[DIO_u8NO_OF_PORTS];	/* pins of the group on each port						*/
+	sint8	as8Shift[DIO_u8NO_OF_PORTS];	/* port bit - value bit when it is the same for all the
+											   pins of the port (value moved with a single shift)	*/
+	uint8	u8ScatterPorts;					/* bit p set: pins of port p are not in value order		*/
+	uint8	u8NoOfPins;
+	uint8	au8PinPort[DIO_u8GROUP_MAX_PINS];	/* port of each pin in value bit order (scattered ports)*/
+	uint8	au8PinMask[DIO_u8GROUP_MAX_PINS];	/* port bit mask of each pin in value bit order			*/
+}DIO_tstrPinGroup;
 
 /*------------------------------------------ Global Variables ---------------------------------------------*/
 
@@ -114,6 +146,184 @@ extern void		DIO_vidDigitalPinToggle	(uint8 u8Pin);
 *************************************************************************************************************/
 extern uint8	DIO_u8DigitalRead		(uint8 u8Pin);
 
+/************************************************************************************************************
+* Function				: DIO_vidPortWriteMasked
+* Description			: Write the bits of u8Value selected by u8Mask to a port in one atomic read-modify-write,
+						  the other pins of the port are not changed.
+* Parameters[in]		: [u8Port] Range : (DIO_PORTB, DIO_PORTC, DIO_PORTD)
+						  [u8Mask] pins to update
+						  [u8Value] new pins values
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void		DIO_vidPortWriteMasked	(uint8 u8Port, uint8 u8Mask, uint8 u8Value);
+
+/************************************************************************************************************
+* Function				: DIO_u8PortRead
+* Description			: Read the input levels of all the pins of a port (PINx).
+* Parameters[in]		: [u8Port] Range : (DIO_PORTB, DIO_PORTC, DIO_PORTD)
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 PINx value, 0 for an invalid port
+*
+*************************************************************************************************************/
+extern uint8	DIO_u8PortRead			(uint8 u8Port);
+
+/************************************************************************************************************
+* Function				: DIO_vidPortSetMode
+* Description			: Set the mode of all the pins of a port selected by u8Mask at once.
+* Parameters[in]		: [u8Port] Range : (DIO_PORTB, DIO_PORTC, DIO_PORTD)
+						  [u8Mask] pins to configure
+						  [u8Mode] Range : (INPUT, OUTPUT, or INPUT_PULLUP)
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void		DIO_vidPortSetMode		(uint8 u8Port, uint8 u8Mask, uint8 u8Mode);
+
+/************************************************************************************************************
+* Function				: DIO_eGroupInit
+* Description			: Build a pin group from a list of pins, the list is split into per port masks here once
+						  so writing/reading the group costs one masked access per port.
+* Parameters[in]		: [pu8Pins] pins, the first one is bit 0 of the group value
+						  Range : see PIN MAP macros defined on top of "DIO.h" file
+						  [u8NoOfPins] Range : (1 .. DIO_u8GROUP_MAX_PINS)
+* Parameters[in/out]	: [pstrGroup] group descriptor to fill
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on an invalid or duplicated pin
+*
+*************************************************************************************************************/
+extern STD_ERR_T DIO_eGroupInit			(DIO_tstrPinGroup *pstrGroup, const uint8 *pu8Pins, uint8 u8NoOfPins);
+
+/************************************************************************************************************
+* Function				: DIO_vidGroupSetMode
+* Description			: Set the mode of all the pins of a group.
+* Parameters[in]		: [pstrGroup] group built by DIO_eGroupInit
+						  [u8Mode] Range : (INPUT, OUTPUT, or INPUT_PULLUP)
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void		DIO_vidGroupSetMode		(const DIO_tstrPinGroup *pstrGroup, uint8 u8Mode);
+
+/************************************************************************************************************
+* Function				: DIO_vidGroupWrite
+* Description			: Write a value to a group, each port is updated atomically (ports one after the other).
+* Parameters[in]		: [pstrGroup] group built by DIO_eGroupInit
+						  [u8Value] bit n drives the n-th pin of the group
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void		DIO_vidGroupWrite		(const DIO_tstrPinGroup *pstrGroup, uint8 u8Value);
+
+/************************************************************************************************************
+* Function				: DIO_u8GroupRead
+* Description			: Read the input levels of a group.
+* Parameters[in]		: [pstrGroup] group built by DIO_eGroupInit
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 bit n is the level of the n-th pin of the group
+*
+*************************************************************************************************************/
+extern uint8	DIO_u8GroupRead			(const DIO_tstrPinGroup *pstrGroup);
+
+/*------------------------------------- Compile time pin FUNCTION Definitions -----------------------------------*/
+/* The DIO_xxxFast functions below expect a constant pin (one of the PIN MAP macros): every call then compiles
+   to a single sbi / cbi / sbis instruction (2 cycles), no range check is done. With a variable pin they still
+   work but fall back to a generic read-modify-write, use the runtime API above for that case. */
+
+/************************************************************************************************************
+* Function				: DIO_vidPinWriteFast
+* Description			: Set pin value (HIGH/LOW), a constant u8Value gives a single sbi/cbi.
+* Parameters[in]		: [u8Pin] constant pin, Range : see PIN MAP macros defined on top of "DIO.h" file
+						  [u8Value] HIGH, or LOW
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+DIO_INLINE void DIO_vidPinWriteFast(uint8 u8Pin, uint8 u8Value)
+{
+	if (u8Value != LOW){
+		DIO_PORT_REG(u8Pin) |= DIO_u8PIN_MASK(u8Pin);
+	} else {
+		DIO_PORT_REG(u8Pin) &= (uint8)~DIO_u8PIN_MASK(u8Pin);
+	}
+}
+
+/************************************************************************************************************
+* Function				: DIO_vidPinSetFast
+* Description			: Drive the pin HIGH (sbi).
+* Parameters[in]		: [u8Pin] constant pin, Range : see PIN MAP macros defined on top of "DIO.h" file
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+DIO_INLINE void DIO_vidPinSetFast(uint8 u8Pin)
+{
+	DIO_PORT_REG(u8Pin) |= DIO_u8PIN_MASK(u8Pin);
+}
+
+/************************************************************************************************************
+* Function				: DIO_vidPinClearFast
+* Description			: Drive the pin LOW (cbi).
+* Parameters[in]		: [u8Pin] constant pin, Range : see PIN MAP macros defined on top of "DIO.h" file
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+DIO_INLINE void DIO_vidPinClearFast(uint8 u8Pin)
+{
+	DIO_PORT_REG(u8Pin) &= (uint8)~DIO_u8PIN_MASK(u8Pin);
+}
+
+/************************************************************************************************************
+* Function				: DIO_vidPinToggleFast
+* Description			: Toggle the pin. The ATmega8 has no PINx write toggle, this is an in/eor/out sequence
+						  (3 cycles) that is not atomic against an ISR writing the same port.
+* Parameters[in]		: [u8Pin] constant pin, Range : see PIN MAP macros defined on top of "DIO.h" file
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+DIO_INLINE void DIO_vidPinToggleFast(uint8 u8Pin)
+{
+	DIO_PORT_REG(u8Pin) ^= DIO_u8PIN_MASK(u8Pin);
+}
+
+/************************************************************************************************************
+* Function				: DIO_u8PinReadFast
+* Description			: Read the pin level from the PINx register.
+* Parameters[in]		: [u8Pin] constant pin, Range : see PIN MAP macros defined on top of "DIO.h" file
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 HIGH, or LOW
+*
+*************************************************************************************************************/
+DIO_INLINE uint8 DIO_u8PinReadFast(uint8 u8Pin)
+{
+	return ((DIO_PIN_REG(u8Pin) & DIO_u8PIN_MASK(u8Pin)) != 0U) ? HIGH : LOW;
+}
+
+/************************************************************************************************************
+* Function				: DIO_vidPinModeFast
+* Description			: Set pin mode, a constant u8Mode gives two sbi/cbi (DDRx and PORTx for the pull-up).
+* Parameters[in]		: [u8Pin] constant pin, Range : see PIN MAP macros defined on top of "DIO.h" file
+						  [u8Mode] INPUT, OUTPUT, or INPUT_PULLUP
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+DIO_INLINE void DIO_vidPinModeFast(uint8 u8Pin, uint8 u8Mode)
+{
+	if (u8Mode == OUTPUT){
+		DIO_DDR_REG(u8Pin) |= DIO_u8PIN_MASK(u8Pin);
+	} else {
+		DIO_DDR_REG(u8Pin) &= (uint8)~DIO_u8PIN_MASK(u8Pin);
+		if (u8Mode == INPUT_PULLUP){
+			DIO_PORT_REG(u8Pin) |= DIO_u8PIN_MASK(u8Pin);
+		} else {
+			DIO_PORT_REG(u8Pin) &= (uint8)~DIO_u8PIN_MASK(u8Pin);
+		}
+	}
+}
 
 
 #if 0
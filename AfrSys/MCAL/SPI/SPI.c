@@ -19,19 +19,192 @@
 
 /*--------------------------------------------- MACROS Definitions -----------------------------------------*/
 
+#define SPI_u8QUEUE_MASK		((uint8)(SPI_u8QUEUE_SIZE - 1U))
+
+#if (SPI_u8QUEUE_SIZE & (SPI_u8QUEUE_SIZE - 1U)) || (SPI_u8QUEUE_SIZE > 128U)
+#error "SPI_u8QUEUE_SIZE must be a power of 2 <= 128"
+#endif
+
+/* pins of the SPI bus, not available to the slave commands */
+#define SPI_u8SLV_BUS_PINS		((uint8)((1<<SPI_MISO) | (1<<SPI_MOSI) | (1<<SPI_SCK) | (1<<SPI_SS)))
+/* I/O registers in data space */
+#define SPI_u8SLV_REG_FIRST		((uint8)0x20)
+#define SPI_u8SLV_REG_LAST		((uint8)0x5F)
+/* data addresses of UDR and SPDR, reading them would eat a received byte */
+#define SPI_u8SLV_REG_UDR		((uint8)0x2C)
+#define SPI_u8SLV_REG_SPDR		((uint8)0x2F)
+/* low byte address of the 16-bit registers read through a latch: ADCL locks the result until ADCH is read
+   (and ADCH unlocks it), TCNT1L / ICR1L load the TEMP register a 16-bit Timer 1 write of the interrupted code
+   may be using (and the H bytes only return TEMP) */
+#define SPI_u8SLV_REG_ADCL		((uint8)0x24)
+#define SPI_u8SLV_REG_ICR1L		((uint8)0x46)
+#define SPI_u8SLV_REG_TCNT1L	((uint8)0x4C)
 
 /*---------------------------------------------- Global Variables -----------------------------------------*/
 
-#if 0
-static uint8 au8SpiTransmitBuffer[u8SPI_TX_BUFFER_SIZE]={0};
-static uint8 u8TransmitBufferIndex = 0;
+/* transaction queue, the entry at the tail is the running one */
+static SPI_tstrTransaction * volatile apstrSpiQueue[SPI_u8QUEUE_SIZE];
+static volatile uint8 u8SpiQueueHead = 0;
+static volatile uint8 u8SpiQueueTail = 0;
+/* next byte of the running transaction */
+static uint16 u16SpiXferIndex;
+/* a polled transfer owns the bus, the queue waits for it */
+static volatile uint8 u8SpiPolling = FALSE;
+/* SCK division factor of each SPI_u8CLK_DIV_x value */
+static const uint8 au8SpiClkDiv[8] = {4U, 16U, 64U, 128U, 2U, 8U, 32U, 64U};
+/* SPI_eSendByte polling loops, follows the clock rate */
+static uint16 u16SpiTimeOut = (128U * 2U) + SPI_u8TIME_OUT_MARGIN;
+/* master or slave, selected by the init routines */
+static volatile enutSpiModes eSpiMode = SPI_MASTER_MODE;
+/* slave frame parser: byte index in the frame, command high byte */
+static volatile uint8 u8SpiSlvIndex = 0;
+static uint8 u8SpiSlvCmd;
+/* response of the last frame, shifted out by the next one */
+static volatile uint8 u8SpiSlvData = SPI_u8SLV_STS_ERR;
+static volatile uint8 u8SpiSlvStatus = SPI_u8SLV_STS_ERR;
 
-static uint8 au8UartReceiveBuffer[u8SPI_RX_BUFFER_SIZE]={0};
-static uint8 u8ReceiveBufferIndex = 0;
-#endif
 
+/*-------------------------------------------- FUNCTION Definitions ---------------------------------------*/
+
+/* write the bus settings to SPCR/SPSR */
+static void SPI_vidApplyConfig(const SPI_tstrConfig *pstrConfig)
+{
+	uint8 u8Div = pstrConfig->u8ClockDiv;
+
+	SPCR = (SPCR & (uint8)~((1<<DORD)|(1<<CPOL)|(1<<CPHA)|(1<<SPR1)|(1<<SPR0))) |
+		   ((pstrConfig->u8DataOrder & 0x01U) << DORD) |
+		   (((pstrConfig->u8Mode >> 1) & 0x01U) << CPOL) |
+		   ((pstrConfig->u8Mode & 0x01U) << CPHA) |
+		   (u8Div & 0x03U);
+	SPSR = ((u8Div >> 2) & 0x01U) << SPI2X;
+	/* one byte = 8 * division cycles, a polling loop takes more than 4 cycles */
+	u16SpiTimeOut = ((uint16)au8SpiClkDiv[u8Div & 0x07U] * 2U) + SPI_u8TIME_OUT_MARGIN;
+}
+
+/* take the bus for a polled transfer, the queue must be idle */
+static STD_ERR_T SPI_eAcquirePolled(void)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint8 u8Sreg = SREG;
+
+	cli();
+	if ((eSpiMode == SPI_MASTER_MODE) && (u8SpiQueueHead == u8SpiQueueTail) && (u8SpiPolling == FALSE)){
+		u8SpiPolling = TRUE;
+		errRetVal = STD_ERR_OK;
+	}
+	SREG = u8Sreg;
+	return errRetVal;
+}
+
+static void SPI_vidStartXfer(void);
+
+/* give the bus back, start what an ISR queued meanwhile */
+static void SPI_vidReleasePolled(void)
+{
+	uint8 u8Sreg = SREG;
+
+	cli();
+	u8SpiPolling = FALSE;
+	if (u8SpiQueueHead != u8SpiQueueTail){
+		SPI_vidStartXfer();
+	}
+	SREG = u8Sreg;
+}
+
+/* assert CS of the transaction at the tail and send its first byte, interrupts disabled */
+static void SPI_vidStartXfer(void)
+{
+	SPI_tstrTransaction *pstrXfer = apstrSpiQueue[u8SpiQueueTail & SPI_u8QUEUE_MASK];
+
+	u16SpiXferIndex = 0;
+	if (pstrXfer->pstrConfig != NULL){
+		SPI_vidApplyConfig(pstrXfer->pstrConfig);
+	}
+	if (pstrXfer->u8CsPin != SPI_u8NO_CS){
+		DIO_vidDigitalPinWrite(pstrXfer->u8CsPin, LOW);
+	}
+	SPCR |= (1<<SPIE);
+	SPDR = (pstrXfer->pu8Tx != NULL) ? pstrXfer->pu8Tx[0] : SPI_u8DUMMY_BYTE;
+}
+
+/* pin of a slave command, the SPI bus pins are refused */
+static boolean SPI_bSlaveValidPin(uint8 u8Pin)
+{
+	return ((u8Pin <= DIO_PD7) &&
+			((u8Pin > DIO_PB7) || ((DIO_u8PIN_MASK(u8Pin) & SPI_u8SLV_BUS_PINS) == 0U))) ? TRUE : FALSE;
+}
+
+/* I/O register of a slave command, the registers with a read side effect are refused */
+static boolean SPI_bSlaveValidReg(uint8 u8Addr)
+{
+	uint8 u8Low = (uint8)(u8Addr & 0xFEU);
+
+	return ((u8Addr >= SPI_u8SLV_REG_FIRST) && (u8Addr <= SPI_u8SLV_REG_LAST) &&
+			(u8Addr != SPI_u8SLV_REG_UDR) && (u8Addr != SPI_u8SLV_REG_SPDR) &&
+			(u8Low != SPI_u8SLV_REG_ADCL) && (u8Low != SPI_u8SLV_REG_ICR1L) &&
+			(u8Low != SPI_u8SLV_REG_TCNT1L)) ? TRUE : FALSE;
+}
 
-/*-------------------------------------------- FUNCTION Definitions ---------------------------------------*
+/* execute one slave frame and prepare its response, SPI ISR context */
+static void SPI_vidSlaveExecute(uint8 u8CmdHigh, uint8 u8Param)
+{
+	uint16 u16Cmd = (uint16)((uint16)u8CmdHigh << 8);
+	uint8 u8Arg = (uint8)((u16Cmd & SPI_CMD_ARG_MASK) >> SPI_CMD_ARG_SHIFT);
+	uint8 u8Data = 0U;
+	uint8 u8Status = u8CmdHigh;
+
+	switch (u16Cmd & SPI_CMD_MASK){
+	case SPI_CMD_NOP:
+		break;
+	case SPI_CMD_SET_PIN:
+		if (SPI_bSlaveValidPin(u8Param) != FALSE){
+			DIO_vidDigitalPinWrite(u8Param, ((u16Cmd & SPI_PIN_VALUE_BIT) != 0U) ? HIGH : LOW);
+		} else {
+			u8Status = SPI_u8SLV_STS_ERR;
+		}
+		break;
+	case SPI_CMD_SENDRECEIVE:
+		if (u8Param <= DIO_PD7){
+			u8Data = DIO_u8DigitalRead(u8Param);
+		} else {
+			u8Status = SPI_u8SLV_STS_ERR;
+		}
+		break;
+	case SPI_CMD_READ_PORT:
+		if (u8Param < DIO_u8NO_OF_PORTS){
+			u8Data = DIO_u8PortRead(u8Param);
+		} else {
+			u8Status = SPI_u8SLV_STS_ERR;
+		}
+		break;
+	case SPI_CMD_WRITE_PORT:
+		if (u8Arg < DIO_u8NO_OF_PORTS){
+			DIO_vidPortWriteMasked(u8Arg, (u8Arg == DIO_PORTB) ? (uint8)~SPI_u8SLV_BUS_PINS : 0xFFU, u8Param);
+		} else {
+			u8Status = SPI_u8SLV_STS_ERR;
+		}
+		break;
+	case SPI_CMD_PIN_MODE:
+		if ((SPI_bSlaveValidPin(u8Param) != FALSE) && (u8Arg <= INPUT_PULLUP)){
+			DIO_vidSetPinMode(u8Param, u8Arg);
+		} else {
+			u8Status = SPI_u8SLV_STS_ERR;
+		}
+		break;
+	case SPI_CMD_READ_REG:
+		if (SPI_bSlaveValidReg(u8Param) != FALSE){
+			u8Data = _SFR_MEM8(u8Param);
+		} else {
+			u8Status = SPI_u8SLV_STS_ERR;
+		}
+		break;
+	default:
+		u8Status = SPI_u8SLV_STS_ERR;
+		break;
+	}
+	u8SpiSlvData = u8Data;
+	u8SpiSlvStatus = u8Status;
+}
 
 /************************************************************************************************************
 * Function				: SPI_vidMasterInit
@@ -42,6 +215,7 @@ static uint8 u8ReceiveBufferIndex = 0;
 *
 *************************************************************************************************************/
 extern void SPI_vidMasterInit(void) {   
+	eSpiMode = SPI_MASTER_MODE;
 	/*Set MOSI, SS, SCK as output*/
     SPI_DDR |= ((1<<SPI_MOSI) | (1<<SPI_SS) | (1<<SPI_SCK));
 	/*Set MISO as input*/
@@ -49,7 +223,7 @@ extern void SPI_vidMasterInit(void) {
 	/*set MISO to pull up */ 
 	SPI_PORT |= (1<<SPI_MISO);
     SPCR = ((1<<SPE) |              /* SPI Enable */
-            (1<<SPIE)|              /* SPI Interrupt Enable */
+            (0<<SPIE)|              /* SPI Interrupt Enable (only while the queue runs) */
             (0<<DORD)|              /* Data Order (0:MSB first / 1:LSB first) */
             (1<<MSTR)|              /* Master/Slave select 1:master , 0:slave */
             (1<<SPR1)|(1<<SPR0)|    /* SPI Clock Rate */
@@ -58,6 +232,61 @@ extern void SPI_vidMasterInit(void) {
     SPSR = (0<<SPI2X);				/* Double SPI Speed Bit */
 }
 
+/************************************************************************************************************
+* Function				: SPI_vidSlaveInit
+* Description			: SPI initialization routine in slave mode (mode 0, MSB first). The SPI ISR decodes the
+						  SPI_CMD_x frames of the master and executes them, the response goes out with the next
+						  frame.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void SPI_vidSlaveInit(void) {
+	uint8 u8Sreg = SREG;
+
+	cli();
+	eSpiMode = SPI_SLAVE_MODE;
+	u8SpiSlvIndex = 0U;
+	u8SpiSlvData = SPI_u8SLV_STS_ERR;
+	u8SpiSlvStatus = SPI_u8SLV_STS_ERR;
+	/*Set MOSI, SS, SCK as input*/
+	SPI_DDR &= ~((1<<SPI_MOSI) | (1<<SPI_SS) | (1<<SPI_SCK));
+	/*Set MISO as output (driven only while SS is low)*/
+	SPI_DDR |= (1<<SPI_MISO);
+	SPCR = ((1<<SPE) |              /* SPI Enable */
+			(1<<SPIE)|              /* SPI Interrupt Enable (frame parser) */
+			(0<<DORD)|              /* Data Order (0:MSB first / 1:LSB first) */
+			(0<<MSTR)|              /* Master/Slave select 1:master , 0:slave */
+			(0<<CPOL)|              /* Clock Polarity (0:SCK low / 1:SCK hi when idle) */
+			(0<<CPHA));             /* Clock Phase (0:leading / 1:trailing edge sampling) */
+	SPSR = (0<<SPI2X);
+	/* first byte of the first frame */
+	SPDR = u8SpiSlvData;
+	SREG = u8Sreg;
+}
+
+/************************************************************************************************************
+* Function				: SPI_vidSlaveSync
+* Description			: Restart the frame parser if SS is released, call from the main loop.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void SPI_vidSlaveSync(void)
+{
+	uint8 u8Sreg = SREG;
+
+	cli();
+	if ((eSpiMode == SPI_SLAVE_MODE) && (u8SpiSlvIndex != 0U) && ((SPI_PIN & (1<<SPI_SS)) != 0U)){
+		/* no byte can start while SS is high, SPDR may be written */
+		u8SpiSlvIndex = 0U;
+		SPDR = u8SpiSlvData;
+	}
+	SREG = u8Sreg;
+}
+
 /************************************************************************************************************
 * Function				: SPI_eSendByte
 * Description			: Send one byte via SPI.
@@ -67,22 +296,237 @@ extern void SPI_vidMasterInit(void) {
 *
 *************************************************************************************************************/
 extern STD_ERR_T SPI_eSendByte(uint8 u8Data){
-	uint8 u8TimeOut = SPI_TIME_OUT;
+	uint16 u16TimeOut = u16SpiTimeOut;
 	STD_ERR_T errRetVal = STD_ERR_NOK;
 	
+	if (SPI_eAcquirePolled() != STD_ERR_OK){
+		/* the queue owns the bus */
+		return STD_ERR_NOK;
+	}
 	SPDR = u8Data;
-	while( !(SPSR & (1<<SPIF)) && (u8TimeOut !=0 )){
-		u8TimeOut--;
+	while( !(SPSR & (1<<SPIF)) && (u16TimeOut !=0 )){
+		u16TimeOut--;
 	}
-	if(u8TimeOut != 0){
+	if(u16TimeOut != 0){
+		/* clear SPIF (SPSR read above then SPDR access) */
+		(void)SPDR;
 		errRetVal = STD_ERR_OK;
 	}
+	SPI_vidReleasePolled();
 	return 	errRetVal;
 }
 
-//TODO::handle receive and transmit
+/************************************************************************************************************
+* Function				: SPI_eConfigure
+* Description			: Set the clock rate, mode and data order of the next transfers (master mode).
+* Parameters[in]		: [pstrConfig] bus settings
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the bus is busy or a setting is out of range
+*
+*************************************************************************************************************/
+extern STD_ERR_T SPI_eConfigure(const SPI_tstrConfig *pstrConfig)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+
+	if ((pstrConfig != NULL) && (pstrConfig->u8ClockDiv <= SPI_u8CLK_DIV_32) &&
+		(pstrConfig->u8Mode <= SPI_u8MODE_3) && (pstrConfig->u8DataOrder <= SPI_u8LSB_FIRST)){
+		if (SPI_eAcquirePolled() == STD_ERR_OK){
+			SPI_vidApplyConfig(pstrConfig);
+			SPI_vidReleasePolled();
+			errRetVal = STD_ERR_OK;
+		}
+	}
+	return errRetVal;
+}
+
+/************************************************************************************************************
+* Function				: SPI_eTransfer
+* Description			: Full duplex bulk transfer by polling, the next byte is loaded while the current one
+						  shifts out so the bus stays close to fosc/2 without an interrupt per byte. Chip select
+						  is driven by the caller.
+* Parameters[in]		: [pu8Tx] bytes to send
+						  [u16Len] number of bytes, > 0
+* Parameters[in/out]	: [pu8Rx] received bytes (may be the same buffer as pu8Tx)
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the queue owns the bus or on invalid parameters
+*
+*************************************************************************************************************/
+extern STD_ERR_T SPI_eTransfer(const uint8 *pu8Tx, uint8 *pu8Rx, uint16 u16Len)
+{
+	uint8 u8Next;
+	uint8 u8Rx;
+
+	if ((pu8Tx == NULL) || (pu8Rx == NULL) || (u16Len == 0U) || (SPI_eAcquirePolled() != STD_ERR_OK)){
+		return STD_ERR_NOK;
+	}
+	SPDR = *pu8Tx++;
+	while (--u16Len != 0U){
+		/* fetched while the current byte shifts out (16 cycles at fosc/2) */
+		u8Next = *pu8Tx++;
+		while (!(SPSR & (1<<SPIF)));
+		/* SPDR read clears SPIF, the next byte goes out before the store */
+		u8Rx = SPDR;
+		SPDR = u8Next;
+		*pu8Rx++ = u8Rx;
+	}
+	while (!(SPSR & (1<<SPIF)));
+	*pu8Rx = SPDR;
+	SPI_vidReleasePolled();
+	return STD_ERR_OK;
+}
+
+/************************************************************************************************************
+* Function				: SPI_eSend
+* Description			: Send only version of SPI_eTransfer, the received bytes are dropped.
+* Parameters[in]		: [pu8Tx] bytes to send
+						  [u16Len] number of bytes, > 0
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the queue owns the bus or on invalid parameters
+*
+*************************************************************************************************************/
+extern STD_ERR_T SPI_eSend(const uint8 *pu8Tx, uint16 u16Len)
+{
+	uint8 u8Next;
+
+	if ((pu8Tx == NULL) || (u16Len == 0U) || (SPI_eAcquirePolled() != STD_ERR_OK)){
+		return STD_ERR_NOK;
+	}
+	SPDR = *pu8Tx++;
+	while (--u16Len != 0U){
+		u8Next = *pu8Tx++;
+		while (!(SPSR & (1<<SPIF)));
+		/* SPSR read with SPIF set then the SPDR write clears SPIF */
+		SPDR = u8Next;
+	}
+	while (!(SPSR & (1<<SPIF)));
+	(void)SPDR;
+	SPI_vidReleasePolled();
+	return STD_ERR_OK;
+}
+
+/************************************************************************************************************
+* Function				: SPI_eReceive
+* Description			: Receive only version of SPI_eTransfer, SPI_u8DUMMY_BYTE is sent.
+* Parameters[in]		: [u16Len] number of bytes, > 0
+* Parameters[in/out]	: [pu8Rx] received bytes
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the queue owns the bus or on invalid parameters
+*
+*************************************************************************************************************/
+extern STD_ERR_T SPI_eReceive(uint8 *pu8Rx, uint16 u16Len)
+{
+	uint8 u8Rx;
+
+	if ((pu8Rx == NULL) || (u16Len == 0U) || (SPI_eAcquirePolled() != STD_ERR_OK)){
+		return STD_ERR_NOK;
+	}
+	SPDR = SPI_u8DUMMY_BYTE;
+	while (--u16Len != 0U){
+		while (!(SPSR & (1<<SPIF)));
+		u8Rx = SPDR;
+		SPDR = SPI_u8DUMMY_BYTE;
+		*pu8Rx++ = u8Rx;
+	}
+	while (!(SPSR & (1<<SPIF)));
+	*pu8Rx = SPDR;
+	SPI_vidReleasePolled();
+	return STD_ERR_OK;
+}
+
+/************************************************************************************************************
+* Function				: SPI_eQueueTransaction
+* Description			: Append a transaction to the queue and return at once. The SPI ISR asserts CS, exchanges
+						  the bytes one by one, releases CS, calls the call back and starts the next entry.
+						  The entry and its buffers must stay valid until the call back.
+* Parameters[in]		: [pstrXfer] transaction to run (master mode)
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the queue is full or the transaction is empty
+*
+*************************************************************************************************************/
+extern STD_ERR_T SPI_eQueueTransaction(SPI_tstrTransaction *pstrXfer)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint8 u8Sreg;
+
+	if ((pstrXfer != NULL) && (pstrXfer->u16Len != 0U) && (eSpiMode == SPI_MASTER_MODE)){
+		u8Sreg = SREG;
+		cli();
+		if ((uint8)(u8SpiQueueHead - u8SpiQueueTail) < SPI_u8QUEUE_SIZE){
+			apstrSpiQueue[u8SpiQueueHead & SPI_u8QUEUE_MASK] = pstrXfer;
+			u8SpiQueueHead++;
+			if (((uint8)(u8SpiQueueHead - u8SpiQueueTail) == 1U) && (u8SpiPolling == FALSE)){
+				/* queue was idle, a polled transfer starts it when it ends */
+				SPI_vidStartXfer();
+			}
+			errRetVal = STD_ERR_OK;
+		}
+		SREG = u8Sreg;
+	}
+	return errRetVal;
+}
+
+/************************************************************************************************************
+* Function				: SPI_u8GetPending
+* Description			: Number of transactions queued or running.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 pending transactions
+*
+*************************************************************************************************************/
+extern uint8 SPI_u8GetPending(void)
+{
+	return (uint8)(u8SpiQueueHead - u8SpiQueueTail);
+}
+
+/************************************************************************************************************
+Function			: SPI_STC_vect ISR routine
+Description			: Serial transfer complete: store the received byte and send the next one of the running
+					  transaction, at its end release CS, notify and start the next queued transaction.
+Parameters[in]		: None
+Parameters[in/out]	: None
+Parameters[out]		: None
+*************************************************************************************************************/
 ISR(SPI_STC_vect){
-	
-	
-	DIO_vidDigitalPinToggle(DIO_PC2);
+	SPI_tstrTransaction *pstrXfer;
+	uint8 u8Rx = SPDR;
+	boolean bNext;
+
+	if (eSpiMode == SPI_SLAVE_MODE){
+		if (u8SpiSlvIndex == 0U){
+			u8SpiSlvCmd = u8Rx;
+			u8SpiSlvIndex = 1U;
+			SPDR = u8SpiSlvStatus;
+		} else {
+			u8SpiSlvIndex = 0U;
+			SPI_vidSlaveExecute(u8SpiSlvCmd, u8Rx);
+			SPDR = u8SpiSlvData;
+		}
+		return;
+	}
+	if (u8SpiQueueHead == u8SpiQueueTail){
+		SPCR &= ~(1<<SPIE);
+		return;
+	}
+	pstrXfer = apstrSpiQueue[u8SpiQueueTail & SPI_u8QUEUE_MASK];
+	if (pstrXfer->pu8Rx != NULL){
+		pstrXfer->pu8Rx[u16SpiXferIndex] = u8Rx;
+	}
+	u16SpiXferIndex++;
+	if (u16SpiXferIndex < pstrXfer->u16Len){
+		SPDR = (pstrXfer->pu8Tx != NULL) ? pstrXfer->pu8Tx[u16SpiXferIndex] : SPI_u8DUMMY_BYTE;
+	} else {
+		if (pstrXfer->u8CsPin != SPI_u8NO_CS){
+			DIO_vidDigitalPinWrite(pstrXfer->u8CsPin, HIGH);
+		}
+		/* the entry is free before the call back so it can queue it again */
+		u8SpiQueueTail++;
+		bNext = (u8SpiQueueHead != u8SpiQueueTail) ? TRUE : FALSE;
+		if (pstrXfer->pfvClbk != NULL){
+			/* queuing into the empty queue from here starts the transaction at once */
+			pstrXfer->pfvClbk();
+		}
+		if (bNext != FALSE){
+			SPI_vidStartXfer();
+		} else if (u8SpiQueueHead == u8SpiQueueTail){
+			SPCR &= ~(1<<SPIE);
+		}
+	}
 }
\ No newline at end of file
@@ -24,14 +24,54 @@
 
 /*--------------------------------------------- MACROS Definitions -----------------------------------------*/
 
-#define u8SPI_TX_BUFFER_SIZE   ((uint8)150)
-#define u8SPI_RX_BUFFER_SIZE   ((uint8)150)
-
-#define SPI_TIME_OUT		   ((uint8)40)
-
-#define SPI_CMD_SET_PIN 0x1000
-#define SPI_CMD_SENDRECEIVE 0x2000
-#define SPI_PIN_VALUE_BIT 0x0800
+/* SPI_eSendByte time out margin in polling loops on top of the byte time */
+#define SPI_u8TIME_OUT_MARGIN	((uint8)16)
+
+/* clock rate (SPI_tstrConfig.u8ClockDiv): bits 1:0 = SPR1:0, bit 2 = SPI2X */
+#define SPI_u8CLK_DIV_2			((uint8)0x04)
+#define SPI_u8CLK_DIV_4			((uint8)0x00)
+#define SPI_u8CLK_DIV_8			((uint8)0x05)
+#define SPI_u8CLK_DIV_16		((uint8)0x01)
+#define SPI_u8CLK_DIV_32		((uint8)0x06)
+#define SPI_u8CLK_DIV_64		((uint8)0x02)
+#define SPI_u8CLK_DIV_128		((uint8)0x03)
+
+/* SPI mode (SPI_tstrConfig.u8Mode): bit 1 = CPOL, bit 0 = CPHA */
+#define SPI_u8MODE_0			((uint8)0)	/* SCK idle low,  sample on rising edge	*/
+#define SPI_u8MODE_1			((uint8)1)	/* SCK idle low,  sample on falling edge	*/
+#define SPI_u8MODE_2			((uint8)2)	/* SCK idle high, sample on falling edge	*/
+#define SPI_u8MODE_3			((uint8)3)	/* SCK idle high, sample on rising edge	*/
+
+/* data order (SPI_tstrConfig.u8DataOrder) */
+#define SPI_u8MSB_FIRST			((uint8)0)
+#define SPI_u8LSB_FIRST			((uint8)1)
+
+/* pending transactions (pointers), power of 2 <= 128 */
+#define SPI_u8QUEUE_SIZE		4U
+/* u8CsPin value of a transaction without chip select */
+#define SPI_u8NO_CS				((uint8)0xFF)
+/* byte clocked out by the receive only part of a transaction (pu8Tx == NULL) */
+#define SPI_u8DUMMY_BYTE		((uint8)0xFF)
+
+/* slave mode command frame: 2 bytes, MSB first
+   bits 15:12 command, bit 11 pin value (SPI_PIN_VALUE_BIT), bit 10 reserved (0), bits 9:8 argument (ARG),
+   bits 7:0 pin / port / register address
+   the response to a frame is shifted out by the next frame: [data, status] */
+#define SPI_CMD_MASK			0xF000
+#define SPI_CMD_ARG_MASK		0x0300
+#define SPI_CMD_ARG_SHIFT		8
+#define SPI_CMD_NOP				0x0000	/* no action, fetches the response of the previous frame		*/
+#define SPI_CMD_SET_PIN			0x1000	/* write pin [7:0] to SPI_PIN_VALUE_BIT						*/
+#define SPI_CMD_SENDRECEIVE		0x2000	/* read pin [7:0], data = HIGH or LOW							*/
+#define SPI_CMD_READ_PORT		0x3000	/* read PINx of port [7:0] (DIO_PORTB ..), data = PINx			*/
+#define SPI_CMD_WRITE_PORT		0x4000	/* write [7:0] to port ARG, the SPI pins are kept				*/
+#define SPI_CMD_PIN_MODE		0x5000	/* set pin [7:0] mode to ARG (INPUT, OUTPUT, INPUT_PULLUP)		*/
+#define SPI_CMD_READ_REG		0x6000	/* read I/O register at data address [7:0] (0x20 .. 0x5F), not
+										   UDR, SPDR, ADCL/H, ICR1L/H, TCNT1L/H (read side effects)		*/
+#define SPI_PIN_VALUE_BIT		0x0800
+
+/* status byte of a response: the command high byte when executed, else SPI_u8SLV_STS_ERR */
+#define SPI_u8SLV_STS_ERR		((uint8)0xFF)
 
 //SPI PORT&PIN Config
 #define SPI_DDR		DDRB
@@ -40,6 +80,7 @@
 #define SPI_MOSI	PB3
 #define SPI_SCK		PB5
 #define SPI_SS		PB2
+#define SPI_PIN		PINB
 
 /*------------------------------------------ Type Definitions  ------------------------------------------------*/
 
@@ -48,6 +89,26 @@ typedef enum{
 	SPI_SLAVE_MODE
 }enutSpiModes;
 
+/* end of transaction notification (SPI ISR context) */
+typedef void (*SPI_tpfvidXferClbk)(void);
+
+/* bus settings of a transaction */
+typedef struct{
+	uint8	u8ClockDiv;		/* SPI_u8CLK_DIV_2 .. SPI_u8CLK_DIV_128	*/
+	uint8	u8Mode;			/* SPI_u8MODE_0 .. SPI_u8MODE_3			*/
+	uint8	u8DataOrder;	/* SPI_u8MSB_FIRST, SPI_u8LSB_FIRST		*/
+}SPI_tstrConfig;
+
+/* one queued transaction, owned by the caller until its call back runs */
+typedef struct{
+	uint8				u8CsPin;	/* DIO pin driven low during the transfer (output), or SPI_u8NO_CS	*/
+	const uint8			*pu8Tx;		/* bytes to send, NULL sends SPI_u8DUMMY_BYTE						*/
+	uint8				*pu8Rx;		/* received bytes, NULL drops them									*/
+	uint16				u16Len;		/* bytes to exchange, > 0											*/
+	SPI_tpfvidXferClbk	pfvClbk;	/* may be NULL														*/
+	const SPI_tstrConfig *pstrConfig;	/* applied before the transfer, NULL keeps the current one		*/
+}SPI_tstrTransaction;
+
 /*---------------------------------------------- Global Variables -----------------------------------------*/
 
 
@@ -65,7 +126,13 @@ extern void SPI_vidMasterInit(void);
 
 /************************************************************************************************************
 * Function				: SPI_vidSlaveInit
-* Description			: SPI initialization routine in slave mode.
+* Description			: SPI initialization routine in slave mode (mode 0, MSB first). The SPI ISR decodes the
+						  SPI_CMD_x frames of the master and executes them, so the board works as an I/O expander.
+						  The response is loaded into SPDR at the end of a frame and goes out with the next one,
+						  so the master reads the result of frame n while it sends frame n+1 (SPI_CMD_NOP to read
+						  the last one). The ISR runs between the bytes: the master must wait for it (about 100 us
+						  at 1 MHz) after each byte, otherwise the byte is dropped (WCOL).
+						  The master mode transfer functions fail in this mode.
 * Parameters[in]		: None
 * Parameters[in/out]	: None
 * Parameters[out]		: None
@@ -73,6 +140,18 @@ extern void SPI_vidMasterInit(void);
 *************************************************************************************************************/
 extern void SPI_vidSlaveInit(void);
 
+/************************************************************************************************************
+* Function				: SPI_vidSlaveSync
+* Description			: Restart the frame parser if SS is released. The ATmega8 has no SS interrupt, so a
+						  frame cut short by the master leaves the parser in the middle of a frame; call this from
+						  the main loop to line up on the next frame. The master keeps SS high between frames.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void SPI_vidSlaveSync(void);
+
 /************************************************************************************************************
 * Function				: SPI_eSendByte
 * Description			: Send one byte via SPI.
@@ -83,6 +162,72 @@ extern void SPI_vidSlaveInit(void);
 *************************************************************************************************************/
 extern STD_ERR_T SPI_eSendByte(uint8 u8Data);
 
+/************************************************************************************************************
+* Function				: SPI_eConfigure
+* Description			: Set the clock rate, mode and data order of the next transfers (master mode).
+* Parameters[in]		: [pstrConfig] bus settings
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the bus is busy or a setting is out of range
+*
+*************************************************************************************************************/
+extern STD_ERR_T SPI_eConfigure(const SPI_tstrConfig *pstrConfig);
+
+/************************************************************************************************************
+* Function				: SPI_eTransfer
+* Description			: Full duplex bulk transfer by polling, the next byte is loaded while the current one
+						  shifts out so the bus stays close to fosc/2 without an interrupt per byte. Chip select
+						  is driven by the caller.
+* Parameters[in]		: [pu8Tx] bytes to send
+						  [u16Len] number of bytes, > 0
+* Parameters[in/out]	: [pu8Rx] received bytes (may be the same buffer as pu8Tx)
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the queue owns the bus or on invalid parameters
+*
+*************************************************************************************************************/
+extern STD_ERR_T SPI_eTransfer(const uint8 *pu8Tx, uint8 *pu8Rx, uint16 u16Len);
+
+/************************************************************************************************************
+* Function				: SPI_eSend
+* Description			: Send only version of SPI_eTransfer, the received bytes are dropped.
+* Parameters[in]		: [pu8Tx] bytes to send
+						  [u16Len] number of bytes, > 0
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the queue owns the bus or on invalid parameters
+*
+*************************************************************************************************************/
+extern STD_ERR_T SPI_eSend(const uint8 *pu8Tx, uint16 u16Len);
+
+/************************************************************************************************************
+* Function				: SPI_eReceive
+* Description			: Receive only version of SPI_eTransfer, SPI_u8DUMMY_BYTE is sent.
+* Parameters[in]		: [u16Len] number of bytes, > 0
+* Parameters[in/out]	: [pu8Rx] received bytes
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the queue owns the bus or on invalid parameters
+*
+*************************************************************************************************************/
+extern STD_ERR_T SPI_eReceive(uint8 *pu8Rx, uint16 u16Len);
+
+/************************************************************************************************************
+* Function				: SPI_eQueueTransaction
+* Description			: Append a transaction to the queue and return at once. The SPI ISR asserts CS, exchanges
+						  the bytes one by one, releases CS, calls the call back and starts the next entry.
+						  The entry and its buffers must stay valid until the call back.
+* Parameters[in]		: [pstrXfer] transaction to run (master mode)
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the queue is full or the transaction is empty
+*
+*************************************************************************************************************/
+extern STD_ERR_T SPI_eQueueTransaction(SPI_tstrTransaction *pstrXfer);
+
+/************************************************************************************************************
+* Function				: SPI_u8GetPending
+* Description			: Number of transactions queued or running.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 pending transactions
+*
+*************************************************************************************************************/
+extern uint8 SPI_u8GetPending(void);
+
 
 
 
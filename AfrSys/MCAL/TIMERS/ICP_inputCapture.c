@@ -0,0 +1,405 @@
+/*! \file ICP_inputCapture.c \brief Timer 1 input capture: time stamps, period, frequency and duty cycle. */
+/************************************************************************************************************
+*
+* File Name		: 'ICP_inputCapture.c'
+* Title			: Timer 1 input capture: time stamps, period, frequency and duty cycle
+* Version		: 1.0
+* Target MCU	: Atmel AVR Series
+*
+************************************************************************************************************/
+
+
+/*------------------------------------------------- INCLUDES ----------------------------------------------*/
+#include "Common_Macros.h"
+#include "DIO.h"
+
+#include "ICP_inputCapture.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+#define ICP_u8RING_MASK			(uint8)(ICP_u8RING_SIZE - 1U)
+
+#if (ICP_u8RING_SIZE & (ICP_u8RING_SIZE - 1U)) || (ICP_u8RING_SIZE > 128U)
+#error "ICP_u8RING_SIZE must be a power of 2 <= 128"
+#endif
+
+/* number of Timer 1 internal clock prescaler IDs (TIM1_NO_PRESCALER .. TIM1_1024_PRESCALER) */
+#define ICP_u8NO_OF_PRESCALERS	5U
+
+/* the measures available */
+#define ICP_u8VALID_REF			(uint8)0x01		/* a reference edge was captured */
+#define ICP_u8VALID_PERIOD		(uint8)0x02
+#define ICP_u8VALID_HIGH		(uint8)0x04
+
+/* CPU clocks per micro second */
+#define ICP_u32CPU_MHZ			(uint32)(F_CPU / 1000000UL)
+
+/*---------------------------------------------- Global Variables -----------------------------------------*/
+
+/* Timer 1 division factor of each prescaler ID, index = ID - 1 */
+static const uint16 au16IcpPrescaler[ICP_u8NO_OF_PRESCALERS] = {1U, 8U, 64U, 256U, 1024U};
+
+static uint8 u8IcpEdgeMode;
+static uint8 u8IcpPrescalerId = TIM1_STOP;
+/* TCCR1B at start: noise canceler, first edge, clock select */
+static uint8 u8IcpTccr1b;
+
+/* high word of the time stamps, counted by the Timer 1 overflow ISR */
+static volatile uint16 u16IcpOverflows;
+
+/* time stamps ring: written by the capture ISR, read by the application */
+static ICP_tstrCapture astrIcpRing[ICP_u8RING_SIZE];
+static volatile uint8 u8IcpHead;
+static volatile uint8 u8IcpTail;
+static volatile uint16 u16IcpOverruns;
+
+/* measures, updated by the capture ISR */
+static uint32 u32IcpLastRef;		/* last reference edge (rising edge in ICP_u8EDGE_BOTH mode) */
+static uint32 u32IcpLastEdge;
+static uint32 u32IcpPeriod;
+static uint32 u32IcpHigh;
+static volatile uint8 u8IcpValid;
+
+/*-------------------------------------------- FUNCTION Definitions ---------------------------------------*/
+
+/* Timer 1 overflow ISR context */
+static void ICP_vidOnOverflow(void)
+{
+	u16IcpOverflows++;
+}
+
+/* copy the measures out of the ISR reach, NOK if the period is unknown or the signal stopped */
+static STD_ERR_T ICP_eGetMeasures(uint32 *pu32Period, uint32 *pu32High, uint8 *pu8Valid)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint8 u8Sreg = SREG;
+	uint32 u32LastEdge;
+
+	cli();
+	*pu32Period = u32IcpPeriod;
+	*pu32High = u32IcpHigh;
+	*pu8Valid = u8IcpValid;
+	u32LastEdge = u32IcpLastEdge;
+	SREG = u8Sreg;
+
+	if ((*pu8Valid & ICP_u8VALID_PERIOD) != 0U){
+		/* a stopped signal keeps its last period, halved to compare without overflow */
+		if (((ICP_u32GetTicks() - u32LastEdge) >> 1) <= *pu32Period){
+			errRetVal = STD_ERR_OK;
+		}
+	}
+	return errRetVal;
+}
+
+/******************************************************************************
+Function			: TIMER1_CAPT_vect ISR routine
+Description			: Timer1 input capture interrupt service routine.
+Parameters[in]		: None
+Parameters[in/out]	: None
+Parameters[out]		: None
+********************************************************************************/
+ISR(TIMER1_CAPT_vect)
+{
+	uint16 u16Icr = ICR1;
+	uint16 u16Overflows = u16IcpOverflows;
+	uint32 u32Ticks;
+	uint8 u8Edge;
+
+	/* the overflow ISR has a lower priority: an overflow pending with a small ICR1 happened before the edge */
+	if ((TIFR & (1<<TOV1)) && (u16Icr < 0x8000U)){
+		u16Overflows++;
+	}
+	u32Ticks = ((uint32)u16Overflows << 16) | u16Icr;
+	u8Edge = (TCCR1B & (1<<ICES1)) ? ICP_u8EDGE_RISING : ICP_u8EDGE_FALLING;
+
+	if (u8IcpEdgeMode == ICP_u8EDGE_BOTH){
+		/* wait for the other edge, changing ICES1 may set ICF1 */
+		TCCR1B ^= (1<<ICES1);
+		TIFR = (1<<ICF1);
+	}
+
+	if ((u8IcpEdgeMode != ICP_u8EDGE_BOTH) || (u8Edge == ICP_u8EDGE_RISING)){
+		if ((u8IcpValid & ICP_u8VALID_REF) != 0U){
+			u32IcpPeriod = u32Ticks - u32IcpLastRef;
+			u8IcpValid |= ICP_u8VALID_PERIOD;
+		}
+		u32IcpLastRef = u32Ticks;
+		u8IcpValid |= ICP_u8VALID_REF;
+	} else if ((u8IcpValid & ICP_u8VALID_REF) != 0U){
+		u32IcpHigh = u32Ticks - u32IcpLastRef;
+		u8IcpValid |= ICP_u8VALID_HIGH;
+	}
+	u32IcpLastEdge = u32Ticks;
+
+	if ((uint8)(u8IcpHead - u8IcpTail) < ICP_u8RING_SIZE){
+		astrIcpRing[u8IcpHead & ICP_u8RING_MASK].u32Ticks = u32Ticks;
+		astrIcpRing[u8IcpHead & ICP_u8RING_MASK].u8Edge = u8Edge;
+		u8IcpHead++;
+	} else if (u16IcpOverruns != 0xFFFFU){
+		u16IcpOverruns++;
+	}
+}
+
+/*************************************************************************************************************
+* Function				: ICP_eInit
+* Description			: Configure the capture, the timer stays stopped until ICP_vidStart. One count lasts
+						  prescaler / F_CPU (1 us with TIM1_NO_PRESCALER @ 1 MHz, 65 ms between overflows).
+* Parameters[in]		: [u8Edge] Range (ICP_u8EDGE_FALLING, ICP_u8EDGE_RISING, ICP_u8EDGE_BOTH)
+						  [u8Prescaler] Range (TIM1_NO_PRESCALER, TIM1_8_PRESCALER, TIM1_64_PRESCALER,
+						  TIM1_256_PRESCALER, TIM1_1024_PRESCALER)
+						  [bNoiseCanceler] TRUE: an edge must be stable for 4 CPU cycles (ICNC1), delays the
+						  capture by 4 cycles
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on invalid parameters
+*
+**************************************************************************************************************/
+extern STD_ERR_T ICP_eInit(uint8 u8Edge, uint8 u8Prescaler, boolean bNoiseCanceler)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+
+	if ((u8Edge <= ICP_u8EDGE_BOTH) && (u8Prescaler >= TIM1_NO_PRESCALER) &&
+		(u8Prescaler <= TIM1_1024_PRESCALER)){
+		ICP_vidStop();
+		u8IcpEdgeMode = u8Edge;
+		u8IcpPrescalerId = u8Prescaler;
+		/* normal mode (WGM13:12 = 0), CS12:0 = prescaler ID, the both edges mode starts on a rising edge */
+		u8IcpTccr1b = u8Prescaler;
+		if (u8Edge != ICP_u8EDGE_FALLING){
+			u8IcpTccr1b |= (1<<ICES1);
+		}
+		if (bNoiseCanceler == TRUE){
+			u8IcpTccr1b |= (1<<ICNC1);
+		}
+		errRetVal = STD_ERR_OK;
+	}
+	return errRetVal;
+}
+
+/*************************************************************************************************************
+* Function				: ICP_vidStart
+* Description			: Clear the ring and the measures, set ICP1 as input and start Timer 1 from 0.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void ICP_vidStart(void)
+{
+	uint8 u8Sreg;
+
+	if (u8IcpPrescalerId != TIM1_STOP){
+		DIO_vidSetPinMode(DIO_PB0, INPUT);
+		u8Sreg = SREG;
+		cli();
+		TCCR1B = 0;
+		/* normal mode, OC1A/OC1B disconnected */
+		TCCR1A = 0;
+		TCNT1 = 0;
+		u16IcpOverflows = 0U;
+		u8IcpHead = 0U;
+		u8IcpTail = 0U;
+		u16IcpOverruns = 0U;
+		u8IcpValid = 0U;
+		TIM_vidT1AttachOvfInterrupt(ICP_vidOnOverflow);
+		/* clear the stale flags */
+		TIFR = (1<<ICF1) | (1<<TOV1);
+		SET_BIT(TIMSK, TICIE1);
+		SET_BIT(TIMSK, TOIE1);
+		TCCR1B = u8IcpTccr1b;
+		SREG = u8Sreg;
+	}
+}
+
+/*************************************************************************************************************
+* Function				: ICP_vidStop
+* Description			: Stop Timer 1 and the capture interrupts, the ring and the last measures are kept.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void ICP_vidStop(void)
+{
+	TCCR1B = TIM1_STOP;
+	CLEAR_BIT(TIMSK, TICIE1);
+	CLEAR_BIT(TIMSK, TOIE1);
+	TIM_vidT1AttachOvfInterrupt(NULL);
+}
+
+/*************************************************************************************************************
+* Function				: ICP_u8Read
+* Description			: Pop time stamps from the ring, oldest first.
+* Parameters[in]		: [u8MaxCaptures] size of pstrCaptures
+* Parameters[in/out]	: [pstrCaptures] receives the time stamps
+* Parameters[out]		: uint8 number of time stamps copied
+*
+**************************************************************************************************************/
+extern uint8 ICP_u8Read(ICP_tstrCapture *pstrCaptures, uint8 u8MaxCaptures)
+{
+	uint8 u8Count = 0U;
+	uint8 u8Tail = u8IcpTail;
+
+	/* single consumer: only the head is shared with the ISR, one byte read */
+	while ((u8Count < u8MaxCaptures) && (u8Tail != u8IcpHead)){
+		pstrCaptures[u8Count] = astrIcpRing[u8Tail & ICP_u8RING_MASK];
+		u8Tail++;
+		u8Count++;
+	}
+	u8IcpTail = u8Tail;
+	return u8Count;
+}
+
+/*************************************************************************************************************
+* Function				: ICP_u32GetTicks
+* Description			: Current Timer 1 count extended to 32 bits, same time base as the time stamps.
+						  May be called from an ISR.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint32 Timer 1 counts since ICP_vidStart (wraps)
+*
+**************************************************************************************************************/
+extern uint32 ICP_u32GetTicks(void)
+{
+	uint8 u8Sreg = SREG;
+	uint16 u16Overflows;
+	uint16 u16Count;
+
+	cli();
+	u16Overflows = u16IcpOverflows;
+	u16Count = TCNT1;
+	/* overflow not counted yet by its ISR */
+	if ((TIFR & (1<<TOV1)) && (u16Count < 0x8000U)){
+		u16Overflows++;
+	}
+	SREG = u8Sreg;
+	return ((uint32)u16Overflows << 16) | u16Count;
+}
+
+/*************************************************************************************************************
+* Function				: ICP_eGetPeriod
+* Description			: Time between the last two captured edges of the same direction (rising edges in
+						  ICP_u8EDGE_BOTH mode).
+* Parameters[in]		: None
+* Parameters[in/out]	: [pu32Ticks] receives the period in Timer 1 counts
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if no period was measured yet or the signal stopped (no edge
+						  for more than 2 periods)
+*
+**************************************************************************************************************/
+extern STD_ERR_T ICP_eGetPeriod(uint32 *pu32Ticks)
+{
+	uint32 u32High;
+	uint8 u8Valid;
+
+	return ICP_eGetMeasures(pu32Ticks, &u32High, &u8Valid);
+}
+
+/*************************************************************************************************************
+* Function				: ICP_eGetPeriodUs
+* Description			: ICP_eGetPeriod in micro seconds.
+* Parameters[in]		: None
+* Parameters[in/out]	: [pu32Us] receives the period in us
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK as ICP_eGetPeriod
+*
+**************************************************************************************************************/
+extern STD_ERR_T ICP_eGetPeriodUs(uint32 *pu32Us)
+{
+	STD_ERR_T errRetVal;
+	uint32 u32Ticks;
+	uint16 u16Prescaler;
+
+	errRetVal = ICP_eGetPeriod(&u32Ticks);
+	if (errRetVal == STD_ERR_OK){
+		u16Prescaler = au16IcpPrescaler[u8IcpPrescalerId - 1U];
+		if (u32Ticks <= (0xFFFFFFFFUL / u16Prescaler)){
+			*pu32Us = (u32Ticks * u16Prescaler) / ICP_u32CPU_MHZ;
+		} else {
+			*pu32Us = (u32Ticks / ICP_u32CPU_MHZ) * u16Prescaler;
+		}
+	}
+	return errRetVal;
+}
+
+/*************************************************************************************************************
+* Function				: ICP_eGetFrequency
+* Description			: Frequency of the signal in milli Hertz (1 Hz = 1000) from the last period, exact for
+						  periods under 4294967 counts.
+* Parameters[in]		: None
+* Parameters[in/out]	: [pu32MilliHz] receives the frequency in mHz
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK as ICP_eGetPeriod
+*
+**************************************************************************************************************/
+extern STD_ERR_T ICP_eGetFrequency(uint32 *pu32MilliHz)
+{
+	STD_ERR_T errRetVal;
+	uint32 u32Ticks;
+	uint32 u32Clk;
+	uint32 u32Rem;
+
+	errRetVal = ICP_eGetPeriod(&u32Ticks);
+	if (errRetVal == STD_ERR_OK){
+		/* Timer 1 clock / period, the remainder gives the 3 decimals */
+		u32Clk = F_CPU / au16IcpPrescaler[u8IcpPrescalerId - 1U];
+		u32Rem = u32Clk % u32Ticks;
+		*pu32MilliHz = (u32Clk / u32Ticks) * 1000UL;
+		if (u32Ticks <= (0xFFFFFFFFUL / 1000UL)){
+			*pu32MilliHz += (u32Rem * 1000UL) / u32Ticks;
+		} else {
+			*pu32MilliHz += u32Rem / (u32Ticks / 1000UL);
+		}
+	}
+	return errRetVal;
+}
+
+/*************************************************************************************************************
+* Function				: ICP_eGetDuty
+* Description			: High time of the last period in per mille, ICP_u8EDGE_BOTH mode only.
+* Parameters[in]		: None
+* Parameters[in/out]	: [pu16PerMille] receives the duty cycle, Range (0 - 1000)
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK in single edge mode or as ICP_eGetPeriod
+*
+**************************************************************************************************************/
+extern STD_ERR_T ICP_eGetDuty(uint16 *pu16PerMille)
+{
+	STD_ERR_T errRetVal;
+	uint32 u32Period;
+	uint32 u32High;
+	uint8 u8Valid;
+
+	errRetVal = ICP_eGetMeasures(&u32Period, &u32High, &u8Valid);
+	if ((errRetVal == STD_ERR_OK) && ((u8Valid & ICP_u8VALID_HIGH) != 0U)){
+		if (u32High >= u32Period){
+			/* the falling edge was missed */
+			*pu16PerMille = 1000U;
+		} else {
+			/* keep high * 1000 in 32 bits */
+			while (u32High > (0xFFFFFFFFUL / 1000UL)){
+				u32High >>= 1;
+				u32Period >>= 1;
+			}
+			*pu16PerMille = (uint16)((u32High * 1000UL) / u32Period);
+		}
+	} else {
+		errRetVal = STD_ERR_NOK;
+	}
+	return errRetVal;
+}
+
+/*************************************************************************************************************
+* Function				: ICP_u16GetOverruns
+* Description			: Time stamps lost since ICP_vidStart because the ring was full. The period and duty
+						  measures keep running.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 lost time stamps (saturates)
+*
+**************************************************************************************************************/
+extern uint16 ICP_u16GetOverruns(void)
+{
+	uint16 u16RetVal;
+	uint8 u8Sreg = SREG;
+
+	cli();
+	u16RetVal = u16IcpOverruns;
+	SREG = u8Sreg;
+	return u16RetVal;
+}
@@ -0,0 +1,159 @@
+/*! \file ICP_inputCapture.h \brief Timer 1 input capture: time stamps, period, frequency and duty cycle. */
+/*************************************************************************************************************
+*
+* File Name		: 'ICP_inputCapture.h'
+* Title			: Timer 1 input capture: time stamps, period, frequency and duty cycle
+* Version		: 1.0
+* Target MCU	: Atmel AVR Series
+*
+*  The edges on ICP1 (PB0) latch TCNT1 in ICR1 in hardware, so the time stamps do not depend on the
+*  interrupt latency. The capture ISR extends ICR1 to 32 bits with the Timer 1 overflow count, pushes the
+*  stamp in a ring read by the application and keeps the last period and high time:
+*
+*	ICP1 edge --> ICR1 --> TIMER1_CAPT_vect --> + overflows --> ring --> ICP_u8Read
+*	                                                         --> period / high time --> ICP_eGet...
+*
+*  Timer 1 runs in normal mode (TOP = 0xFFFF) and is taken from the PWM outputs while the capture runs.
+*
+*************************************************************************************************************/
+#ifndef ICP_INPUTCAPTURE_H_
+#define ICP_INPUTCAPTURE_H_
+
+
+/*---------------------------------------------------- INCLUDES --------------------------------------------*/
+
+#include "MCU.h"
+#include "Std_Types.h"
+#include "TIM_timers.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+/* captured edges */
+#define ICP_u8EDGE_FALLING		0U
+#define ICP_u8EDGE_RISING		1U
+#define ICP_u8EDGE_BOTH			2U		/* needed for the duty cycle, ICES1 is toggled after every capture */
+
+/* time stamps ring, power of 2 <= 128 */
+#define ICP_u8RING_SIZE			16U
+
+/*------------------------------------------ Type Definitions  --------------------------------------------*/
+
+typedef struct{
+	uint32 u32Ticks;		/* Timer 1 counts since ICP_vidStart (wraps) */
+	uint8 u8Edge;			/* ICP_u8EDGE_FALLING or ICP_u8EDGE_RISING */
+}ICP_tstrCapture;
+
+/*--------------------------------------------- FUNCTION Definitions ----------------------------------------*/
+
+/*************************************************************************************************************
+* Function				: ICP_eInit
+* Description			: Configure the capture, the timer stays stopped until ICP_vidStart. One count lasts
+						  prescaler / F_CPU (1 us with TIM1_NO_PRESCALER @ 1 MHz, 65 ms between overflows).
+* Parameters[in]		: [u8Edge] Range (ICP_u8EDGE_FALLING, ICP_u8EDGE_RISING, ICP_u8EDGE_BOTH)
+						  [u8Prescaler] Range (TIM1_NO_PRESCALER, TIM1_8_PRESCALER, TIM1_64_PRESCALER,
+						  TIM1_256_PRESCALER, TIM1_1024_PRESCALER)
+						  [bNoiseCanceler] TRUE: an edge must be stable for 4 CPU cycles (ICNC1), delays the
+						  capture by 4 cycles
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on invalid parameters
+*
+**************************************************************************************************************/
+extern STD_ERR_T ICP_eInit(uint8 u8Edge, uint8 u8Prescaler, boolean bNoiseCanceler);
+
+/*************************************************************************************************************
+* Function				: ICP_vidStart
+* Description			: Clear the ring and the measures, set ICP1 as input and start Timer 1 from 0.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void ICP_vidStart(void);
+
+/*************************************************************************************************************
+* Function				: ICP_vidStop
+* Description			: Stop Timer 1 and the capture interrupts, the ring and the last measures are kept.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void ICP_vidStop(void);
+
+/*************************************************************************************************************
+* Function				: ICP_u8Read
+* Description			: Pop time stamps from the ring, oldest first.
+* Parameters[in]		: [u8MaxCaptures] size of pstrCaptures
+* Parameters[in/out]	: [pstrCaptures] receives the time stamps
+* Parameters[out]		: uint8 number of time stamps copied
+*
+**************************************************************************************************************/
+extern uint8 ICP_u8Read(ICP_tstrCapture *pstrCaptures, uint8 u8MaxCaptures);
+
+/*************************************************************************************************************
+* Function				: ICP_u32GetTicks
+* Description			: Current Timer 1 count extended to 32 bits, same time base as the time stamps.
+						  May be called from an ISR.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint32 Timer 1 counts since ICP_vidStart (wraps)
+*
+**************************************************************************************************************/
+extern uint32 ICP_u32GetTicks(void);
+
+/*************************************************************************************************************
+* Function				: ICP_eGetPeriod
+* Description			: Time between the last two captured edges of the same direction (rising edges in
+						  ICP_u8EDGE_BOTH mode).
+* Parameters[in]		: None
+* Parameters[in/out]	: [pu32Ticks] receives the period in Timer 1 counts
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if no period was measured yet or the signal stopped (no edge
+						  for more than 2 periods)
+*
+**************************************************************************************************************/
+extern STD_ERR_T ICP_eGetPeriod(uint32 *pu32Ticks);
+
+/*************************************************************************************************************
+* Function				: ICP_eGetPeriodUs
+* Description			: ICP_eGetPeriod in micro seconds.
+* Parameters[in]		: None
+* Parameters[in/out]	: [pu32Us] receives the period in us
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK as ICP_eGetPeriod
+*
+**************************************************************************************************************/
+extern STD_ERR_T ICP_eGetPeriodUs(uint32 *pu32Us);
+
+/*************************************************************************************************************
+* Function				: ICP_eGetFrequency
+* Description			: Frequency of the signal in milli Hertz (1 Hz = 1000) from the last period, exact for
+						  periods under 4294967 counts.
+* Parameters[in]		: None
+* Parameters[in/out]	: [pu32MilliHz] receives the frequency in mHz
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK as ICP_eGetPeriod
+*
+**************************************************************************************************************/
+extern STD_ERR_T ICP_eGetFrequency(uint32 *pu32MilliHz);
+
+/*************************************************************************************************************
+* Function				: ICP_eGetDuty
+* Description			: High time of the last period in per mille, ICP_u8EDGE_BOTH mode only.
+* Parameters[in]		: None
+* Parameters[in/out]	: [pu16PerMille] receives the duty cycle, Range (0 - 1000)
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK in single edge mode or as ICP_eGetPeriod
+*
+**************************************************************************************************************/
+extern STD_ERR_T ICP_eGetDuty(uint16 *pu16PerMille);
+
+/*************************************************************************************************************
+* Function				: ICP_u16GetOverruns
+* Description			: Time stamps lost since ICP_vidStart because the ring was full. The period and duty
+						  measures keep running.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 lost time stamps (saturates)
+*
+**************************************************************************************************************/
+extern uint16 ICP_u16GetOverruns(void);
+
+
+#endif /* ICP_INPUTCAPTURE_H_ */
@@ -0,0 +1,356 @@
+/*! \file RTC_realTimeClock.c \brief Real time clock and calendar on the asynchronous Timer 2. */
+/************************************************************************************************************
+*
+* File Name		: 'RTC_realTimeClock.c'
+* Title			: Real time clock and calendar on the asynchronous Timer 2
+* Version		: 1.0
+* Target MCU	: Atmel AVR Series
+*
+************************************************************************************************************/
+
+
+/*------------------------------------------------- INCLUDES ----------------------------------------------*/
+#include "Common_Macros.h"
+#include "TIM_timers.h"
+#include "OS/WDG_supervisor.h"
+
+#include "RTC_realTimeClock.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+/* 32768 Hz / 128 / 256 = 1 overflow per second */
+#define RTC_u8PRESCALER_ID		TIM2_128_PRESCALER
+
+/* update busy flags of the registers written in the asynchronous domain */
+#define RTC_u8ASSR_BUSY			(uint8)((1<<TCN2UB) | (1<<OCR2UB) | (1<<TCR2UB))
+
+#define RTC_u32SEC_PER_DAY		86400UL
+#define RTC_u16SEC_PER_HOUR		3600U
+
+/* us of one Timer 2 count (1 / 256 s) times 4: 3906.25 us */
+#define RTC_u16COUNT_US_X4		15625U
+/* longest power save sleep (2 s), more means the clock was set by the alarm call back meanwhile */
+#define RTC_u16SLEEP_MAX_COUNTS	512U
+
+/* 2000-01-01 was a Saturday */
+#define RTC_u8EPOCH_WEEK_DAY	RTC_u8SATURDAY
+
+#define RTC_bIS_LEAP(YEAR)		((((YEAR) % 4U) == 0U) && ((((YEAR) % 100U) != 0U) || (((YEAR) % 400U) == 0U)))
+
+/*---------------------------------------------- Global Variables -----------------------------------------*/
+
+/* days of the months of a common year */
+static const uint8 au8RtcMonthDays[12] = {31U, 28U, 31U, 30U, 31U, 30U, 31U, 31U, 30U, 31U, 30U, 31U};
+
+/* seconds since the epoch, counted by the overflow ISR */
+static volatile uint32 u32RtcSeconds;
+
+/* one shot alarm, armed while pfvRtcAlarm is not NULL */
+static uint32 u32RtcAlarm;
+static volatile RTC_tpfvidAlarmClbk pfvRtcAlarm;
+
+/*-------------------------------------------- FUNCTION Definitions ---------------------------------------*/
+
+static uint8 RTC_u8MonthDays(uint16 u16Year, uint8 u8Month)
+{
+	uint8 u8Days = au8RtcMonthDays[u8Month - 1U];
+
+	if ((u8Month == 2U) && RTC_bIS_LEAP(u16Year)){
+		u8Days++;
+	}
+	return u8Days;
+}
+
+/* wait until the asynchronous registers took the last written values (up to 2 TOSC1 cycles, 61 us) */
+static void RTC_vidWaitUpdate(void)
+{
+	while ((ASSR & RTC_u8ASSR_BUSY) != 0U){
+	}
+}
+
+/* time of the clock in Timer 2 counts (1 / 256 s), interrupts disabled and TCNT2 readable (one TOSC1 cycle
+   after a wake up) */
+static uint32 RTC_u32GetCounts(void)
+{
+	uint32 u32Seconds = u32RtcSeconds;
+	uint8 u8Count = TCNT2;
+
+	if ((TIFR & (1<<TOV2)) != 0U){
+		/* overflow not served yet, TCNT2 may have been read before or after it */
+		u8Count = TCNT2;
+		u32Seconds++;
+	}
+	return (u32Seconds << 8) | u8Count;
+}
+
+/*************************************************************************************************************
+* Function				: RTC_eInit
+* Description			: Switch Timer 2 to the 32.768 kHz crystal and start the 1 s overflow, the time starts
+						  at 2000-01-01 00:00:00. The crystal needs about 1 s to stabilize after power up.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if Timer 2 is used by SMP_adcSampler
+*
+**************************************************************************************************************/
+extern STD_ERR_T RTC_eInit(void)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint8 u8Sreg = SREG;
+
+	cli();
+	if ((TIMSK & (1<<OCIE2)) == 0U){
+		/* datasheet sequence: interrupts off, clock source, registers, wait for the update, clear the flags */
+		TIMSK &= (uint8)~((1<<TOIE2) | (1<<OCIE2));
+		ASSR |= (1<<AS2);
+		TCNT2 = 0U;
+		OCR2 = 0U;
+		TCCR2 = RTC_u8PRESCALER_ID;
+		RTC_vidWaitUpdate();
+		TIFR = (1<<TOV2) | (1<<OCF2);
+		u32RtcSeconds = 0UL;
+		pfvRtcAlarm = NULL;
+		TIMSK |= (1<<TOIE2);
+		errRetVal = STD_ERR_OK;
+	}
+	SREG = u8Sreg;
+	return errRetVal;
+}
+
+/*************************************************************************************************************
+* Function				: RTC_u32DateTimeToSeconds
+* Description			: Convert a date and time to seconds since 2000-01-01 00:00:00.
+* Parameters[in]		: [pstrDateTime] valid date and time
+* Parameters[in/out]	: None
+* Parameters[out]		: uint32 seconds
+*
+**************************************************************************************************************/
+extern uint32 RTC_u32DateTimeToSeconds(const RTC_tstrDateTime *pstrDateTime)
+{
+	uint16 u16Years = pstrDateTime->u16Year - RTC_u16EPOCH_YEAR;
+	uint32 u32Days;
+	uint8 u8Month;
+
+	/* whole years, the leap years before u16Year counted with 2000 as the first one */
+	u32Days = ((uint32)u16Years * 365UL) + ((u16Years + 3U) / 4U) - ((u16Years + 99U) / 100U) + ((u16Years + 399U) / 400U);
+	for (u8Month = 1U; u8Month < pstrDateTime->u8Month; u8Month++){
+		u32Days += RTC_u8MonthDays(pstrDateTime->u16Year, u8Month);
+	}
+	u32Days += (uint32)pstrDateTime->u8Day - 1UL;
+
+	return (u32Days * RTC_u32SEC_PER_DAY) + ((uint32)pstrDateTime->u8Hour * RTC_u16SEC_PER_HOUR) +
+		((uint16)pstrDateTime->u8Minute * 60U) + pstrDateTime->u8Second;
+}
+
+/*************************************************************************************************************
+* Function				: RTC_vidSecondsToDateTime
+* Description			: Convert seconds since 2000-01-01 00:00:00 to a date, a time and a week day.
+* Parameters[in]		: [u32Seconds] seconds
+* Parameters[in/out]	: [pstrDateTime] receives the date and time
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void RTC_vidSecondsToDateTime(uint32 u32Seconds, RTC_tstrDateTime *pstrDateTime)
+{
+	uint16 u16Days = (uint16)(u32Seconds / RTC_u32SEC_PER_DAY);
+	uint32 u32DaySeconds = u32Seconds % RTC_u32SEC_PER_DAY;
+	uint16 u16Year = RTC_u16EPOCH_YEAR;
+	uint16 u16YearDays;
+	uint8 u8Month = 1U;
+	uint8 u8MonthDays;
+
+	pstrDateTime->u8Hour = (uint8)(u32DaySeconds / RTC_u16SEC_PER_HOUR);
+	u32DaySeconds %= RTC_u16SEC_PER_HOUR;
+	pstrDateTime->u8Minute = (uint8)(u32DaySeconds / 60U);
+	pstrDateTime->u8Second = (uint8)(u32DaySeconds % 60U);
+	pstrDateTime->u8WeekDay = (uint8)((u16Days + RTC_u8EPOCH_WEEK_DAY) % 7U);
+
+	u16YearDays = RTC_bIS_LEAP(u16Year) ? 366U : 365U;
+	while (u16Days >= u16YearDays){
+		u16Days -= u16YearDays;
+		u16Year++;
+		u16YearDays = RTC_bIS_LEAP(u16Year) ? 366U : 365U;
+	}
+	u8MonthDays = RTC_u8MonthDays(u16Year, u8Month);
+	while (u16Days >= u8MonthDays){
+		u16Days -= u8MonthDays;
+		u8Month++;
+		u8MonthDays = RTC_u8MonthDays(u16Year, u8Month);
+	}
+	pstrDateTime->u16Year = u16Year;
+	pstrDateTime->u8Month = u8Month;
+	pstrDateTime->u8Day = (uint8)(u16Days + 1U);
+}
+
+/*************************************************************************************************************
+* Function				: RTC_eSetDateTime
+* Description			: Set the clock, the second in progress restarts from 0.
+* Parameters[in]		: [pstrDateTime] new date and time, u8WeekDay is ignored
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on an invalid date or time
+*
+**************************************************************************************************************/
+extern STD_ERR_T RTC_eSetDateTime(const RTC_tstrDateTime *pstrDateTime)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint32 u32Seconds;
+	uint8 u8Sreg;
+
+	if ((pstrDateTime != NULL) &&
+		(pstrDateTime->u16Year >= RTC_u16EPOCH_YEAR) && (pstrDateTime->u16Year <= RTC_u16LAST_YEAR) &&
+		(pstrDateTime->u8Month >= 1U) && (pstrDateTime->u8Month <= 12U) && (pstrDateTime->u8Day >= 1U) &&
+		(pstrDateTime->u8Day <= RTC_u8MonthDays(pstrDateTime->u16Year, pstrDateTime->u8Month)) &&
+		(pstrDateTime->u8Hour < 24U) && (pstrDateTime->u8Minute < 60U) && (pstrDateTime->u8Second < 60U)){
+		u32Seconds = RTC_u32DateTimeToSeconds(pstrDateTime);
+		u8Sreg = SREG;
+		cli();
+		TCNT2 = 0U;
+		RTC_vidWaitUpdate();
+		TIFR = (1<<TOV2);
+		u32RtcSeconds = u32Seconds;
+		SREG = u8Sreg;
+		errRetVal = STD_ERR_OK;
+	}
+	return errRetVal;
+}
+
+/*************************************************************************************************************
+* Function				: RTC_u32GetSeconds
+* Description			: Seconds since 2000-01-01 00:00:00, a cheap time stamp. May be called from an ISR.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint32 seconds
+*
+**************************************************************************************************************/
+extern uint32 RTC_u32GetSeconds(void)
+{
+	uint32 u32Seconds;
+	uint8 u8Sreg = SREG;
+
+	cli();
+	u32Seconds = u32RtcSeconds;
+	SREG = u8Sreg;
+	return u32Seconds;
+}
+
+/*************************************************************************************************************
+* Function				: RTC_vidGetDateTime
+* Description			: Read the calendar.
+* Parameters[in]		: None
+* Parameters[in/out]	: [pstrDateTime] receives the date, the time and the week day
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void RTC_vidGetDateTime(RTC_tstrDateTime *pstrDateTime)
+{
+	RTC_vidSecondsToDateTime(RTC_u32GetSeconds(), pstrDateTime);
+}
+
+/*************************************************************************************************************
+* Function				: RTC_eSetAlarm
+* Description			: Call pfvClbk once from the Timer 2 overflow ISR when the clock reaches u32Seconds,
+						  replaces a pending alarm. The ISR wakes the CPU from power save. An alarm passed by
+						  RTC_eSetDateTime fires on the next second.
+* Parameters[in]		: [u32Seconds] alarm time in seconds since 2000-01-01 00:00:00
+						  [pfvClbk] call back, keep it short
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if pfvClbk is NULL or the time already passed
+*
+**************************************************************************************************************/
+extern STD_ERR_T RTC_eSetAlarm(uint32 u32Seconds, RTC_tpfvidAlarmClbk pfvClbk)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint8 u8Sreg = SREG;
+
+	cli();
+	if ((pfvClbk != NULL) && (u32Seconds > u32RtcSeconds)){
+		u32RtcAlarm = u32Seconds;
+		pfvRtcAlarm = pfvClbk;
+		errRetVal = STD_ERR_OK;
+	}
+	SREG = u8Sreg;
+	return errRetVal;
+}
+
+/*************************************************************************************************************
+* Function				: RTC_vidCancelAlarm
+* Description			: Cancel the pending alarm, if any.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void RTC_vidCancelAlarm(void)
+{
+	uint8 u8Sreg = SREG;
+
+	/* 2-byte store, the overflow ISR must not see half of it */
+	cli();
+	pfvRtcAlarm = NULL;
+	SREG = u8Sreg;
+}
+
+/*************************************************************************************************************
+* Function				: RTC_ePowerSave
+* Description			: Sleep in power save mode until the next interrupt (at the latest the next second).
+						  Waits until the interrupt logic of Timer 2 is ready to wake the CPU again. The
+						  1 ms tick, the UART and the SPI are stopped while asleep: drain the logger first.
+						  The watchdog supervisor is paused during the sleep (SCH_SUPERVISOR). The time slept is
+						  added to the milli seconds count of Timer 0 (within one 3.9 ms count of Timer 2).
+						  Same contract as MCU_eSleep: call inside exactly one MCU_vidDisableInterrupts section.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the clock is not started or as MCU_eSleep
+*
+**************************************************************************************************************/
+extern STD_ERR_T RTC_ePowerSave(void)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint32 u32Counts;
+
+	if ((ASSR & (1<<AS2)) != 0U){
+		/* the overflow interrupt logic needs one TOSC1 cycle to reset after a wake up, sleeping earlier
+		   would miss the next overflow: a dummy write to the unused OCR2 takes that long to be latched */
+		OCR2 = 0U;
+		RTC_vidWaitUpdate();
+		u32Counts = RTC_u32GetCounts();
+#if (SCH_SUPERVISOR == 1)
+		/* the watchdog would fire before the next Timer 0 tick */
+		WDG_vidPause();
+#endif
+		errRetVal = MCU_eSleep(SLEEP_MODE_PWR_SAVE);
+		if (errRetVal == STD_ERR_OK){
+			/* TCNT2 read right after the wake up may be wrong: wait one TOSC1 cycle the same way */
+			OCR2 = 0U;
+			RTC_vidWaitUpdate();
+			/* Timer 0 was stopped, the scheduler, the software timers and the watchdog windows follow */
+			u32Counts = RTC_u32GetCounts() - u32Counts;
+			if (u32Counts <= RTC_u16SLEEP_MAX_COUNTS){
+				TIM_vidT0AddHaltedUs((u32Counts * RTC_u16COUNT_US_X4) / 4UL);
+			}
+		}
+#if (SCH_SUPERVISOR == 1)
+		WDG_vidResume();
+#endif
+	}
+	return errRetVal;
+}
+
+/******************************************************************************
+Function			: TIMER2_OVF_vect ISR routine
+Description			: Timer2 overflow interrupt service routine, once per second.
+Parameters[in]		: None
+Parameters[in/out]	: None
+Parameters[out]		: None
+********************************************************************************/
+ISR(TIMER2_OVF_vect)
+{
+	RTC_tpfvidAlarmClbk pfvClbk = pfvRtcAlarm;
+	uint32 u32Seconds = u32RtcSeconds + 1UL;
+
+	u32RtcSeconds = u32Seconds;
+	/* RTC_eSetDateTime may have moved the clock past the alarm */
+	if ((pfvClbk != NULL) && (u32Seconds >= u32RtcAlarm)){
+		pfvRtcAlarm = NULL;
+		pfvClbk();
+	}
+}
@@ -0,0 +1,153 @@
+/*! \file RTC_realTimeClock.h \brief Real time clock and calendar on the asynchronous Timer 2. */
+/*************************************************************************************************************
+*
+* File Name		: 'RTC_realTimeClock.h'
+* Title			: Real time clock and calendar on the asynchronous Timer 2
+* Version		: 1.0
+* Target MCU	: Atmel AVR Series
+*
+*  Timer 2 is clocked from a 32.768 kHz crystal on TOSC1/TOSC2 (AS2) with a /128 prescaler, it overflows
+*  once per second whatever the CPU clock and keeps running in power save mode where Timer 0 (the 1 ms tick)
+*  is stopped. The overflow ISR only counts the seconds since 2000-01-01 00:00:00 and checks the alarm, the
+*  calendar is computed when it is read:
+*
+*	TOSC 32768 Hz --> /128 --> TCNT2 overflow (1 s) --> TIMER2_OVF_vect --> seconds ++ --> alarm call back
+*
+*  Timer 2 is shared with SMP_adcSampler (CTC trigger), only one of them can own it: RTC_eInit fails while
+*  the sampler runs and SMP_eInit fails once the clock is started. On the ATmega8 the crystal pins are PB6
+*  and PB7, the CPU must then run from the internal RC oscillator.
+*
+*************************************************************************************************************/
+#ifndef RTC_REALTIMECLOCK_H_
+#define RTC_REALTIMECLOCK_H_
+
+
+/*---------------------------------------------------- INCLUDES --------------------------------------------*/
+
+#include "MCU.h"
+#include "Std_Types.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+/* calendar range: RTC_u32GetSeconds counts from the first year and wraps after 136 years */
+#define RTC_u16EPOCH_YEAR		2000U
+#define RTC_u16LAST_YEAR		2135U
+
+/* week days of RTC_tstrDateTime.u8WeekDay */
+#define RTC_u8SUNDAY			0U
+#define RTC_u8MONDAY			1U
+#define RTC_u8TUESDAY			2U
+#define RTC_u8WEDNESDAY			3U
+#define RTC_u8THURSDAY			4U
+#define RTC_u8FRIDAY			5U
+#define RTC_u8SATURDAY			6U
+
+/*------------------------------------------ Type Definitions  --------------------------------------------*/
+
+typedef struct{
+	uint16 u16Year;			/* RTC_u16EPOCH_YEAR .. RTC_u16LAST_YEAR */
+	uint8 u8Month;			/* 1 .. 12 */
+	uint8 u8Day;			/* 1 .. 31 */
+	uint8 u8Hour;			/* 0 .. 23 */
+	uint8 u8Minute;			/* 0 .. 59 */
+	uint8 u8Second;			/* 0 .. 59 */
+	uint8 u8WeekDay;		/* RTC_u8SUNDAY .. RTC_u8SATURDAY, computed, ignored by RTC_eSetDateTime */
+}RTC_tstrDateTime;
+
+typedef void (*RTC_tpfvidAlarmClbk)(void);
+
+/*--------------------------------------------- FUNCTION Definitions ----------------------------------------*/
+
+/*************************************************************************************************************
+* Function				: RTC_eInit
+* Description			: Switch Timer 2 to the 32.768 kHz crystal and start the 1 s overflow, the time starts
+						  at 2000-01-01 00:00:00. The crystal needs about 1 s to stabilize after power up.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if Timer 2 is used by SMP_adcSampler
+*
+**************************************************************************************************************/
+extern STD_ERR_T RTC_eInit(void);
+
+/*************************************************************************************************************
+* Function				: RTC_eSetDateTime
+* Description			: Set the clock, the second in progress restarts from 0.
+* Parameters[in]		: [pstrDateTime] new date and time, u8WeekDay is ignored
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on an invalid date or time
+*
+**************************************************************************************************************/
+extern STD_ERR_T RTC_eSetDateTime(const RTC_tstrDateTime *pstrDateTime);
+
+/*************************************************************************************************************
+* Function				: RTC_vidGetDateTime
+* Description			: Read the calendar.
+* Parameters[in]		: None
+* Parameters[in/out]	: [pstrDateTime] receives the date, the time and the week day
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void RTC_vidGetDateTime(RTC_tstrDateTime *pstrDateTime);
+
+/*************************************************************************************************************
+* Function				: RTC_u32GetSeconds
+* Description			: Seconds since 2000-01-01 00:00:00, a cheap time stamp. May be called from an ISR.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint32 seconds
+*
+**************************************************************************************************************/
+extern uint32 RTC_u32GetSeconds(void);
+
+/*************************************************************************************************************
+* Function				: RTC_u32DateTimeToSeconds / RTC_vidSecondsToDateTime
+* Description			: Convert between the calendar and the seconds since 2000-01-01 00:00:00 (e.g. an alarm
+						  10 minutes from now is RTC_u32GetSeconds() + 600).
+* Parameters[in]		: [pstrDateTime] valid date and time / [u32Seconds] seconds
+* Parameters[in/out]	: [pstrDateTime] receives the date and time
+* Parameters[out]		: uint32 seconds / None
+*
+**************************************************************************************************************/
+extern uint32 RTC_u32DateTimeToSeconds(const RTC_tstrDateTime *pstrDateTime);
+extern void RTC_vidSecondsToDateTime(uint32 u32Seconds, RTC_tstrDateTime *pstrDateTime);
+
+/*************************************************************************************************************
+* Function				: RTC_eSetAlarm
+* Description			: Call pfvClbk once from the Timer 2 overflow ISR when the clock reaches u32Seconds,
+						  replaces a pending alarm. The ISR wakes the CPU from power save. An alarm passed by
+						  RTC_eSetDateTime fires on the next second.
+* Parameters[in]		: [u32Seconds] alarm time in seconds since 2000-01-01 00:00:00
+						  [pfvClbk] call back, keep it short
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if pfvClbk is NULL or the time already passed
+*
+**************************************************************************************************************/
+extern STD_ERR_T RTC_eSetAlarm(uint32 u32Seconds, RTC_tpfvidAlarmClbk pfvClbk);
+
+/*************************************************************************************************************
+* Function				: RTC_vidCancelAlarm
+* Description			: Cancel the pending alarm, if any.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void RTC_vidCancelAlarm(void);
+
+/*************************************************************************************************************
+* Function				: RTC_ePowerSave
+* Description			: Sleep in power save mode until the next interrupt (at the latest the next second).
+						  Waits until the interrupt logic of Timer 2 is ready to wake the CPU again. The
+						  1 ms tick, the UART and the SPI are stopped while asleep: drain the logger first.
+						  The watchdog supervisor is paused during the sleep (SCH_SUPERVISOR). The time slept is
+						  added to the milli seconds count of Timer 0 (within one 3.9 ms count of Timer 2).
+						  Same contract as MCU_eSleep: call inside exactly one MCU_vidDisableInterrupts section.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the clock is not started or as MCU_eSleep
+*
+**************************************************************************************************************/
+extern STD_ERR_T RTC_ePowerSave(void);
+
+
+#endif /* RTC_REALTIMECLOCK_H_ */
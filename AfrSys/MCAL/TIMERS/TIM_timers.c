@@ -92,22 +92,33 @@ WGM13	WGM12(CTC1)	|	WGM11(PWM11)	WGM10(PWM10)|				Mode					|	  TOP	 |
 */
 
 		
-#define TIM1_VAL_Normal				TCCR1B |= (0<<WGM13) | (0<<WGM12);\
-									TCCR1A |= (0<<WGM11) | (0<<WGM10)
-#define TIM1_VAL_PWM_Ph_8_BIT
-#define TIM1_VAL_PWM_Ph_9_BIT
-#define TIM1_VAL_PWM_Ph_10_BIT
-#define TIM1_VAL_CTC_TOP_OCR1A
-#define TIM1_VAL_FAST_PWM_8_BIT
-#define TIM1_VAL_FAST_PWM_9_BIT
-#define TIM1_VAL_FAST_PWM_10_BIT
-#define TIM1_VAL_PWM_Ph_Freq_TOP_ICR1
-#define TIM1_VAL_PWM_Ph_Freq_TOP_OCR1A
-#define TIM1_VAL_PWM_Ph_TOP_ICR1
-#define TIM1_VAL_PWM_Ph_TOP_OCR1A
-#define TIM1_VAL_CTC_TOP_ICR1
-#define TIM1_VAL_FAST_PWM_TOP_ICR1
-#define TIM1_VAL_FAST_PWM_TOP_OCR1A
+/* WGM13:0 of each mode, WGM11:10 go to TCCR1A bits 1:0 and WGM13:12 to TCCR1B bits 4:3 */
+#define TIM1_VAL_Normal					(uint8)0
+#define TIM1_VAL_PWM_Ph_8_BIT			(uint8)1
+#define TIM1_VAL_PWM_Ph_9_BIT			(uint8)2
+#define TIM1_VAL_PWM_Ph_10_BIT			(uint8)3
+#define TIM1_VAL_CTC_TOP_OCR1A			(uint8)4
+#define TIM1_VAL_FAST_PWM_8_BIT			(uint8)5
+#define TIM1_VAL_FAST_PWM_9_BIT			(uint8)6
+#define TIM1_VAL_FAST_PWM_10_BIT		(uint8)7
+#define TIM1_VAL_PWM_Ph_Freq_TOP_ICR1	(uint8)8
+#define TIM1_VAL_PWM_Ph_Freq_TOP_OCR1A	(uint8)9
+#define TIM1_VAL_PWM_Ph_TOP_ICR1		(uint8)10
+#define TIM1_VAL_PWM_Ph_TOP_OCR1A		(uint8)11
+#define TIM1_VAL_CTC_TOP_ICR1			(uint8)12
+#define TIM1_VAL_FAST_PWM_TOP_ICR1		(uint8)14
+#define TIM1_VAL_FAST_PWM_TOP_OCR1A		(uint8)15
+
+#define TIM1_WGM_A_MASK					((1<<WGM11)|(1<<WGM10))
+#define TIM1_WGM_B_MASK					((1<<WGM13)|(1<<WGM12))
+#define TIM1_COM_MASK					((1<<COM1A1)|(1<<COM1A0)|(1<<COM1B1)|(1<<COM1B0))
+#define TIM1_CS_MASK					((1<<CS12)|(1<<CS11)|(1<<CS10))
+
+/* number of Timer 1 modes (TIM1_Normal .. TIM1_FAST_PWM_TOP_OCR1A) and internal clock prescalers */
+#define TIM1_u8NO_OF_MODES				(uint8)15
+#define TIM1_u8NO_OF_PRESCALERS			(uint8)5
+/* smallest TOP allowed in the PWM modes (2 bits) */
+#define TIM1_u16MIN_TOP					(uint16)3
 
 
 /***********************************************************************************************************
@@ -141,8 +152,95 @@ CS12 | CS11 |CS10 |			Description											|
 
 /*------------------------------------------ Global Variables -------------------------------------------------*/
 
+/* WGM13:0 of each mode, index = TIM1_Normal .. TIM1_FAST_PWM_TOP_OCR1A */
+static const uint8 au8T1Wgm[TIM1_u8NO_OF_MODES] = {
+	TIM1_VAL_Normal, TIM1_VAL_PWM_Ph_8_BIT, TIM1_VAL_PWM_Ph_9_BIT, TIM1_VAL_PWM_Ph_10_BIT, TIM1_VAL_CTC_TOP_OCR1A,
+	TIM1_VAL_FAST_PWM_8_BIT, TIM1_VAL_FAST_PWM_9_BIT, TIM1_VAL_FAST_PWM_10_BIT, TIM1_VAL_PWM_Ph_Freq_TOP_ICR1,
+	TIM1_VAL_PWM_Ph_Freq_TOP_OCR1A, TIM1_VAL_PWM_Ph_TOP_ICR1, TIM1_VAL_PWM_Ph_TOP_OCR1A, TIM1_VAL_CTC_TOP_ICR1,
+	TIM1_VAL_FAST_PWM_TOP_ICR1, TIM1_VAL_FAST_PWM_TOP_OCR1A
+};
+/* Timer 1 division factor of each internal prescaler, index = ID - 1 */
+static const uint16 au16T1Prescaler[TIM1_u8NO_OF_PRESCALERS] = {1U, 8U, 64U, 256U, 1024U};
+
+/* ICR1 value written by the overflow ISR (ICR1 is not double buffered) */
+static volatile uint16 TIM_u16T1ShadowTop = 0;
+static volatile boolean TIM_bT1TopPending = FALSE;
+
+typedef struct{
+	TIM_tpfvidOverFlowClbk pfvClbk;
+	uint8 u8Divider;		/* ms between two calls */
+	uint8 u8Countdown;		/* ms left before the next call */
+}TIM_tstrT0Subscriber;
+
+/* Timer0 tick subscribers, called in slot order */
+static volatile TIM_tstrT0Subscriber astrT0Subscribers[TIM_u8T0_MAX_SUBSCRIBERS];
+/* slot used by TIM_vidT0AttachInterrupt */
+static uint8 TIM_u8T0AttachedSub = TIM_u8T0_INVALID_SUB;
+/* low byte of the milli seconds count at the previous subscribers dispatch */
+static uint8 TIM_u8T0LastDispatchMs = 0;
+/* longest Timer0 ISR seen, in 8 us counts */
+static volatile uint8 TIM_u8T0IsrMaxCounts = 0;
+/* return address of the last Timer0 ISR */
+static volatile uint16 TIM_u16T0InterruptedPc = 0;
+
 static uint32 TIM_u32Millis = 0; /* max value nearly equals 1 week */
-static uint32 TIM_u32OverFlowCounter = 0;
+/* stretched tick: number of 256 us counts programmed (0 = normal 1 ms tick) and the TCNT0 start value */
+static volatile uint8 TIM_u8T0StretchCounts = 0;
+static uint8 TIM_u8T0StretchStart = 0;
+/* sub milli second time left over from the stretched ticks */
+static uint16 TIM_u16T0UsFraction = 0;
+
+static TIM_tpfvidOverFlowClbk pfvOnT1OvfClbk = NULL;
+static TIM_tpfvidOverFlowClbk pfvOnT2CompClbk = NULL;
+
+/*------------------------------------------ Local Functions --------------------------------------------------*/
+
+/* advance the milli seconds count by u16Us, keeping the remainder for the next call */
+static void TIM_vidT0AddUs(uint16 u16Us)
+{
+	while (u16Us >= 1000U){
+		u16Us -= 1000U;
+		TIM_u32Millis++;
+	}
+	TIM_u16T0UsFraction += u16Us;
+	if (TIM_u16T0UsFraction >= 1000U){
+		TIM_u16T0UsFraction -= 1000U;
+		TIM_u32Millis++;
+	}
+}
+
+/* back to the 1 ms tick */
+static void TIM_vidT0RestoreTick(void)
+{
+	TIM_u8T0StretchCounts = 0;
+	TCCR0 = (1<<CS01);
+	TCNT0 = TIM_u8T0_RELOAD_VAL;
+}
+
+/* count down every subscriber by the ms elapsed since the previous dispatch and call the ones that reach 0 */
+static void TIM_vidT0DispatchSubscribers(void)
+{
+	uint8 u8Elapsed = (uint8)TIM_u32Millis - TIM_u8T0LastDispatchMs;
+	uint8 u8Sub;
+	uint8 u8Late;
+	TIM_tpfvidOverFlowClbk pfvClbk;
+
+	TIM_u8T0LastDispatchMs += u8Elapsed;
+	for (u8Sub = 0; u8Sub < TIM_u8T0_MAX_SUBSCRIBERS; u8Sub++){
+		pfvClbk = astrT0Subscribers[u8Sub].pfvClbk;
+		if (pfvClbk != NULL){
+			if (astrT0Subscribers[u8Sub].u8Countdown > u8Elapsed){
+				astrT0Subscribers[u8Sub].u8Countdown -= u8Elapsed;
+			} else {
+				/* a stretched tick may cover several periods: one call, the phase is kept */
+				u8Late = u8Elapsed - astrT0Subscribers[u8Sub].u8Countdown;
+				astrT0Subscribers[u8Sub].u8Countdown = (u8Late < astrT0Subscribers[u8Sub].u8Divider) ?
+													   (astrT0Subscribers[u8Sub].u8Divider - u8Late) : 1U;
+				pfvClbk();
+			}
+		}
+	}
+}
 
 /*---------------------------------------- FUNCTION Definitions -----------------------------------------------*/
 
@@ -155,17 +253,30 @@ Parameters[out]		: None
 ********************************************************************************/
 ISR(TIMER0_OVF_vect)
 {
-	TIM_u32OverFlowCounter++;
-	TIM_u32Millis++;
+	uint8 u8Counts;
+
+	TIM_u16T0InterruptedPc = (uint16)(uintptr_t)__builtin_return_address(0);
+
+	if (TIM_u8T0StretchCounts != 0){
+		/* end of a stretched tick */
+		TIM_vidT0AddUs((uint16)TIM_u8T0StretchCounts * TIM_u16T0_STRETCH_US_PER_COUNT);
+		TIM_vidT0RestoreTick();
+	} else {
+		TIM_u32Millis++;
+		/* re init counter, the counts done since the overflow are kept so TIM_u32GetMicros never goes back */
+		TCNT0 += TIM_u8T0_RELOAD_VAL;
+	}
 	
-	/* re init counter */
-	TCNT0 = 131;
-	if (TIM_u32OverFlowCounter % 1000 == 0){
-		TIM_u32OverFlowCounter = 0;
-		INFO("1 second passed");
+	TIM_vidT0DispatchSubscribers();
+
+	/* ISR length: counts since the overflow (since the tick restart after a stretched tick), saturated if the
+	   next overflow is already pending */
+	u8Counts = (uint8)(TCNT0 - TIM_u8T0_RELOAD_VAL);
+	if (TIFR & (1<<TOV0)){
+		u8Counts = 0xFFU;
 	}
-	if (pfvOnT0OverFlowClbk != NULL){
-		pfvOnT0OverFlowClbk();
+	if (u8Counts > TIM_u8T0IsrMaxCounts){
+		TIM_u8T0IsrMaxCounts = u8Counts;
 	}
 }
 
@@ -179,22 +290,86 @@ ISR(TIMER0_OVF_vect)
 *******************************************************************************************************************/
 extern void TIM_vidInitT0(void)
 {
-	TIM_u32OverFlowCounter = 0;
+	uint8 u8Sub;
+
 	TIM_u32Millis = 0;
+	TIM_u8T0StretchCounts = 0;
+	TIM_u16T0UsFraction = 0;
+	TIM_u8T0LastDispatchMs = 0;
+	TIM_u8T0IsrMaxCounts = 0;
 	
-	pfvOnT0OverFlowClbk = NULL;
+	for (u8Sub = 0; u8Sub < TIM_u8T0_MAX_SUBSCRIBERS; u8Sub++){
+		astrT0Subscribers[u8Sub].pfvClbk = NULL;
+	}
+	TIM_u8T0AttachedSub = TIM_u8T0_INVALID_SUB;
 
 	/* Timer0 settings: ~ 1000 ticks (1 ms) */
 	TCCR0 = (1<<CS01); // prescaler = 8
 	/* init counter */
-	TCNT0 = 131;
-	/* Timer0 Overflow Interrupt Enable */
-	TIMSK = (1<<TOIE0); 
+	TCNT0 = TIM_u8T0_RELOAD_VAL;
+	/* Timer0 Overflow Interrupt Enable, keep the other timers interrupts */
+	SET_BIT(TIMSK, TOIE0);
+}
+
+/*****************************************************************************************************************
+* Function				: TIM_u8T0Subscribe
+* Description			: Add a call back to the Timer 0 tick, called from the overflow ISR every u8DividerMs ms
+						  (once at the end of a stretched tick covering several periods).
+* Parameters[in]		: [pfvClbk] pointer the Call back routine
+						  [u8DividerMs] Range ( 1 .. 255 ) ms between two calls
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 subscriber id, TIM_u8T0_INVALID_SUB if the table is full or a parameter is invalid
+*
+*******************************************************************************************************************/
+extern uint8 TIM_u8T0Subscribe(TIM_tpfvidOverFlowClbk pfvClbk, uint8 u8DividerMs)
+{
+	uint8 u8Sreg = SREG;
+	uint8 u8Sub = TIM_u8T0_INVALID_SUB;
+	uint8 u8Free;
+
+	if ((pfvClbk != NULL) && (u8DividerMs != 0U)){
+		cli();
+		for (u8Free = 0; u8Free < TIM_u8T0_MAX_SUBSCRIBERS; u8Free++){
+			if (astrT0Subscribers[u8Free].pfvClbk == NULL){
+				astrT0Subscribers[u8Free].u8Divider = u8DividerMs;
+				astrT0Subscribers[u8Free].u8Countdown = u8DividerMs;
+				astrT0Subscribers[u8Free].pfvClbk = pfvClbk;
+				u8Sub = u8Free;
+				break;
+			}
+		}
+		SREG = u8Sreg;
+	}
+	return u8Sub;
+}
+
+/*****************************************************************************************************************
+* Function				: TIM_eT0Unsubscribe
+* Description			: Remove a call back from the Timer 0 tick, may be called from a call back.
+* Parameters[in]		: [u8SubId] id returned by TIM_u8T0Subscribe
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on an invalid id
+*
+*******************************************************************************************************************/
+extern STD_ERR_T TIM_eT0Unsubscribe(uint8 u8SubId)
+{
+	uint8 u8Sreg = SREG;
+	STD_ERR_T eRet = STD_ERR_NOK;
+
+	if (u8SubId < TIM_u8T0_MAX_SUBSCRIBERS){
+		/* 2 bytes pointer read by the ISR */
+		cli();
+		astrT0Subscribers[u8SubId].pfvClbk = NULL;
+		SREG = u8Sreg;
+		eRet = STD_ERR_OK;
+	}
+	return eRet;
 }
 
 /*****************************************************************************************************************
 * Function				: TIM_vidT0AttachInterrupt
-* Description			: Attach a routine Call back for timer 0 over flow interrupt
+* Description			: Attach a routine Call back for timer 0 over flow interrupt, called every 1 ms. Takes a
+						  subscriber slot (TIM_u8T0Subscribe), replaces the routine of a previous attach.
 * Parameters[in]		: [pfvClbk] pointer the Call back routine
 * Parameters[in/out]	: None
 * Parameters[out]		: None
@@ -202,12 +377,13 @@ extern void TIM_vidInitT0(void)
 *******************************************************************************************************************/
 extern void TIM_vidT0AttachInterrupt(TIM_tpfvidOverFlowClbk pfvClbk)
 {
-	pfvOnT0OverFlowClbk = pfvClbk;
+	TIM_vidT0DeAttachInterrupt();
+	TIM_u8T0AttachedSub = TIM_u8T0Subscribe(pfvClbk, 1U);
 }
 
 /*****************************************************************************************************************
 * Function				: TIM_vidT0DeAttachInterrupt
-* Description			: De-attach a routine Call back for timer 0 over flow interrupt
+* Description			: De-attach the routine Call back of TIM_vidT0AttachInterrupt
 * Parameters[in]		: None
 * Parameters[in/out]	: None
 * Parameters[out]		: None
@@ -215,12 +391,85 @@ extern void TIM_vidT0AttachInterrupt(TIM_tpfvidOverFlowClbk pfvClbk)
 *******************************************************************************************************************/
 extern void TIM_vidT0DeAttachInterrupt(void)
 {
-	pfvOnT0OverFlowClbk = NULL;
+	(void)TIM_eT0Unsubscribe(TIM_u8T0AttachedSub);
+	TIM_u8T0AttachedSub = TIM_u8T0_INVALID_SUB;
+}
+
+/*****************************************************************************************************************
+* Function				: TIM_u16T0GetIsrMaxUs
+* Description			: Longest Timer 0 overflow ISR (tick bookkeeping and subscribers) since TIM_vidInitT0 or
+						  TIM_vidT0ResetIsrMax, measured from the overflow with the 8 us resolution of the timer.
+						  0x7F8 (255 counts) means an ISR ran past the next tick.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 micro seconds
+*
+*******************************************************************************************************************/
+extern uint16 TIM_u16T0GetIsrMaxUs(void)
+{
+	return (uint16)TIM_u8T0IsrMaxCounts * TIM_u8T0_US_PER_COUNT;
+}
+
+/*****************************************************************************************************************
+* Function				: TIM_vidT0ResetIsrMax
+* Description			: Restart the measure of TIM_u16T0GetIsrMaxUs.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*******************************************************************************************************************/
+extern void TIM_vidT0ResetIsrMax(void)
+{
+	TIM_u8T0IsrMaxCounts = 0;
+}
+
+/*****************************************************************************************************************
+* Function				: TIM_vidT0AddHaltedUs
+* Description			: Advance the milli seconds count by a time Timer 0 did not count because its clock was
+						  halted (ADC noise reduction sleep, RTC_ePowerSave). The next tick gives it to the
+						  subscribers, at most 255 ms late. Call with interrupts disabled.
+* Parameters[in]		: [u32Us] halted time in us
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*******************************************************************************************************************/
+extern void TIM_vidT0AddHaltedUs(uint32 u32Us)
+{
+	uint32 u32Before = TIM_u32Millis;
+	/* ms not yet given to the subscribers, the dispatch only counts 255 of them */
+	uint8 u8Pending = (uint8)u32Before - TIM_u8T0LastDispatchMs;
+
+	TIM_u32Millis += u32Us / 1000UL;
+	TIM_vidT0AddUs((uint16)(u32Us % 1000UL));
+	if (((TIM_u32Millis - u32Before) + u8Pending) > 0xFFUL){
+		TIM_u8T0LastDispatchMs = (uint8)TIM_u32Millis - 0xFFU;
+	}
+}
+
+/*****************************************************************************************************************
+* Function				: TIM_u16T0GetInterruptedPc
+* Description			: Word address of the instruction interrupted by the last Timer 0 overflow ISR, tells a
+						  tick subscriber (e.g. the watchdog supervisor) where the main context was running.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 word address (x2 for the byte address of the .lss listing)
+*
+*******************************************************************************************************************/
+extern uint16 TIM_u16T0GetInterruptedPc(void)
+{
+	uint16 u16Pc;
+	uint8 u8Sreg = SREG;
+
+	cli();
+	u16Pc = TIM_u16T0InterruptedPc;
+	SREG = u8Sreg;
+	return u16Pc;
 }
 
 /*****************************************************************************************************************
 * Function				: TIM_u32GetMillis
-* Description			: return approximate number of milli seconds elapsed since the initialization of Timer 0
+* Description			: return approximate number of milli seconds elapsed since the initialization of Timer 0,
+						  read atomically (may be called with interrupts enabled or from an ISR)
 * Parameters[in]		: None
 * Parameters[in/out]	: None
 * Parameters[out]		: uint32 approximate number of milli seconds elapsed since the initialization of Timer 0
@@ -228,7 +477,139 @@ extern void TIM_vidT0DeAttachInterrupt(void)
 *******************************************************************************************************************/
 extern uint32 TIM_u32GetMillis(void)
 {
-	return TIM_u32Millis;
+	uint8 u8Sreg = SREG;
+	uint32 u32Ms;
+
+	/* 4 bytes updated by the ISR */
+	cli();
+	u32Ms = TIM_u32Millis;
+	SREG = u8Sreg;
+	return u32Ms;
+}
+
+/*****************************************************************************************************************
+* Function				: TIM_u32GetMicros
+* Description			: return the number of micro seconds elapsed since the initialization of Timer 0, 8 us
+						  resolution (256 us during a stretched tick). Wraps after 71 minutes, may be called
+						  from an ISR.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint32 micro seconds elapsed since the initialization of Timer 0
+*
+*******************************************************************************************************************/
+extern uint32 TIM_u32GetMicros(void)
+{
+	uint8 u8Sreg = SREG;
+	uint32 u32Ms;
+	uint32 u32Us;
+	uint8 u8Count;
+
+	cli();
+	u32Ms = TIM_u32Millis;
+	u32Us = TIM_u16T0UsFraction;
+	u8Count = TCNT0;
+	if (TIFR & (1<<TOV0)){
+		/* the overflow ISR did not run yet: the whole tick elapsed and TCNT0 restarted from 0, read it again
+		   in case it overflowed after the first read */
+		u8Count = TCNT0;
+		if (TIM_u8T0StretchCounts != 0){
+			u32Us += ((uint16)TIM_u8T0StretchCounts + u8Count) * (uint32)TIM_u16T0_STRETCH_US_PER_COUNT;
+		} else {
+			u32Us += 1000U + ((uint16)u8Count * TIM_u8T0_US_PER_COUNT);
+		}
+	} else if (TIM_u8T0StretchCounts != 0){
+		u32Us += (uint16)(uint8)(u8Count - TIM_u8T0StretchStart) * (uint32)TIM_u16T0_STRETCH_US_PER_COUNT;
+	} else {
+		u32Us += (uint16)(uint8)(u8Count - TIM_u8T0_RELOAD_VAL) * TIM_u8T0_US_PER_COUNT;
+	}
+	SREG = u8Sreg;
+	/* the ms * 1000 product wraps together with the ms count (2^32 * 1000 is 0 modulo 2^32) */
+	return (u32Ms * 1000UL) + u32Us;
+}
+
+/*****************************************************************************************************************
+* Function				: TIM_u32ElapsedMicros
+* Description			: micro seconds elapsed since a time stamp of TIM_u32GetMicros, right across the wrap of
+						  the counter for intervals shorter than 71 minutes.
+* Parameters[in]		: [u32StartUs] time stamp taken with TIM_u32GetMicros
+* Parameters[in/out]	: None
+* Parameters[out]		: uint32 micro seconds since u32StartUs
+*
+*******************************************************************************************************************/
+extern uint32 TIM_u32ElapsedMicros(uint32 u32StartUs)
+{
+	/* modulo 2^32 difference */
+	return TIM_u32GetMicros() - u32StartUs;
+}
+
+/*****************************************************************************************************************
+* Function				: TIM_u32ElapsedMillis
+* Description			: milli seconds elapsed since a time stamp of TIM_u32GetMillis, right across the wrap of
+						  the counter (49 days).
+* Parameters[in]		: [u32StartMs] time stamp taken with TIM_u32GetMillis
+* Parameters[in/out]	: None
+* Parameters[out]		: uint32 milli seconds since u32StartMs
+*
+*******************************************************************************************************************/
+extern uint32 TIM_u32ElapsedMillis(uint32 u32StartMs)
+{
+	return TIM_u32GetMillis() - u32StartMs;
+}
+
+/*****************************************************************************************************************
+* Function				: TIM_vidT0StretchTick
+* Description			: Replace the next 1 ms ticks by a single Timer0 overflow u8Ms later (tickless idle).
+						  The milli seconds count is advanced by the real stretched time when the overflow
+						  fires, then the timer goes back to the normal 1 ms tick. Call with interrupts disabled.
+* Parameters[in]		: [u8Ms] length of the stretched tick in ms, Range ( 1 .. TIM_u8T0_STRETCH_MAX_MS )
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*******************************************************************************************************************/
+extern void TIM_vidT0StretchTick(uint8 u8Ms)
+{
+	uint8 u8Counts;
+
+	if (u8Ms > TIM_u8T0_STRETCH_MAX_MS){
+		u8Ms = TIM_u8T0_STRETCH_MAX_MS;
+	}
+	/* ms * 1000 / 256, rounded down so the wake up is never late */
+	u8Counts = (uint8)(((uint16)u8Ms * 125U) / 32U);
+	if ((u8Counts != 0) && (TIM_u8T0StretchCounts == 0) && ((TIFR & (1<<TOV0)) == 0)){
+		/* keep the part of the current 1 ms tick that already elapsed */
+		TIM_vidT0AddUs((uint16)(uint8)(TCNT0 - TIM_u8T0_RELOAD_VAL) * TIM_u8T0_US_PER_COUNT);
+		TIM_u8T0StretchCounts = u8Counts;
+		TIM_u8T0StretchStart = (uint8)(0U - u8Counts);
+		TCCR0 = (1<<CS02); // prescaler = 256
+		TCNT0 = TIM_u8T0StretchStart;
+	}
+}
+
+/*****************************************************************************************************************
+* Function				: TIM_vidT0EndStretch
+* Description			: End a stretched tick early (the CPU was woken by another interrupt), the elapsed part
+						  is added to the milli seconds count and the normal 1 ms tick is restarted.
+						  Does nothing if no stretch is active. Call with interrupts disabled.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*******************************************************************************************************************/
+extern void TIM_vidT0EndStretch(void)
+{
+	uint8 u8Elapsed;
+
+	if (TIM_u8T0StretchCounts != 0){
+		u8Elapsed = (uint8)(TCNT0 - TIM_u8T0StretchStart);
+		if (TIFR & (1<<TOV0)){
+			/* the stretch completed but its ISR did not run, it is consumed here */
+			TIFR = (1<<TOV0);
+			u8Elapsed = TIM_u8T0StretchCounts;
+		}
+		/* the running (partial) 256 us count is lost */
+		TIM_vidT0AddUs((uint16)u8Elapsed * TIM_u16T0_STRETCH_US_PER_COUNT);
+		TIM_vidT0RestoreTick();
+	}
 }
 
 /***********************************************************************************************************
@@ -255,26 +636,23 @@ extern void TIM_vidT1PWMInit(uint8 u8BitRes, uint8 u8PwmChMode, uint8 u8Prescale
 {
 	
 	/* configures timer1 for use with PWM output on OC1A and OC1B pins 	*/
-	/* enable timer1 as 8,9 or 10bit PWM								*/
+	/* enable timer1 as 8,9 or 10bit fast PWM							*/
 	
 	switch (u8BitRes)
 	{
 		case 8:
 			/* 8bit mode */
-			CLEAR_BIT(TCCR1B,WGM13);
-			SET_BIT(TCCR1B,WGM12);
-			CLEAR_BIT(TCCR1A,WGM11);
-			SET_BIT(TCCR1A,WGM10);
+			TIM_vidT1SetMode(TIM1_FAST_PWM_8_BIT);
 		break;
 		
 		case 9:
 			/* 9bit mode */
-
+			TIM_vidT1SetMode(TIM1_FAST_PWM_9_BIT);
 		break;
 		
 		case 10:
 			/* 10bit mode */
-
+			TIM_vidT1SetMode(TIM1_FAST_PWM_10_BIT);
 		break;
 		
 		default:
@@ -310,21 +688,22 @@ extern void TIM_vidT1PWMInit(uint8 u8BitRes, uint8 u8PwmChMode, uint8 u8Prescale
 ************************************************************************************************************/
 extern void TIM_vidT1SetPwmChannelsMode (uint8 u8PwmChMode)
 {
+	/* the COM1x bits of the previous mode are cleared, the WGM bits kept */
 	switch(u8PwmChMode){
 		case TIM1_CHA_CHB_DISCONNECTED:
-			TCCR1A |= TIM1_CHA_CHB_DISCONNECTED_VAL;
+			TCCR1A = (TCCR1A & ~TIM1_COM_MASK) | TIM1_CHA_CHB_DISCONNECTED_VAL;
 		break;
 		
 		case TIM1_CHB_DISCONNECTED:
-			TCCR1A |= TIM1_CHB_DISCONNECTED_VAL;
+			TCCR1A = (TCCR1A & ~TIM1_COM_MASK) | TIM1_CHB_DISCONNECTED_VAL;
 		break;
 		
 		case TIM1_CHA_CHB_NON_INVERTING:
-			TCCR1A |= TIM1_CHA_CHB_NON_INVERTING_VAL;
+			TCCR1A = (TCCR1A & ~TIM1_COM_MASK) | TIM1_CHA_CHB_NON_INVERTING_VAL;
 		break;
 		
 		case TIM1_CHA_CHB_INVERTING:
-			TCCR1A |= TIM1_CHA_CHB_INVERTING_VAL;
+			TCCR1A = (TCCR1A & ~TIM1_COM_MASK) | TIM1_CHA_CHB_INVERTING_VAL;
 		break;
 		
 		default:
@@ -350,35 +729,35 @@ extern void TIM_vidT1SetPrescaler(uint8 u8TimPrescaler)
 	switch (u8TimPrescaler)
 	{
 		case TIM1_STOP			 :
-			TCCR1B |= TIM1_VAL_STOP;
+			TCCR1B = (TCCR1B & ~TIM1_CS_MASK) | TIM1_VAL_STOP;
 		break;
 		
 		case TIM1_NO_PRESCALER	 :
-			TCCR1B |= TIM1_VAL_NO_PRESCALER;
+			TCCR1B = (TCCR1B & ~TIM1_CS_MASK) | TIM1_VAL_NO_PRESCALER;
 		break;
 		
 		case TIM1_8_PRESCALER	 :
-			TCCR1B |= TIM1_VAL_8_PRESCALER;
+			TCCR1B = (TCCR1B & ~TIM1_CS_MASK) | TIM1_VAL_8_PRESCALER;
 		break;
 		
 		case TIM1_64_PRESCALER	 :
-			TCCR1B |= TIM1_VAL_64_PRESCALER;
+			TCCR1B = (TCCR1B & ~TIM1_CS_MASK) | TIM1_VAL_64_PRESCALER;
 		break;
 		
 		case TIM1_256_PRESCALER	 :
-			TCCR1B |= TIM1_VAL_256_PRESCALER;
+			TCCR1B = (TCCR1B & ~TIM1_CS_MASK) | TIM1_VAL_256_PRESCALER;
 		break;
 		
 		case TIM1_1024_PRESCALER :
-			TCCR1B |= TIM1_VAL_1024_PRESCALER;
+			TCCR1B = (TCCR1B & ~TIM1_CS_MASK) | TIM1_VAL_1024_PRESCALER;
 		break;
 		
 		case TIM1_Ext_CLK_FALLING:
-			TCCR1B |= TIM1_VAL_Ext_CLK_FALLING;
+			TCCR1B = (TCCR1B & ~TIM1_CS_MASK) | TIM1_VAL_Ext_CLK_FALLING;
 		break;
 		
 		case TIM1_Ext_CLK_RISING :
-			TCCR1B |= TIM1_VAL_Ext_CLK_RISING;
+			TCCR1B = (TCCR1B & ~TIM1_CS_MASK) | TIM1_VAL_Ext_CLK_RISING;
 		break;
 		
 		default:
@@ -393,13 +772,216 @@ extern void TIM_vidT1SetPrescaler(uint8 u8TimPrescaler)
 * Description			: Get the current prescaler setting value for timer 1.			  
 * Parameters[in]		: None
 * Parameters[in/out]	: None												  
-* Parameters[out]		: uint16												  
+* Parameters[out]		: uint16 division factor (1, 8, 64, 256, 1024), 0 when stopped or clocked from T1
 *																			  
 ************************************************************************************************************/
 extern uint16 TIM_u16T1GetPrescaler(void)
 {
-	/* get the current prescaler setting */
-	return 0;
+	uint8 u8Cs = TCCR1B & TIM1_CS_MASK;
+	uint16 u16RetVal = 0;
+
+	/* get the current prescaler setting, the CS12:0 value is the prescaler ID */
+	if ((u8Cs >= TIM1_NO_PRESCALER) && (u8Cs <= TIM1_1024_PRESCALER)){
+		u16RetVal = au16T1Prescaler[u8Cs - 1U];
+	}
+	return u16RetVal;
+}
+
+/***********************************************************************************************************
+* Function				: TIM_vidT1SetMode
+* Description			: Set the timer 1 waveform generation mode (WGM13:0), the channels mode and the clock
+						  are kept.
+* Parameters[in]		: [u8Mode] Range ( TIM1_Normal .. TIM1_FAST_PWM_TOP_OCR1A ), see TIM_timers.h
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+************************************************************************************************************/
+extern void TIM_vidT1SetMode(uint8 u8Mode)
+{
+	uint8 u8Wgm;
+
+	if (u8Mode < TIM1_u8NO_OF_MODES){
+		u8Wgm = au8T1Wgm[u8Mode];
+		TCCR1A = (TCCR1A & ~TIM1_WGM_A_MASK) | (u8Wgm & 0x03U);
+		TCCR1B = (TCCR1B & ~TIM1_WGM_B_MASK) | ((u8Wgm & 0x0CU) << 1);
+	} else {
+		INFO("Invalid T1 Mode Requested!!");
+	}
+}
+
+/***********************************************************************************************************
+* Function				: TIM_u16T1GetTop
+* Description			: TOP of the current timer 1 mode, the duty cycles range from 0 to TOP. An ICR1 waiting
+						  for the next overflow (TIM_vidT1SetTop) is returned.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 TOP value
+*
+************************************************************************************************************/
+extern uint16 TIM_u16T1GetTop(void)
+{
+	uint8 u8Sreg = SREG;
+	uint16 u16Top;
+
+	cli();
+	switch ((TCCR1A & TIM1_WGM_A_MASK) | ((TCCR1B & TIM1_WGM_B_MASK) >> 1))
+	{
+		case TIM1_VAL_PWM_Ph_8_BIT:
+		case TIM1_VAL_FAST_PWM_8_BIT:
+			u16Top = 0x00FFU;
+		break;
+		
+		case TIM1_VAL_PWM_Ph_9_BIT:
+		case TIM1_VAL_FAST_PWM_9_BIT:
+			u16Top = 0x01FFU;
+		break;
+		
+		case TIM1_VAL_PWM_Ph_10_BIT:
+		case TIM1_VAL_FAST_PWM_10_BIT:
+			u16Top = 0x03FFU;
+		break;
+		
+		case TIM1_VAL_CTC_TOP_OCR1A:
+		case TIM1_VAL_PWM_Ph_Freq_TOP_OCR1A:
+		case TIM1_VAL_PWM_Ph_TOP_OCR1A:
+		case TIM1_VAL_FAST_PWM_TOP_OCR1A:
+			u16Top = OCR1A;
+		break;
+		
+		case TIM1_VAL_PWM_Ph_Freq_TOP_ICR1:
+		case TIM1_VAL_PWM_Ph_TOP_ICR1:
+		case TIM1_VAL_CTC_TOP_ICR1:
+		case TIM1_VAL_FAST_PWM_TOP_ICR1:
+			u16Top = (TIM_bT1TopPending == TRUE) ? TIM_u16T1ShadowTop : ICR1;
+		break;
+		
+		default:
+			/* normal mode */
+			u16Top = 0xFFFFU;
+		break;
+	}
+	SREG = u8Sreg;
+	return u16Top;
+}
+
+/***********************************************************************************************************
+* Function				: TIM_vidT1SetTop
+* Description			: Change the TOP of a timer 1 mode with a variable TOP (the PWM frequency). In the PWM
+						  modes with TOP = ICR1 the new value is written by the overflow ISR, so the current
+						  period ends with the old TOP (ICR1 is not double buffered, a TOP written under TCNT1
+						  would let the counter run up to 0xFFFF). OCR1A is double buffered in the PWM modes and
+						  written now. The fixed TOP modes are left unchanged.
+* Parameters[in]		: [u16Top] Range ( 3 .. 0xFFFF )
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+************************************************************************************************************/
+extern void TIM_vidT1SetTop(uint16 u16Top)
+{
+	uint8 u8Sreg = SREG;
+
+	cli();
+	switch ((TCCR1A & TIM1_WGM_A_MASK) | ((TCCR1B & TIM1_WGM_B_MASK) >> 1))
+	{
+		case TIM1_VAL_PWM_Ph_Freq_TOP_ICR1:
+		case TIM1_VAL_PWM_Ph_TOP_ICR1:
+		case TIM1_VAL_FAST_PWM_TOP_ICR1:
+			TIM_u16T1ShadowTop = u16Top;
+			TIM_bT1TopPending = TRUE;
+			SET_BIT(TIMSK, TOIE1);
+		break;
+		
+		case TIM1_VAL_CTC_TOP_ICR1:
+			ICR1 = u16Top;
+		break;
+		
+		case TIM1_VAL_CTC_TOP_OCR1A:
+		case TIM1_VAL_PWM_Ph_Freq_TOP_OCR1A:
+		case TIM1_VAL_PWM_Ph_TOP_OCR1A:
+		case TIM1_VAL_FAST_PWM_TOP_OCR1A:
+			OCR1A = u16Top;
+		break;
+		
+		default:
+			INFO("T1 TOP is fixed in this mode");
+		break;
+	}
+	SREG = u8Sreg;
+}
+
+/***********************************************************************************************************
+* Function				: TIM_eT1PwmInitFreq
+* Description			: Timer1 fast PWM with TOP = ICR1 at the requested frequency on OC1A and OC1B. The
+						  smallest prescaler that fits is taken, for the finest duty resolution: TOP + 1 =
+						  F_CPU / (prescaler * frequency), read it with TIM_u16T1GetTop. The duty cycles start
+						  at 0.
+						  e.g. 20 kHz @ 1 MHz: no prescaler, TOP = 49; 50 Hz @ 1 MHz: no prescaler, TOP = 19999
+* Parameters[in]		: [u32FreqHz] PWM frequency, Range ( F_CPU / (1024 * 65536) .. F_CPU / 4 )
+						  [u8PwmChMode] The desired mode for OC1A, OC1B pins
+						  Range ( TIM1_CHA_CHB_DISCONNECTED , TIM1_CHB_DISCONNECTED,
+						  TIM1_CHA_CHB_NON_INVERTING ,TIM1_CHA_CHB_INVERTING )
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the frequency is out of range
+*
+************************************************************************************************************/
+extern STD_ERR_T TIM_eT1PwmInitFreq(uint32 u32FreqHz, uint8 u8PwmChMode)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint8 u8Sreg;
+	uint8 u8Index;
+	uint32 u32Ticks = 0;
+
+	if (u32FreqHz != 0U){
+		for (u8Index = 0U; u8Index < TIM1_u8NO_OF_PRESCALERS; u8Index++){
+			/* rounded to the nearest count */
+			u32Ticks = ((F_CPU / au16T1Prescaler[u8Index]) + (u32FreqHz / 2U)) / u32FreqHz;
+			if ((u32Ticks > TIM1_u16MIN_TOP) && (u32Ticks <= 0x10000UL)){
+				errRetVal = STD_ERR_OK;
+				break;
+			}
+		}
+	}
+	if (errRetVal == STD_ERR_OK){
+		u8Sreg = SREG;
+		cli();
+		TIM_vidT1SetPrescaler(TIM1_STOP);
+		TIM_bT1TopPending = FALSE;
+		TIM_vidT1SetMode(TIM1_FAST_PWM_TOP_ICR1);
+		ICR1 = (uint16)(u32Ticks - 1U);
+		OCR1A = 0;
+		OCR1B = 0;
+		TCNT1 = 0;
+		SREG = u8Sreg;
+		TIM_vidT1SetPwmChannelsMode(u8PwmChMode);
+		TIM_vidT1SetPrescaler(u8Index + 1U);
+	}
+	return errRetVal;
+}
+
+/***********************************************************************************************************
+* Function				: TIM_eT1SetPwmFreq
+* Description			: Change the frequency of the PWM started by TIM_eT1PwmInitFreq, the prescaler is kept
+						  and the new TOP applies at the end of the current period (TIM_vidT1SetTop). The duty
+						  cycles are not rescaled.
+* Parameters[in]		: [u32FreqHz] PWM frequency
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the frequency does not fit the current prescaler
+*
+************************************************************************************************************/
+extern STD_ERR_T TIM_eT1SetPwmFreq(uint32 u32FreqHz)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint16 u16Prescaler = TIM_u16T1GetPrescaler();
+	uint32 u32Ticks;
+
+	if ((u32FreqHz != 0U) && (u16Prescaler != 0U)){
+		u32Ticks = ((F_CPU / u16Prescaler) + (u32FreqHz / 2U)) / u32FreqHz;
+		if ((u32Ticks > TIM1_u16MIN_TOP) && (u32Ticks <= 0x10000UL)){
+			TIM_vidT1SetTop((uint16)(u32Ticks - 1U));
+			errRetVal = STD_ERR_OK;
+		}
+	}
+	return errRetVal;
 }
 
 
@@ -414,8 +996,7 @@ extern uint16 TIM_u16T1GetPrescaler(void)
 extern void TIM_vidT1PWMOff(void)
 {
 	/* turn off timer1 PWM mode */
-	CLEAR_BIT(TCCR1A,WGM11);
-	CLEAR_BIT(TCCR1A,WGM10);
+	TIM_vidT1SetMode(TIM1_Normal);
 	/* set PWM1A/B (OutputCompare action) to none */
 	TIM_vidT1PWMAOff();
 	TIM_vidT1PWMBOff();
@@ -503,11 +1084,14 @@ extern void TIM_vidT1PWMBOff(void)
 *
 * Function				: TIM_vidT1PwmASetDuty
 * Description			: Set PWM (output compare) duty for channel A generated on OC1A pin.
+						  In the PWM modes OCR1A is double buffered by the hardware: the new duty applies at
+						  TOP (at BOTTOM in phase and frequency correct mode), never in the middle of a period.
 * Parameters[in]		: [u16PwmDuty] duty for channel A
 						  Range : 
 						  pwmDuty should be in the range 0-255 for 8bit PWM
 						  pwmDuty should be in the range 0-511 for 9bit PWM
 						  pwmDuty should be in the range 0-1023 for 10bit PWM
+						  pwmDuty should be in the range 0-TIM_u16T1GetTop() for the ICR1 TOP modes
 * Parameters[in/out]	: None
 * Parameters[out]		: None
 *
@@ -521,18 +1105,25 @@ extern void TIM_vidT1PwmASetDuty(uint16 u16PwmDuty)
 			pwmDuty should be in the range 0-511 for 9bit PWM
 			pwmDuty should be in the range 0-1023 for 10bit PWM
 	*********************************************************************/
+	uint8 u8Sreg = SREG;
 
+	/* the 16-bit write goes through the TEMP register shared with the timer 1 ISRs */
+	cli();
 	OCR1A = u16PwmDuty;
+	SREG = u8Sreg;
 }
 
 /***********************************************************************************************************
 * Function				: TIM_vidT1PwmBSetDuty
 * Description			: Set PWM (output compare) duty for channel B generated on OC1B pin.
+						  In the PWM modes OCR1B is double buffered by the hardware: the new duty applies at
+						  TOP (at BOTTOM in phase and frequency correct mode), never in the middle of a period.
 * Parameters[in]		: [u16PwmDuty] duty for channel B
 						  Range : 
 						  pwmDuty should be in the range 0-255 for 8bit PWM		
 						  pwmDuty should be in the range 0-511 for 9bit PWM		
 						  pwmDuty should be in the range 0-1023 for 10bit PWM	
+						  pwmDuty should be in the range 0-TIM_u16T1GetTop() for the ICR1 TOP modes
 * Parameters[in/out]	: None
 * Parameters[out]		: None
 *
@@ -546,6 +1137,117 @@ extern void TIM_vidT1PwmBSetDuty(uint16 u16PwmDuty)
 			pwmDuty should be in the range 0-511 for 9bit PWM
 			pwmDuty should be in the range 0-1023 for 10bit PWM
 	*********************************************************************/
+	uint8 u8Sreg = SREG;
+
+	/* the 16-bit write goes through the TEMP register shared with the timer 1 ISRs */
+	cli();
 	OCR1B = u16PwmDuty;
+	SREG = u8Sreg;
+}
+
+/******************************************************************************
+Function			: TIMER1_OVF_vect ISR routine
+Description			: Timer1 Overflow interrupt service routine.
+Parameters[in]		: None
+Parameters[in/out]	: None
+Parameters[out]		: None
+********************************************************************************/
+ISR(TIMER1_OVF_vect)
+{
+	if (TIM_bT1TopPending == TRUE){
+		/* start of a period (BOTTOM or just after TOP in fast PWM), TCNT1 is below the new TOP */
+		ICR1 = TIM_u16T1ShadowTop;
+		TIM_bT1TopPending = FALSE;
+		if (pfvOnT1OvfClbk == NULL){
+			CLEAR_BIT(TIMSK, TOIE1);
+		}
+	}
+	if (pfvOnT1OvfClbk != NULL){
+		pfvOnT1OvfClbk();
+	}
+}
+
+/*****************************************************************************************************************
+* Function				: TIM_vidT1AttachOvfInterrupt
+* Description			: Attach a routine Call back for timer 1 over flow interrupt, the owner of Timer 1 sets
+						  TOIE1 in TIMSK.
+* Parameters[in]		: [pfvClbk] pointer the Call back routine, NULL to de-attach
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*******************************************************************************************************************/
+extern void TIM_vidT1AttachOvfInterrupt(TIM_tpfvidOverFlowClbk pfvClbk)
+{
+	uint8 u8Sreg = SREG;
+
+	/* 2 bytes pointer read by the ISR */
+	cli();
+	pfvOnT1OvfClbk = pfvClbk;
+	SREG = u8Sreg;
+}
+
+/******************************************************************************
+Function			: TIMER2_COMP_vect ISR routine
+Description			: Timer2 Compare match interrupt service routine.
+Parameters[in]		: None
+Parameters[in/out]	: None
+Parameters[out]		: None
+********************************************************************************/
+ISR(TIMER2_COMP_vect)
+{
+	if (pfvOnT2CompClbk != NULL){
+		pfvOnT2CompClbk();
+	}
+}
+
+/*****************************************************************************************************************
+* Function				: TIM_vidInitT2Ctc
+* Description			: Timer2 in CTC mode (TOP = OCR2), the compare interrupt fires every
+						  (u8Top + 1) * prescaler CPU cycles and calls the attached call back.
+* Parameters[in]		: [u8Prescaler] Range ( TIM2_NO_PRESCALER, TIM2_8_PRESCALER, TIM2_32_PRESCALER,
+						  TIM2_64_PRESCALER, TIM2_128_PRESCALER, TIM2_256_PRESCALER, TIM2_1024_PRESCALER )
+						  [u8Top] compare value
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*******************************************************************************************************************/
+extern void TIM_vidInitT2Ctc(uint8 u8Prescaler, uint8 u8Top)
+{
+	CLEAR_BIT(TIMSK, OCIE2);
+	TCCR2 = 0;
+	TCNT2 = 0;
+	OCR2 = u8Top;
+	/* clear a stale compare flag */
+	TIFR = (1<<OCF2);
+	SET_BIT(TIMSK, OCIE2);
+	/* CTC mode, OC2 disconnected, CS22:0 = prescaler ID */
+	TCCR2 = (1<<WGM21) | (u8Prescaler & 0x07);
+}
+
+/*****************************************************************************************************************
+* Function				: TIM_vidT2Stop
+* Description			: Stop Timer2 clock and disable its compare interrupt.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*******************************************************************************************************************/
+extern void TIM_vidT2Stop(void)
+{
+	TCCR2 = 0;
+	CLEAR_BIT(TIMSK, OCIE2);
+}
+
+/*****************************************************************************************************************
+* Function				: TIM_vidT2AttachCompInterrupt
+* Description			: Attach a routine Call back for timer 2 compare match interrupt
+* Parameters[in]		: [pfvClbk] pointer the Call back routine, NULL to de-attach
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*******************************************************************************************************************/
+extern void TIM_vidT2AttachCompInterrupt(TIM_tpfvidOverFlowClbk pfvClbk)
+{
+	pfvOnT2CompClbk = pfvClbk;
 }
 
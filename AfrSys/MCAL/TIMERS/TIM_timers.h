@@ -24,6 +24,16 @@
 
 /*----------------------------------------- MACROS Definitions ------------------------------------------------*/
 
+/* Timer0 1 ms tick: prescaler 8 @ 1 MHz, 125 counts of 8 us from the reload value up to the overflow */
+#define TIM_u8T0_RELOAD_VAL				(uint8)131
+#define TIM_u8T0_US_PER_COUNT			(uint8)8
+/* Timer0 stretched tick (tickless idle): prescaler 256, one count = 256 us, up to 65 ms per overflow */
+#define TIM_u16T0_STRETCH_US_PER_COUNT	(uint16)256
+#define TIM_u8T0_STRETCH_MAX_MS			(uint8)65
+/* Timer0 tick subscribers table size, returned by TIM_u8T0Subscribe when it is full */
+#define TIM_u8T0_MAX_SUBSCRIBERS		(uint8)4
+#define TIM_u8T0_INVALID_SUB			(uint8)0xFF
+
 #define TIM1_CHA_CHB_DISCONNECTED       (uint8)0
 #define TIM1_CHB_DISCONNECTED		    (uint8)1
 #define TIM1_CHA_CHB_NON_INVERTING	    (uint8)2
@@ -40,6 +50,16 @@
 #define TIM1_Ext_CLK_RISING				(uint8)7
 
 
+#define TIM2_STOP						(uint8)0
+#define TIM2_NO_PRESCALER				(uint8)1
+#define TIM2_8_PRESCALER				(uint8)2
+#define TIM2_32_PRESCALER				(uint8)3
+#define TIM2_64_PRESCALER				(uint8)4
+#define TIM2_128_PRESCALER				(uint8)5
+#define TIM2_256_PRESCALER				(uint8)6
+#define TIM2_1024_PRESCALER				(uint8)7
+
+
 #define TIM1_Normal						(uint8)0
 #define TIM1_PWM_Ph_8_BIT				(uint8)1
 #define TIM1_PWM_Ph_9_BIT				(uint8)2
@@ -62,10 +82,6 @@
 
 typedef void (* TIM_tpfvidOverFlowClbk )(void );
 
-/*------------------------------------------ Global Variables -------------------------------------------------*/
-
-TIM_tpfvidOverFlowClbk pfvOnT0OverFlowClbk;
-
 /*---------------------------------------- FUNCTION Definitions -----------------------------------------------*/
 
 /****************************************************************************************************************
@@ -78,9 +94,32 @@ TIM_tpfvidOverFlowClbk pfvOnT0OverFlowClbk;
 *****************************************************************************************************************/
 extern void TIM_vidInitT0(void);
 
+/*****************************************************************************************************************
+* Function				: TIM_u8T0Subscribe
+* Description			: Add a call back to the Timer 0 tick, called from the overflow ISR every u8DividerMs ms
+						  (once at the end of a stretched tick covering several periods).
+* Parameters[in]		: [pfvClbk] pointer the Call back routine
+						  [u8DividerMs] Range ( 1 .. 255 ) ms between two calls
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 subscriber id, TIM_u8T0_INVALID_SUB if the table is full or a parameter is invalid
+*
+*******************************************************************************************************************/
+extern uint8 TIM_u8T0Subscribe(TIM_tpfvidOverFlowClbk pfvClbk, uint8 u8DividerMs);
+
+/*****************************************************************************************************************
+* Function				: TIM_eT0Unsubscribe
+* Description			: Remove a call back from the Timer 0 tick, may be called from a call back.
+* Parameters[in]		: [u8SubId] id returned by TIM_u8T0Subscribe
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on an invalid id
+*
+*******************************************************************************************************************/
+extern STD_ERR_T TIM_eT0Unsubscribe(uint8 u8SubId);
+
 /*****************************************************************************************************************
 * Function				: TIM_vidT0AttachInterrupt
-* Description			: Attach a routine Call back for timer 0 over flow interrupt
+* Description			: Attach a routine Call back for timer 0 over flow interrupt, called every 1 ms. Takes a
+						  subscriber slot (TIM_u8T0Subscribe), replaces the routine of a previous attach.
 * Parameters[in]		: [pfvClbk] pointer the Call back routine
 * Parameters[in/out]	: None
 * Parameters[out]		: None
@@ -90,7 +129,7 @@ extern void TIM_vidT0AttachInterrupt(TIM_tpfvidOverFlowClbk pfvClbk);
 
 /*****************************************************************************************************************
 * Function				: TIM_vidT0DeAttachInterrupt
-* Description			: De-attach the routine call back from timer 0 over flow interrupt
+* Description			: De-attach the routine call back of TIM_vidT0AttachInterrupt
 * Parameters[in]		: None
 * Parameters[in/out]	: None
 * Parameters[out]		: None
@@ -98,15 +137,114 @@ extern void TIM_vidT0AttachInterrupt(TIM_tpfvidOverFlowClbk pfvClbk);
 *******************************************************************************************************************/
 extern void TIM_vidT0DeAttachInterrupt(void);
 
+/*****************************************************************************************************************
+* Function				: TIM_u16T0GetIsrMaxUs
+* Description			: Longest Timer 0 overflow ISR (tick bookkeeping and subscribers) since TIM_vidInitT0 or
+						  TIM_vidT0ResetIsrMax, measured from the overflow with the 8 us resolution of the timer.
+						  0x7F8 (255 counts) means an ISR ran past the next tick.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 micro seconds
+*
+*******************************************************************************************************************/
+extern uint16 TIM_u16T0GetIsrMaxUs(void);
+
+/*****************************************************************************************************************
+* Function				: TIM_vidT0ResetIsrMax
+* Description			: Restart the measure of TIM_u16T0GetIsrMaxUs.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*******************************************************************************************************************/
+extern void TIM_vidT0ResetIsrMax(void);
+
+/*****************************************************************************************************************
+* Function				: TIM_u16T0GetInterruptedPc
+* Description			: Word address of the instruction interrupted by the last Timer 0 overflow ISR, tells a
+						  tick subscriber (e.g. the watchdog supervisor) where the main context was running.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 word address (x2 for the byte address of the .lss listing)
+*
+*******************************************************************************************************************/
+extern uint16 TIM_u16T0GetInterruptedPc(void);
+
 /*****************************************************************************************************************
 * Function				: TIM_u32GetMillis
-* Description			: return approximate number of milli seconds elapsed since the initialization of Timer 0
+* Description			: return approximate number of milli seconds elapsed since the initialization of Timer 0,
+						  read atomically (may be called with interrupts enabled or from an ISR)
 * Parameters[in]		: None
 * Parameters[in/out]	: None
 * Parameters[out]		: uint32 approximate number of milli seconds elapsed since the initialization of Timer 0
 *
 *******************************************************************************************************************/
 extern uint32 TIM_u32GetMillis(void);
+/*****************************************************************************************************************
+* Function				: TIM_u32GetMicros
+* Description			: return the number of micro seconds elapsed since the initialization of Timer 0, 8 us
+						  resolution (256 us during a stretched tick). Wraps after 71 minutes, may be called
+						  from an ISR.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint32 micro seconds elapsed since the initialization of Timer 0
+*
+*******************************************************************************************************************/
+extern uint32 TIM_u32GetMicros(void);
+/*****************************************************************************************************************
+* Function				: TIM_u32ElapsedMicros
+* Description			: micro seconds elapsed since a time stamp of TIM_u32GetMicros, right across the wrap of
+						  the counter for intervals shorter than 71 minutes.
+* Parameters[in]		: [u32StartUs] time stamp taken with TIM_u32GetMicros
+* Parameters[in/out]	: None
+* Parameters[out]		: uint32 micro seconds since u32StartUs
+*
+*******************************************************************************************************************/
+extern uint32 TIM_u32ElapsedMicros(uint32 u32StartUs);
+/*****************************************************************************************************************
+* Function				: TIM_u32ElapsedMillis
+* Description			: milli seconds elapsed since a time stamp of TIM_u32GetMillis, right across the wrap of
+						  the counter (49 days).
+* Parameters[in]		: [u32StartMs] time stamp taken with TIM_u32GetMillis
+* Parameters[in/out]	: None
+* Parameters[out]		: uint32 milli seconds since u32StartMs
+*
+*******************************************************************************************************************/
+extern uint32 TIM_u32ElapsedMillis(uint32 u32StartMs);
+/*****************************************************************************************************************
+* Function				: TIM_vidT0StretchTick
+* Description			: Replace the next 1 ms ticks by a single Timer0 overflow u8Ms later (tickless idle).
+						  The milli seconds count is advanced by the real stretched time when the overflow
+						  fires, then the timer goes back to the normal 1 ms tick. Call with interrupts disabled.
+* Parameters[in]		: [u8Ms] length of the stretched tick in ms, Range ( 1 .. TIM_u8T0_STRETCH_MAX_MS )
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*******************************************************************************************************************/
+extern void TIM_vidT0StretchTick(uint8 u8Ms);
+/*****************************************************************************************************************
+* Function				: TIM_vidT0EndStretch
+* Description			: End a stretched tick early (the CPU was woken by another interrupt), the elapsed part
+						  is added to the milli seconds count and the normal 1 ms tick is restarted.
+						  Does nothing if no stretch is active. Call with interrupts disabled.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*******************************************************************************************************************/
+extern void TIM_vidT0EndStretch(void);
+
+/*****************************************************************************************************************
+* Function				: TIM_vidT0AddHaltedUs
+* Description			: Advance the milli seconds count by a time Timer 0 did not count because its clock was
+						  halted (ADC noise reduction sleep, RTC_ePowerSave). The next tick gives it to the
+						  subscribers, at most 255 ms late. Call with interrupts disabled.
+* Parameters[in]		: [u32Us] halted time in us
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*******************************************************************************************************************/
+extern void TIM_vidT0AddHaltedUs(uint32 u32Us);
 
 
 /***************************************************************************************************************
@@ -162,11 +300,76 @@ extern void TIM_vidT1SetPrescaler(uint8 u8TimPrescaler);
 * Description			: Get the current prescaler setting value for timer 1.
 * Parameters[in]		: None
 * Parameters[in/out]	: None
-* Parameters[out]		: uint16
+* Parameters[out]		: uint16 division factor (1, 8, 64, 256, 1024), 0 when stopped or clocked from T1
 *
 *****************************************************************************************************************/
 extern uint16 TIM_u16T1GetPrescaler(void);
 
+/****************************************************************************************************************
+* Function				: TIM_vidT1SetMode
+* Description			: Set the timer 1 waveform generation mode (WGM13:0), the channels mode and the clock
+						  are kept.
+* Parameters[in]		: [u8Mode] Range ( TIM1_Normal .. TIM1_FAST_PWM_TOP_OCR1A )
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*****************************************************************************************************************/
+extern void TIM_vidT1SetMode(uint8 u8Mode);
+
+/****************************************************************************************************************
+* Function				: TIM_u16T1GetTop
+* Description			: TOP of the current timer 1 mode, the duty cycles range from 0 to TOP. An ICR1 waiting
+						  for the next overflow (TIM_vidT1SetTop) is returned.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 TOP value
+*
+*****************************************************************************************************************/
+extern uint16 TIM_u16T1GetTop(void);
+
+/****************************************************************************************************************
+* Function				: TIM_vidT1SetTop
+* Description			: Change the TOP of a timer 1 mode with a variable TOP (the PWM frequency). In the PWM
+						  modes with TOP = ICR1 the new value is written by the overflow ISR, so the current
+						  period ends with the old TOP (ICR1 is not double buffered, a TOP written under TCNT1
+						  would let the counter run up to 0xFFFF). OCR1A is double buffered in the PWM modes and
+						  written now. The fixed TOP modes are left unchanged.
+* Parameters[in]		: [u16Top] Range ( 3 .. 0xFFFF )
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*****************************************************************************************************************/
+extern void TIM_vidT1SetTop(uint16 u16Top);
+
+/****************************************************************************************************************
+* Function				: TIM_eT1PwmInitFreq
+* Description			: Timer1 fast PWM with TOP = ICR1 at the requested frequency on OC1A and OC1B. The
+						  smallest prescaler that fits is taken, for the finest duty resolution: TOP + 1 =
+						  F_CPU / (prescaler * frequency), read it with TIM_u16T1GetTop. The duty cycles start
+						  at 0.
+						  e.g. 20 kHz @ 1 MHz: no prescaler, TOP = 49; 50 Hz @ 1 MHz: no prescaler, TOP = 19999
+* Parameters[in]		: [u32FreqHz] PWM frequency, Range ( F_CPU / (1024 * 65536) .. F_CPU / 4 )
+						  [u8PwmChMode] The desired mode for OC1A, OC1B pins
+						  Range ( TIM1_CHA_CHB_DISCONNECTED , TIM1_CHB_DISCONNECTED,
+						  TIM1_CHA_CHB_NON_INVERTING ,TIM1_CHA_CHB_INVERTING )
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the frequency is out of range
+*
+*****************************************************************************************************************/
+extern STD_ERR_T TIM_eT1PwmInitFreq(uint32 u32FreqHz, uint8 u8PwmChMode);
+
+/****************************************************************************************************************
+* Function				: TIM_eT1SetPwmFreq
+* Description			: Change the frequency of the PWM started by TIM_eT1PwmInitFreq, the prescaler is kept
+						  and the new TOP applies at the end of the current period (TIM_vidT1SetTop). The duty
+						  cycles are not rescaled.
+* Parameters[in]		: [u32FreqHz] PWM frequency
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the frequency does not fit the current prescaler
+*
+*****************************************************************************************************************/
+extern STD_ERR_T TIM_eT1SetPwmFreq(uint32 u32FreqHz);
+
 
 /****************************************************************************************************************
 * Function				: TIM_vidT1PWMOff
@@ -233,11 +436,14 @@ extern void TIM_vidT1PwmBOn(void);
 *
 * Function				: TIM_vidT1PwmASetDuty
 * Description			: Set PWM (output compare) duty for channel A generated on OC1A pin.
+						  In the PWM modes OCR1A is double buffered by the hardware: the new duty applies at
+						  TOP (at BOTTOM in phase and frequency correct mode), never in the middle of a period.
 * Parameters[in]		: [u16PwmDuty] duty for channel A
 						  Range : 
 						  pwmDuty should be in the range 0-255 for 8bit PWM
 						  pwmDuty should be in the range 0-511 for 9bit PWM
 						  pwmDuty should be in the range 0-1023 for 10bit PWM
+						  pwmDuty should be in the range 0-TIM_u16T1GetTop() for the ICR1 TOP modes
 * Parameters[in/out]	: None
 * Parameters[out]		: None
 *
@@ -248,17 +454,64 @@ extern void TIM_vidT1PwmASetDuty(uint16 u16PwmDuty);
 *
 * Function				: TIM_vidT1PwmBSetDuty
 * Description			: Set PWM (output compare) duty for channel B generated on OC1B pin.
+						  In the PWM modes OCR1B is double buffered by the hardware: the new duty applies at
+						  TOP (at BOTTOM in phase and frequency correct mode), never in the middle of a period.
 * Parameters[in]		: [u16PwmDuty] duty for channel B
 						  Range : 
 						  pwmDuty should be in the range 0-255 for 8bit PWM	  
 						  pwmDuty should be in the range 0-511 for 9bit PWM	  
 						  pwmDuty should be in the range 0-1023 for 10bit PWM 
+						  pwmDuty should be in the range 0-TIM_u16T1GetTop() for the ICR1 TOP modes
 * Parameters[in/out]	: None
 * Parameters[out]		: None
 *
 *******************************************************************************************************************/
 extern void TIM_vidT1PwmBSetDuty(uint16 u16PwmDuty);
 
+/*****************************************************************************************************************
+* Function				: TIM_vidT1AttachOvfInterrupt
+* Description			: Attach a routine Call back for timer 1 over flow interrupt, the owner of Timer 1 sets
+						  TOIE1 in TIMSK.
+* Parameters[in]		: [pfvClbk] pointer the Call back routine, NULL to de-attach
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*******************************************************************************************************************/
+extern void TIM_vidT1AttachOvfInterrupt(TIM_tpfvidOverFlowClbk pfvClbk);
+
+/*****************************************************************************************************************
+* Function				: TIM_vidInitT2Ctc
+* Description			: Timer2 in CTC mode (TOP = OCR2), the compare interrupt fires every
+						  (u8Top + 1) * prescaler CPU cycles and calls the attached call back.
+* Parameters[in]		: [u8Prescaler] Range ( TIM2_NO_PRESCALER, TIM2_8_PRESCALER, TIM2_32_PRESCALER,
+						  TIM2_64_PRESCALER, TIM2_128_PRESCALER, TIM2_256_PRESCALER, TIM2_1024_PRESCALER )
+						  [u8Top] compare value
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*******************************************************************************************************************/
+extern void TIM_vidInitT2Ctc(uint8 u8Prescaler, uint8 u8Top);
+
+/*****************************************************************************************************************
+* Function				: TIM_vidT2Stop
+* Description			: Stop Timer2 clock and disable its compare interrupt.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*******************************************************************************************************************/
+extern void TIM_vidT2Stop(void);
+
+/*****************************************************************************************************************
+* Function				: TIM_vidT2AttachCompInterrupt
+* Description			: Attach a routine Call back for timer 2 compare match interrupt
+* Parameters[in]		: [pfvClbk] pointer the Call back routine, NULL to de-attach
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*******************************************************************************************************************/
+extern void TIM_vidT2AttachCompInterrupt(TIM_tpfvidOverFlowClbk pfvClbk);
+
 
 
 
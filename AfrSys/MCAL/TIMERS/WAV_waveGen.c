@@ -0,0 +1,236 @@
+/*! \file WAV_waveGen.c \brief Timer 1 PWM waveform generator playing tables from flash (DDS). */
+/************************************************************************************************************
+*
+* File Name		: 'WAV_waveGen.c'
+* Title			: Timer 1 PWM waveform generator playing tables from flash (DDS)
+* Version		: 1.0
+* Target MCU	: Atmel AVR Series
+*
+************************************************************************************************************/
+
+
+/*------------------------------------------------- INCLUDES ----------------------------------------------*/
+#include "Common_Macros.h"
+
+#include "WAV_waveGen.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+#if (WAV_u8CLOCK_DIV == 1U)
+#define WAV_u8T1_PRESCALER		TIM1_NO_PRESCALER
+#elif (WAV_u8CLOCK_DIV == 8U)
+#define WAV_u8T1_PRESCALER		TIM1_8_PRESCALER
+#elif (WAV_u8CLOCK_DIV == 64U)
+#define WAV_u8T1_PRESCALER		TIM1_64_PRESCALER
+#else
+#error "WAV_u8CLOCK_DIV must be 1, 8 or 64"
+#endif
+
+/* tuning word of 1 Hz: 2^32 / sample rate = 2^40 * WAV_u8CLOCK_DIV / F_CPU, folded by the compiler */
+#define WAV_u32TUNING_PER_HZ	(uint32)((((1ULL << 40) * WAV_u8CLOCK_DIV) + (F_CPU / 2UL)) / F_CPU)
+
+/*---------------------------------------------- Global Variables -----------------------------------------*/
+
+/* sine, 0 .. 255 centered on 127.5 */
+const uint8 WAV_au8Sine[WAV_u16TABLE_SIZE] PROGMEM = {
+	128, 131, 134, 137, 140, 143, 146, 149, 152, 155, 158, 162, 165, 167, 170, 173,
+	176, 179, 182, 185, 188, 190, 193, 196, 198, 201, 203, 206, 208, 211, 213, 215,
+	218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 238, 240, 241, 243, 244,
+	245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255,
+	255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 251, 250, 250, 249, 248, 246,
+	245, 244, 243, 241, 240, 238, 237, 235, 234, 232, 230, 228, 226, 224, 222, 220,
+	218, 215, 213, 211, 208, 206, 203, 201, 198, 196, 193, 190, 188, 185, 182, 179,
+	176, 173, 170, 167, 165, 162, 158, 155, 152, 149, 146, 143, 140, 137, 134, 131,
+	128, 124, 121, 118, 115, 112, 109, 106, 103, 100,  97,  93,  90,  88,  85,  82,
+	 79,  76,  73,  70,  67,  65,  62,  59,  57,  54,  52,  49,  47,  44,  42,  40,
+	 37,  35,  33,  31,  29,  27,  25,  23,  21,  20,  18,  17,  15,  14,  12,  11,
+	 10,   9,   7,   6,   5,   5,   4,   3,   2,   2,   1,   1,   1,   0,   0,   0,
+	  0,   0,   0,   0,   1,   1,   1,   2,   2,   3,   4,   5,   5,   6,   7,   9,
+	 10,  11,  12,  14,  15,  17,  18,  20,  21,  23,  25,  27,  29,  31,  33,  35,
+	 37,  40,  42,  44,  47,  49,  52,  54,  57,  59,  62,  65,  67,  70,  73,  76,
+	 79,  82,  85,  88,  90,  93,  97, 100, 103, 106, 109, 112, 115, 118, 121, 124
+};
+
+/* space vector PWM phase voltage: sine plus the (max + min) / 2 common mode of the 3 phases, full
+   scale at the peak, 15 % more line voltage than the sine at the same DC bus */
+const uint8 WAV_au8SpaceVector[WAV_u16TABLE_SIZE] PROGMEM = {
+	128, 133, 138, 144, 149, 155, 160, 165, 171, 176, 181, 186, 192, 197, 202, 207,
+	212, 217, 222, 227, 232, 236, 239, 240, 242, 243, 244, 246, 247, 248, 249, 250,
+	251, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255, 255, 255, 255, 255, 254,
+	254, 253, 253, 252, 252, 251, 250, 249, 248, 247, 246, 245, 244, 242, 241, 239,
+	238, 239, 241, 242, 244, 245, 246, 247, 248, 249, 250, 251, 252, 252, 253, 253,
+	254, 254, 255, 255, 255, 255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 251,
+	251, 250, 249, 248, 247, 246, 244, 243, 242, 240, 239, 236, 232, 227, 222, 217,
+	212, 207, 202, 197, 192, 186, 181, 176, 171, 165, 160, 155, 149, 144, 138, 133,
+	128, 122, 117, 111, 106, 100,  95,  90,  84,  79,  74,  69,  63,  58,  53,  48,
+	 43,  38,  33,  28,  23,  19,  16,  15,  13,  12,  11,   9,   8,   7,   6,   5,
+	  4,   4,   3,   2,   2,   1,   1,   1,   0,   0,   0,   0,   0,   0,   0,   1,
+	  1,   2,   2,   3,   3,   4,   5,   6,   7,   8,   9,  10,  11,  13,  14,  16,
+	 17,  16,  14,  13,  11,  10,   9,   8,   7,   6,   5,   4,   3,   3,   2,   2,
+	  1,   1,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   2,   2,   3,   4,
+	  4,   5,   6,   7,   8,   9,  11,  12,  13,  15,  16,  19,  23,  28,  33,  38,
+	 43,  48,  53,  58,  63,  69,  74,  79,  84,  90,  95, 100, 106, 111, 117, 122
+};
+
+/* rising ramp (saw tooth) */
+const uint8 WAV_au8Ramp[WAV_u16TABLE_SIZE] PROGMEM = {
+	  0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15,
+	 16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  26,  27,  28,  29,  30,  31,
+	 32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,
+	 48,  49,  50,  51,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,
+	 64,  65,  66,  67,  68,  69,  70,  71,  72,  73,  74,  75,  76,  77,  78,  79,
+	 80,  81,  82,  83,  84,  85,  86,  87,  88,  89,  90,  91,  92,  93,  94,  95,
+	 96,  97,  98,  99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111,
+	112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127,
+	128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143,
+	144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159,
+	160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175,
+	176, 177, 178, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191,
+	192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207,
+	208, 209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221, 222, 223,
+	224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239,
+	240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, 255
+};
+
+static const uint8 *pu8WavTableA = WAV_au8Sine;
+static const uint8 *pu8WavTableB = NULL;
+static uint8 u8WavPhaseB;
+
+/* phase accumulator, only used by the ISR, and its step per sample */
+static uint32 u32WavPhase;
+static uint32 u32WavTuning;
+
+/*-------------------------------------------- FUNCTION Definitions ---------------------------------------*/
+
+/*************************************************************************************************************
+* Function				: WAV_vidStep
+* Description			: Per sample step run by the Timer 1 overflow ISR: advance the phase and write the next
+						  samples. Public so it can be benchmarked on its own.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WAV_vidStep(void)
+{
+	uint8 u8Index;
+
+	u32WavPhase += u32WavTuning;
+	u8Index = (uint8)(u32WavPhase >> 24);
+	/* full 16-bit writes, a low byte alone would take the high byte from the shared TEMP register */
+	OCR1A = pgm_read_byte(&pu8WavTableA[u8Index]);
+	if (pu8WavTableB != NULL){
+		OCR1B = pgm_read_byte(&pu8WavTableB[(uint8)(u8Index - u8WavPhaseB)]);
+	}
+}
+
+/*************************************************************************************************************
+* Function				: WAV_vidInit
+* Description			: Timer 1 in 8-bit fast PWM with the WAV_u8CLOCK_DIV prescaler, both outputs at 0 until
+						  WAV_vidStart.
+* Parameters[in]		: [u8PwmChMode] The desired mode for OC1A, OC1B pins
+						  Range ( TIM1_CHA_CHB_NON_INVERTING ,TIM1_CHA_CHB_INVERTING )
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WAV_vidInit(uint8 u8PwmChMode)
+{
+	WAV_vidStop();
+	TIM_vidT1PWMInit(8, u8PwmChMode, WAV_u8T1_PRESCALER);
+}
+
+/*************************************************************************************************************
+* Function				: WAV_eSetTables
+* Description			: Select the tables played on OC1A and OC1B, may be called while the generator runs.
+* Parameters[in]		: [pu8TableA] table in flash of WAV_u16TABLE_SIZE samples for OC1A
+						  [pu8TableB] table in flash for OC1B, NULL to leave OC1B alone
+						  [u8PhaseB] phase of OC1B behind OC1A in samples (e.g. WAV_u8PHASE_90_DEG)
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if pu8TableA is NULL
+*
+**************************************************************************************************************/
+extern STD_ERR_T WAV_eSetTables(const uint8 *pu8TableA, const uint8 *pu8TableB, uint8 u8PhaseB)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint8 u8Sreg;
+
+	if (pu8TableA != NULL){
+		u8Sreg = SREG;
+		/* 2 bytes pointers read by the ISR */
+		cli();
+		pu8WavTableA = pu8TableA;
+		pu8WavTableB = pu8TableB;
+		u8WavPhaseB = u8PhaseB;
+		SREG = u8Sreg;
+		errRetVal = STD_ERR_OK;
+	}
+	return errRetVal;
+}
+
+/*************************************************************************************************************
+* Function				: WAV_eSetFrequency
+* Description			: Set the output frequency, applied from the next sample without a phase jump.
+* Parameters[in]		: [u32MilliHz] frequency in mHz (1 Hz = 1000), Range (0 - WAV_u32MAX_FREQ_MHZ)
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK above WAV_u32MAX_FREQ_MHZ
+*
+**************************************************************************************************************/
+extern STD_ERR_T WAV_eSetFrequency(uint32 u32MilliHz)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint32 u32Tuning;
+	uint32 u32Fraction;
+	uint8 u8Sreg;
+
+	if (u32MilliHz <= WAV_u32MAX_FREQ_MHZ){
+		/* whole Hz then the mHz, the mHz product is split to fit 32 bits with a clock divider */
+		u32Fraction = u32MilliHz % 1000UL;
+		u32Tuning = ((u32MilliHz / 1000UL) * WAV_u32TUNING_PER_HZ) +
+					(u32Fraction * (WAV_u32TUNING_PER_HZ / 1000UL)) +
+					((u32Fraction * (WAV_u32TUNING_PER_HZ % 1000UL)) / 1000UL);
+		u8Sreg = SREG;
+		/* 4 bytes read by the ISR */
+		cli();
+		u32WavTuning = u32Tuning;
+		SREG = u8Sreg;
+		errRetVal = STD_ERR_OK;
+	}
+	return errRetVal;
+}
+
+/*************************************************************************************************************
+* Function				: WAV_vidStart
+* Description			: Restart the waveform from the first sample and enable the Timer 1 overflow interrupt.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WAV_vidStart(void)
+{
+	uint8 u8Sreg = SREG;
+
+	cli();
+	u32WavPhase = 0U - u32WavTuning;
+	/* first sample for the next period */
+	WAV_vidStep();
+	TIM_vidT1AttachOvfInterrupt(WAV_vidStep);
+	TIFR = (1<<TOV1);
+	SET_BIT(TIMSK, TOIE1);
+	SREG = u8Sreg;
+}
+
+/*************************************************************************************************************
+* Function				: WAV_vidStop
+* Description			: Disable the overflow interrupt, the outputs keep the last sample.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WAV_vidStop(void)
+{
+	CLEAR_BIT(TIMSK, TOIE1);
+	TIM_vidT1AttachOvfInterrupt(NULL);
+}
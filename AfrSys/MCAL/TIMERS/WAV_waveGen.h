@@ -0,0 +1,138 @@
+/*! \file WAV_waveGen.h \brief Timer 1 PWM waveform generator playing tables from flash (DDS). */
+/*************************************************************************************************************
+*
+* File Name		: 'WAV_waveGen.h'
+* Title			: Timer 1 PWM waveform generator playing tables from flash (DDS)
+* Version		: 1.0
+* Target MCU	: Atmel AVR Series
+*
+*  Timer 1 runs in 8-bit fast PWM clocked at F_CPU / WAV_u8CLOCK_DIV, every PWM period is one sample:
+*  F_CPU / 256 / WAV_u8CLOCK_DIV samples per second (3906.25 Hz @ 1 MHz without prescaler). The overflow ISR
+*  adds the tuning word to a 32-bit phase accumulator and its top 8 bits index a 256 entries table in flash:
+*
+*	TIMER1_OVF --> phase += tuning --> table[phase >> 24] --> OCR1A (OCR1B: table[(phase >> 24) + offset])
+*
+*  OCR1A/B are double buffered by the hardware, the sample written in the ISR is output on the next period.
+*  The tuning word is the only thing changed with the frequency (f = tuning * sample rate / 2^32, 0.9 uHz
+*  steps @ 1 MHz), the tables are never recomputed. OC1A (PB1) and OC1B (PB2) must be set as outputs.
+*
+*  CPU load: the TIMER1_OVF_vect ISR costs in the order of 120 cycles per sample (register saves of the call
+*  back, both channels; a count from the code, the TIMER1_OVF_vect row of tools/bench measures it), close to
+*  half of the CPU with WAV_u8CLOCK_DIV 1, about 6 % with 8 and under 1 % with 64. It also delays the 1 ms tick and the UART ISRs by up to one sample ISR. A divider
+*  lowers the PWM carrier as much as the sample rate (488 Hz with 8 @ 1 MHz), the output filter must follow.
+*
+*  Timer 1 is taken from the other PWM and the input capture users while the generator runs.
+*
+*************************************************************************************************************/
+#ifndef WAV_WAVEGEN_H_
+#define WAV_WAVEGEN_H_
+
+
+/*---------------------------------------------------- INCLUDES --------------------------------------------*/
+
+#include <avr/pgmspace.h>
+#include "MCU.h"
+#include "Std_Types.h"
+#include "TIM_timers.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+/* samples per table (one waveform period), indexed by the top 8 bits of the phase */
+#define WAV_u16TABLE_SIZE		256U
+
+/* Timer 1 prescaler (1, 8 or 64): divides the sample rate and the ISR load */
+#ifndef WAV_u8CLOCK_DIV
+#define WAV_u8CLOCK_DIV			1U
+#endif
+
+/* CPU cycles per sample: one 8-bit PWM period */
+#define WAV_u32SAMPLE_CYCLES	(256UL * WAV_u8CLOCK_DIV)
+
+/* sample rate in milli Hertz */
+#define WAV_u32SAMPLE_RATE_MHZ	(uint32)(((F_CPU / WAV_u32SAMPLE_CYCLES) * 1000UL) + \
+										 (((F_CPU % WAV_u32SAMPLE_CYCLES) * 1000UL) / WAV_u32SAMPLE_CYCLES))
+
+/* highest output frequency (Nyquist) in milli Hertz */
+#define WAV_u32MAX_FREQ_MHZ		(uint32)(WAV_u32SAMPLE_RATE_MHZ / 2UL)
+
+/* phase offset of channel B for two phase outputs, in table samples */
+#define WAV_u8PHASE_90_DEG		64U
+#define WAV_u8PHASE_120_DEG		85U
+#define WAV_u8PHASE_180_DEG		128U
+
+/*------------------------------------------ Global Variables -------------------------------------------------*/
+
+/* waveform tables in flash, samples 0 .. 255 */
+extern const uint8 WAV_au8Sine[WAV_u16TABLE_SIZE] PROGMEM;
+extern const uint8 WAV_au8SpaceVector[WAV_u16TABLE_SIZE] PROGMEM;
+extern const uint8 WAV_au8Ramp[WAV_u16TABLE_SIZE] PROGMEM;
+
+/*--------------------------------------------- FUNCTION Definitions ----------------------------------------*/
+
+/*************************************************************************************************************
+* Function				: WAV_vidInit
+* Description			: Timer 1 in 8-bit fast PWM with the WAV_u8CLOCK_DIV prescaler, both outputs at 0 until
+						  WAV_vidStart.
+* Parameters[in]		: [u8PwmChMode] The desired mode for OC1A, OC1B pins
+						  Range ( TIM1_CHA_CHB_NON_INVERTING ,TIM1_CHA_CHB_INVERTING )
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WAV_vidInit(uint8 u8PwmChMode);
+
+/*************************************************************************************************************
+* Function				: WAV_eSetTables
+* Description			: Select the tables played on OC1A and OC1B, may be called while the generator runs.
+* Parameters[in]		: [pu8TableA] table in flash of WAV_u16TABLE_SIZE samples for OC1A
+						  [pu8TableB] table in flash for OC1B, NULL to leave OC1B alone
+						  [u8PhaseB] phase of OC1B behind OC1A in samples (e.g. WAV_u8PHASE_90_DEG)
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if pu8TableA is NULL
+*
+**************************************************************************************************************/
+extern STD_ERR_T WAV_eSetTables(const uint8 *pu8TableA, const uint8 *pu8TableB, uint8 u8PhaseB);
+
+/*************************************************************************************************************
+* Function				: WAV_eSetFrequency
+* Description			: Set the output frequency, applied from the next sample without a phase jump.
+* Parameters[in]		: [u32MilliHz] frequency in mHz (1 Hz = 1000), Range (0 - WAV_u32MAX_FREQ_MHZ)
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK above WAV_u32MAX_FREQ_MHZ
+*
+**************************************************************************************************************/
+extern STD_ERR_T WAV_eSetFrequency(uint32 u32MilliHz);
+
+/*************************************************************************************************************
+* Function				: WAV_vidStart
+* Description			: Restart the waveform from the first sample and enable the Timer 1 overflow interrupt.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WAV_vidStart(void);
+
+/*************************************************************************************************************
+* Function				: WAV_vidStop
+* Description			: Disable the overflow interrupt, the outputs keep the last sample.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WAV_vidStop(void);
+
+/*************************************************************************************************************
+* Function				: WAV_vidStep
+* Description			: Per sample step run by the Timer 1 overflow ISR: advance the phase and write the next
+						  samples. Public so it can be benchmarked on its own.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WAV_vidStep(void);
+
+
+#endif /* WAV_WAVEGEN_H_ */
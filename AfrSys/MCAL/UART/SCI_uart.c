@@ -30,15 +30,91 @@
 
 
 
+#define u8TX_BUFFER_MASK	(u8TX_BUFFER_SIZE - 1U)
+#define u8RX_BUFFER_MASK	(u8RX_BUFFER_SIZE - 1U)
+
+#if ((u8TX_BUFFER_SIZE & u8TX_BUFFER_MASK) != 0U) || (u8TX_BUFFER_SIZE > 128U)
+#error "u8TX_BUFFER_SIZE must be a power of two not larger than 128"
+#endif
+#if ((u8RX_BUFFER_SIZE & u8RX_BUFFER_MASK) != 0U) || (u8RX_BUFFER_SIZE > 128U)
+#error "u8RX_BUFFER_SIZE must be a power of two not larger than 128"
+#endif
+
 /*------------------------------------------ Global Variables ---------------------------------------------*/
 
-uint8 au8UartTransmitBuffer[u8TX_BUFFER_SIZE]={0};
-uint8 u8TransmitBufferIndex = 0;
+/* Rings with free running 8-bit indices (masked on access): the head is written by the producer and the
+   tail by the consumer. The RX ring has a single producer (RXC ISR) and consumer, every update is a single
+   atomic byte store. The TX ring may be fed from the main loop and from ISRs (INFO in a call back), so
+   UART_u8Write and UART_u8WriteAll copy and publish with the interrupts disabled. */
+static uint8 au8UartTxRing[u8TX_BUFFER_SIZE];
+static volatile uint8 u8UartTxHead = 0;		/* written by UART_u8TxQueue	*/
+static volatile uint8 u8UartTxTail = 0;		/* written by UDRE ISR		*/
+/* a frame was written to UDR since UART_init, TXC is meaningful */
+static volatile boolean bUartTxStarted = FALSE;
+
+static uint8 au8UartRxRing[u8RX_BUFFER_SIZE];
+static volatile uint8 u8UartRxHead = 0;		/* written by RXC ISR		*/
+static volatile uint8 u8UartRxTail = 0;		/* written by UART_u8Read	*/
+
+/*-------------------------------------Static functions Definitions ---------------------------------------*/
+
+/* Send the oldest byte of the TX ring, common body of the UDRE ISR and the polled fall back */
+static inline void UART_vidTxNext(void)
+{
+	uint8 u8Tail = u8UartTxTail;
+
+	/* TXC is cleared by a one, it is set again once this frame is out */
+	UCSRA = (uint8)((UCSRA & ((1<<U2X) | (1<<MPCM))) | (1<<TXC));
+	bUartTxStarted = TRUE;
+	UDR = au8UartTxRing[u8Tail & u8TX_BUFFER_MASK];
+	u8Tail++;
+	u8UartTxTail = u8Tail;
+	if (u8Tail == u8UartTxHead){
+		/* ring drained, stop the UDRE interrupt until new data is queued */
+		CLEAR_BIT(UCSRB,UDRIE);
+	}
+}
 
-uint8 au8UartReceiveBuffer[u8RX_BUFFER_SIZE]={0};
-uint8 u8ReceiveBufferIndex = 0;
+/* Make room in a full TX ring. With interrupts enabled the UDRE ISR does it, inside an ISR or a critical
+   section it never will, so push one byte out by polling UDRE instead */
+static void UART_vidTxWaitSpace(void)
+{
+	if (BIT_IS_CLEAR(SREG,SREG_I)){
+		while(!(UCSRA & (1<<UDRE))){}
+		UART_vidTxNext();
+	} else {
+		MCU_IDLE_HOOK();
+	}
+}
 
-/*---------------------------------------- FUNCTION Definitions -------------------------------------------*/
+/* Copy bytes into the TX ring and publish them, common body of UART_u8Write and UART_u8WriteAll. With
+   bWhole set nothing is queued unless all u8Len bytes fit */
+static uint8 UART_u8TxQueue(const uint8 *pu8Data, uint8 u8Len, boolean bWhole)
+{
+	uint8 u8Sreg = SREG;
+	uint8 u8Head;
+	uint8 u8Free;
+	uint8 u8Count;
+
+	/* another producer (ISR) must not claim the same free space between the read and the publish */
+	cli();
+	u8Head = u8UartTxHead;
+	u8Free = (uint8)(u8TX_BUFFER_SIZE - (uint8)(u8Head - u8UartTxTail));
+	if (u8Len > u8Free){
+		u8Len = (bWhole != FALSE) ? 0U : u8Free;
+	}
+	for (u8Count = 0; u8Count < u8Len; u8Count++){
+		au8UartTxRing[u8Head & u8TX_BUFFER_MASK] = pu8Data[u8Count];
+		u8Head++;
+	}
+	if (u8Len != 0U){
+		/* publish the new bytes then (re)start the UDRE interrupt */
+		u8UartTxHead = u8Head;
+		SET_BIT(UCSRB,UDRIE);
+	}
+	SREG = u8Sreg;
+	return u8Len;
+}
 
 /************************************************************************************************************
 * Function				: UART_init
@@ -58,9 +134,8 @@ extern void UART_init(uint16 u16BaudRate)
 	SET_BIT(UCSRB,RXEN);
 	SET_BIT(UCSRB,TXEN);
 	
-	/* enable UART as transmitter and receiver interrupts*/
+	/* enable UART receive interrupt, the UDRE interrupt is only enabled while the TX ring holds data */
 	SET_BIT(UCSRB,RXCIE);
-	SET_BIT(UCSRB,TXCIE);
 	
 	/* 8-bit data, NO parity, one stop bit and async*/
 	SET_BIT(UCSRC,URSEL);
@@ -76,8 +151,8 @@ extern void UART_init(uint16 u16BaudRate)
 
 /************************************************************************************************************
 * Function				: UART_sendByte
-* Description			: Wait for UDRE flag to be set indicating that the buffer is empty and ready for 
-						  transmitting then send one byte.
+* Description			: Queue one byte in the TX ring buffer, waiting only if the ring is full. When called
+						  with interrupts disabled the ring is drained by polling UDRE instead of the ISR.
 * Parameters[in]		: [u8Char] the data byte to send through UART
 * Parameters[in/out]	: None
 * Parameters[out]		: None
@@ -85,17 +160,104 @@ extern void UART_init(uint16 u16BaudRate)
 *************************************************************************************************************/
 extern void UART_sendByte(uint8 u8Char)
 {
-	/*UDRE flag is set when the buffer is empty and 
-	ready for transmitting a new byte so wait until this flag is set to one*/
-	while(!(UCSRA & (1<<UDRE))){}
-	SET_BIT(UCSRB,TXEN);  /// test
-	UDR = u8Char;
-	CLEAR_BIT(UCSRB,TXEN); /// test
+	while(UART_u8Write(&u8Char, 1U) == 0U){
+		UART_vidTxWaitSpace();
+	}
 }
 
 /************************************************************************************************************
-* Function				: UART_sendByte
-* Description			: Blocking receive one byte from UART.
+* Function				: UART_u8Write
+* Description			: Non-blocking write, copy as many bytes as fit into the TX ring buffer and let the
+						  UDRE interrupt send them. May be called from an ISR: the bytes of one call are never
+						  mixed with the bytes of another producer, the interrupts are disabled for the copy
+						  (at most u8TX_BUFFER_SIZE bytes).
+* Parameters[in]		: [pu8Data] pointer to the bytes to send
+						  [u8Len] number of bytes to send
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 number of bytes accepted into the TX ring buffer (0 .. u8Len)
+*
+*************************************************************************************************************/
+extern uint8 UART_u8Write(const uint8 *pu8Data, uint8 u8Len)
+{
+	return UART_u8TxQueue(pu8Data, u8Len, FALSE);
+}
+
+/************************************************************************************************************
+* Function				: UART_u8WriteAll
+* Description			: Non-blocking all or nothing write, queue the u8Len bytes only if all of them fit in
+						  the TX ring buffer. The free space check and the copy are one critical section so a
+						  producer in an ISR can not take the space in between. May be called from an ISR.
+* Parameters[in]		: [pu8Data] pointer to the bytes to send
+						  [u8Len] number of bytes to send
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 u8Len when the bytes were queued, 0 when nothing was queued
+*
+*************************************************************************************************************/
+extern uint8 UART_u8WriteAll(const uint8 *pu8Data, uint8 u8Len)
+{
+	return UART_u8TxQueue(pu8Data, u8Len, TRUE);
+}
+
+/************************************************************************************************************
+* Function				: UART_u8GetTxFree
+* Description			: Return the number of bytes that can currently be queued without waiting.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 free space in the TX ring buffer
+*
+*************************************************************************************************************/
+extern uint8 UART_u8GetTxFree(void)
+{
+	return (uint8)(u8TX_BUFFER_SIZE - (uint8)(u8UartTxHead - u8UartTxTail));
+}
+
+/************************************************************************************************************
+* Function				: UART_vidTxFlush
+* Description			: Wait until the TX ring is empty and the last frame has left the shift register (TXC).
+						  With interrupts disabled the ring is drained by polling UDRE.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void UART_vidTxFlush(void)
+{
+	while (u8UartTxHead != u8UartTxTail){
+		UART_vidTxWaitSpace();
+	}
+	if (bUartTxStarted != FALSE){
+		while(!(UCSRA & (1<<TXC))){}
+	}
+}
+
+/************************************************************************************************************
+* Function				: UART_u8Read
+* Description			: Non-blocking read, copy up to u8Len received bytes out of the RX ring buffer.
+* Parameters[in]		: [u8Len] size of the destination buffer
+* Parameters[in/out]	: [pu8Data] pointer to the buffer receiving the bytes
+* Parameters[out]		: uint8 number of bytes copied (0 .. u8Len)
+*
+*************************************************************************************************************/
+extern uint8 UART_u8Read(uint8 *pu8Data, uint8 u8Len)
+{
+	uint8 u8Tail = u8UartRxTail;
+	uint8 u8Available = (uint8)(u8UartRxHead - u8Tail);
+	uint8 u8Count;
+
+	if (u8Len > u8Available){
+		u8Len = u8Available;
+	}
+	for (u8Count = 0; u8Count < u8Len; u8Count++){
+		pu8Data[u8Count] = au8UartRxRing[u8Tail & u8RX_BUFFER_MASK];
+		u8Tail++;
+	}
+	u8UartRxTail = u8Tail;
+	return u8Len;
+}
+
+/************************************************************************************************************
+* Function				: UART_recieveByte
+* Description			: Blocking receive one byte from UART (taken from the RX ring buffer).
 * Parameters[in]		: None
 * Parameters[in/out]	: None
 * Parameters[out]		: [u8Char] the data byte received from the UART channel
@@ -103,19 +265,23 @@ extern void UART_sendByte(uint8 u8Char)
 *************************************************************************************************************/
 extern char UART_recieveByte(void)
 {
-	/*RXC flag is set when the UART receive data so until this flag is set to one*/
-	SET_BIT(UCSRB,RXEN); /// test
-	while(!(UCSRA & (1<<RXC))){}
-	CLEAR_BIT(UCSRB,RXEN); /// test
-	return UDR;
+	uint8 u8Char;
+
+	while(UART_u8Read(&u8Char, 1U) == 0U){
+		if (BIT_IS_CLEAR(SREG,SREG_I) && (UCSRA & (1<<RXC))){
+			/* the RXC ISR can not run here, take the byte straight from the data register */
+			u8Char = UDR;
+			break;
+		}
+		MCU_IDLE_HOOK();
+	}
+	return (char)u8Char;
 }
 
 /************************************************************************************************************
 * Function				: UART_sendString
-* Description			: Send a string via UART in interrupt driven manner using buffers to store the string
-						  and start sending one byte. After first one byte is sent the interrupt is generated
-						  and the following byte will be transmitted from the ISR till all bytes stored in the
-						  TX buffer are sent
+* Description			: Send a string via UART in interrupt driven manner by queuing it in the TX ring buffer,
+						  the UDRE interrupt transmits the queued bytes. Waits only while the ring is full.
 * Parameters[in]		: [u8ptrTxString] pointer to the string to send through UART
 * Parameters[in/out]	: None
 * Parameters[out]		: None
@@ -123,8 +289,20 @@ extern char UART_recieveByte(void)
 *************************************************************************************************************/
 extern void UART_sendString(const char *u8ptrTxString)
 {
-	strcpy(au8UartTransmitBuffer,u8ptrTxString);
-	UART_sendByte(u8ptrTxString[0]);
+	const uint8 *pu8Data = (const uint8 *)u8ptrTxString;
+	uint16 u16Remaining = (uint16)strlen(u8ptrTxString);
+	uint8 u8Chunk;
+	uint8 u8Sent;
+
+	while(u16Remaining != 0U){
+		u8Chunk = (u16Remaining > u8TX_BUFFER_SIZE) ? u8TX_BUFFER_SIZE : (uint8)u16Remaining;
+		u8Sent = UART_u8Write(pu8Data, u8Chunk);
+		pu8Data += u8Sent;
+		u16Remaining -= u8Sent;
+		if (u8Sent == 0U){
+			UART_vidTxWaitSpace();
+		}
+	}
 }
 
 /************************************************************************************************************
@@ -147,26 +325,22 @@ extern void UART_receiveString(char *a_str_Ptr)
 	a_str_Ptr[i] = '#';
 }
 
-ISR(USART_TXC_vect){
-	u8TransmitBufferIndex++;
-	if(au8UartTransmitBuffer[u8TransmitBufferIndex] != '\0'){
-		UART_sendByte(au8UartTransmitBuffer[u8TransmitBufferIndex]);
+ISR(USART_UDRE_vect){
+	if (u8UartTxTail != u8UartTxHead){
+		UART_vidTxNext();
 	} else {
-		u8TransmitBufferIndex = 0;
-		memset(au8UartTransmitBuffer, '\0',u8TX_BUFFER_SIZE);
+		CLEAR_BIT(UCSRB,UDRIE);
 	}
 }
 
 ISR(USART_RXC_vect){
-	char recData=UDR;
-	if(recData == '\r' || recData == '\n'){			
-	} else {	
-		if(u8ReceiveBufferIndex <= u8RX_BUFFER_SIZE){
-			au8UartReceiveBuffer[u8ReceiveBufferIndex]=recData;
-			u8ReceiveBufferIndex++;
-		} else {
-							
-		}		
+	uint8 u8Data = UDR;
+	uint8 u8Head = u8UartRxHead;
+
+	if ((uint8)(u8Head - u8UartRxTail) < u8RX_BUFFER_SIZE){
+		au8UartRxRing[u8Head & u8RX_BUFFER_MASK] = u8Data;
+		u8UartRxHead = u8Head + 1U;
+	} else {
+		/* ring full, the byte is dropped */
 	}
 }
-
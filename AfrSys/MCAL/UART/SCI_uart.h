@@ -24,8 +24,9 @@
 
 /*----------------------------------------- MACROS Definitions --------------------------------------------*/
 
-#define u8TX_BUFFER_SIZE  100U
-#define u8RX_BUFFER_SIZE  100U
+/* ring buffer sizes, must be a power of two and not larger than 128 bytes */
+#define u8TX_BUFFER_SIZE  64U
+#define u8RX_BUFFER_SIZE  32U
 
 /*------------------------------------------ Global Variables ---------------------------------------------*/
 
@@ -45,8 +46,8 @@ extern void UART_init(uint16 u16BaudRate);
 
 /************************************************************************************************************
 * Function				: UART_sendByte
-* Description			: Wait for UDRE flag to be set indicating that the buffer is empty and ready for 
-						  transmitting then send one byte.
+* Description			: Queue one byte in the TX ring buffer, waiting only if the ring is full. When called
+						  with interrupts disabled the ring is drained by polling UDRE instead of the ISR.
 * Parameters[in]		: [u8Char] the data byte to send through UART
 * Parameters[in/out]	: None
 * Parameters[out]		: None
@@ -54,12 +55,68 @@ extern void UART_init(uint16 u16BaudRate);
 *************************************************************************************************************/
 extern void UART_sendByte(uint8 u8Char);
 
+/************************************************************************************************************
+* Function				: UART_u8Write
+* Description			: Non-blocking write, copy as many bytes as fit into the TX ring buffer and let the
+						  UDRE interrupt send them. May be called from an ISR: the bytes of one call are never
+						  mixed with the bytes of another producer, the interrupts are disabled for the copy
+						  (at most u8TX_BUFFER_SIZE bytes).
+* Parameters[in]		: [pu8Data] pointer to the bytes to send
+						  [u8Len] number of bytes to send
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 number of bytes accepted into the TX ring buffer (0 .. u8Len)
+*
+*************************************************************************************************************/
+extern uint8 UART_u8Write(const uint8 *pu8Data, uint8 u8Len);
+
+/************************************************************************************************************
+* Function				: UART_u8WriteAll
+* Description			: Non-blocking all or nothing write, queue the u8Len bytes only if all of them fit in
+						  the TX ring buffer. The free space check and the copy are one critical section so a
+						  producer in an ISR can not take the space in between. May be called from an ISR.
+* Parameters[in]		: [pu8Data] pointer to the bytes to send
+						  [u8Len] number of bytes to send
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 u8Len when the bytes were queued, 0 when nothing was queued
+*
+*************************************************************************************************************/
+extern uint8 UART_u8WriteAll(const uint8 *pu8Data, uint8 u8Len);
+
+/************************************************************************************************************
+* Function				: UART_u8GetTxFree
+* Description			: Return the number of bytes that can currently be queued without waiting.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 free space in the TX ring buffer
+*
+*************************************************************************************************************/
+extern uint8 UART_u8GetTxFree(void);
+
+/************************************************************************************************************
+* Function				: UART_vidTxFlush
+* Description			: Wait until the TX ring is empty and the last frame has left the shift register (TXC).
+						  With interrupts disabled the ring is drained by polling UDRE.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void UART_vidTxFlush(void);
+
+/************************************************************************************************************
+* Function				: UART_u8Read
+* Description			: Non-blocking read, copy up to u8Len received bytes out of the RX ring buffer.
+* Parameters[in]		: [u8Len] size of the destination buffer
+* Parameters[in/out]	: [pu8Data] pointer to the buffer receiving the bytes
+* Parameters[out]		: uint8 number of bytes copied (0 .. u8Len)
+*
+*************************************************************************************************************/
+extern uint8 UART_u8Read(uint8 *pu8Data, uint8 u8Len);
+
 /************************************************************************************************************
 * Function				: UART_sendString
-* Description			: Send a string via UART in interrupt driven manner using buffers to store the string
-						  and start sending one byte. After first one byte is sent the interrupt is generated
-						  and the following byte will be transmitted from the ISR till all bytes stored in the
-						  TX buffer are sent
+* Description			: Send a string via UART in interrupt driven manner by queuing it in the TX ring buffer,
+						  the UDRE interrupt transmits the queued bytes. Waits only while the ring is full.
 * Parameters[in]		: [u8ptrTxString] pointer to the string to be sent through UART
 * Parameters[in/out]	: None
 * Parameters[out]		: None
@@ -68,8 +125,8 @@ extern void UART_sendByte(uint8 u8Char);
 extern void UART_sendString(const char *u8ptrTxString);
 
 /************************************************************************************************************
-* Function				: UART_sendByte
-* Description			: Blocking receive one byte from UART.
+* Function				: UART_recieveByte
+* Description			: Blocking receive one byte from UART (taken from the RX ring buffer).
 * Parameters[in]		: None
 * Parameters[in/out]	: None
 * Parameters[out]		: [u8Char] the data byte received from the UART channel
@@ -36,19 +36,27 @@
 
 /*--------------------------------------------- MACROS Definitions ------------------------------------------*/
 
-
+/* marks a valid crash record, the .noinit section holds random values after a power on */
+#define MCU_u16CRASH_MAGIC		(uint16)0xC5A3
 
 /*---------------------------------------------- Global Variables -------------------------------------------*/
 
 /* Var. to count the number of the nested critical sections */
 static uint8 MCU_u8NoOfInterrDisabled = (uint8)0x00;
+/* the I bit was set when the outermost critical section was entered (not called from an ISR) */
+static boolean MCU_bInterrWereEnabled = FALSE;
+
+/* not cleared by the start up code, so they survive a watchdog reset */
+static MCU_tstrCrashRecord MCU_strCrashRecord __attribute__((section(".noinit")));
+static uint16 MCU_u16CrashMagic __attribute__((section(".noinit")));
 
 
 /*--------------------------------------------- FUNCTION Definitions ----------------------------------------*/
 
 /*************************************************************************************************************
 * Function				: MCU_vidResetSrcCheck
-* Description			: Check the source of last reset and perform necessary actions
+* Description			: Check the source of last reset and perform necessary actions, a watchdog reset also
+						  reports the crash record saved before it (if any)
 * Parameters[in]		: None
 * Parameters[in/out]	: None
 * Parameters[out]		: None.
@@ -83,10 +91,26 @@ extern void MCU_vidResetSrcCheck(void){
 		/* Watchdog Reset */
 		MCUCSR=0;
 
-		INFO("Watchdog Reset");
+		if (MCU_u16CrashMagic != MCU_u16CRASH_MAGIC)
+		{
+			INFO("Watchdog Reset");
+		}
+		else if (MCU_strCrashRecord.u8Cause == MCU_u8CRASH_TASK_WINDOW)
+		{
+			/* the pc is printed as a byte address to be looked up in the .lss listing */
+			INFO("Watchdog Reset: task %u missed its window", MCU_strCrashRecord.u8TaskId);
+			INFO("running task %u pc 0x%04x tick %lu ms", MCU_strCrashRecord.u8RunningTaskId,
+				 (uint16)(MCU_strCrashRecord.u16Pc << 1), MCU_strCrashRecord.u32TickMs);
+		}
+		else
+		{
+			INFO("Watchdog Reset: requested from pc 0x%04x", (uint16)(MCU_strCrashRecord.u16Pc << 1));
+		}
 	} else {
 		INFO("UNKNOWN RESET");
 	}
+	/* a record is reported once */
+	MCU_u16CrashMagic = 0U;
 }
 
 /************************************************************************************************************
@@ -102,6 +126,7 @@ extern void MCU_vidDisableInterrupts(void)
 {
 	if(MCU_u8NoOfInterrDisabled == (uint8)0)
 	{
+		MCU_bInterrWereEnabled = (SREG & (1<<SREG_I)) ? TRUE : FALSE;
 		cli();
 		MCU_u8NoOfInterrDisabled ++;
 	}
@@ -141,6 +166,43 @@ extern void MCU_vidEnableInterrupts( void )
 	
 }
 
+/*************************************************************************************************************
+* Function				: MCU_eSleep
+* Description			: Put the CPU in the given sleep mode until the next interrupt. Must be called inside
+						  exactly one MCU_vidDisableInterrupts section, interrupts are enabled only by the
+						  sleep instruction itself so a wake up event that fires after the caller's last check
+						  can not be missed. The section is still active (interrupts disabled) on return.
+						  Refuses to sleep if the interrupts were already disabled when the section was entered
+						  (ISR or start up code): the sleep would enable them.
+* Parameters[in]		: [u8SleepMode] SLEEP_MODE_IDLE, SLEEP_MODE_ADC, SLEEP_MODE_PWR_SAVE, ... (avr/sleep.h)
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if not called from a single (non nested) critical section
+						  entered with the interrupts enabled
+*
+**************************************************************************************************************/
+extern STD_ERR_T MCU_eSleep(uint8 u8SleepMode)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+
+	/* sleeping inside a nested section or an ISR would return to the caller with interrupts enabled */
+	if((MCU_u8NoOfInterrDisabled == (uint8)1) && (MCU_bInterrWereEnabled != FALSE))
+	{
+		set_sleep_mode(u8SleepMode);
+		sleep_enable();
+		/* the instruction after sei is always executed before any pending interrupt */
+		sei();
+		sleep_cpu();
+		sleep_disable();
+		cli();
+		errRetVal = STD_ERR_OK;
+	}
+	else
+	{
+
+	}
+	return errRetVal;
+}
+
 /************************************************************************************************************
 * Function				: MCU_vidDelay_1_us
 * Description			: Cause a delay of almost 1 us
@@ -171,14 +233,50 @@ extern void MCU_vidDelay_10_us(void) {
 
 /*************************************************************************************************************
 * Function				: MCU_vidResetCpu
-* Description			: Cause a reset for the MCU
+* Description			: Cause a reset for the MCU through the watchdog (15 ms), does not return. Reported as
+						  MCU_u8CRASH_RESET_REQUEST after the reboot.
 * Parameters[in]		: None
 * Parameters[in/out]	: None
 * Parameters[out]		: None.
 *
 **************************************************************************************************************/
 extern void MCU_vidResetCpu(void) {
-	
+	MCU_tstrCrashRecord strRecord;
+
+	cli();
+	strRecord.u8Cause = MCU_u8CRASH_RESET_REQUEST;
+	strRecord.u8TaskId = MCU_u8NO_TASK;
+	strRecord.u8RunningTaskId = MCU_u8NO_TASK;
+	/* word address of the caller */
+	strRecord.u16Pc = (uint16)(uintptr_t)__builtin_return_address(0);
+	strRecord.u32TickMs = 0UL;
+	MCU_vidSaveCrashRecord(&strRecord);
+
+	/* a jump to the reset vector would leave the peripherals configured, the watchdog resets them all */
+	wdt_enable(WDTO_15MS);
+	while(1)
+	{
+		MCU_IDLE_HOOK();
+	}
+}
+
+/*************************************************************************************************************
+* Function				: MCU_vidSaveCrashRecord
+* Description			: Keep a crash record for MCU_vidResetSrcCheck across the next watchdog reset, replaces
+						  the previous one. May be called from an ISR.
+* Parameters[in]		: [pstrRecord] the record
+* Parameters[in/out]	: None
+* Parameters[out]		: None.
+*
+**************************************************************************************************************/
+extern void MCU_vidSaveCrashRecord(const MCU_tstrCrashRecord *pstrRecord)
+{
+	uint8 u8Sreg = SREG;
+
+	cli();
+	MCU_strCrashRecord = *pstrRecord;
+	MCU_u16CrashMagic = MCU_u16CRASH_MAGIC;
+	SREG = u8Sreg;
 }
 
 
@@ -130,6 +130,31 @@ defined(__AVR_ATmega323__)
 #define ENABLE_INTERUPTS()		(__asm__ __volatile__ ("sei" ::: "memory"))
 #define DISABLE_INTERRUPTS()	(__asm__ __volatile__ ("cli" ::: "memory"))
 
+/* body of a loop waiting on RAM written by an ISR (ring index, flag): nothing on the chip, the host simulator
+   (tools/host_sim) moves its clock there as the ISRs would run meanwhile */
+#ifdef SIM_HOST
+#define MCU_IDLE_HOOK()			SIM_vidIdleHook()
+#else
+#define MCU_IDLE_HOOK()
+#endif
+
+/* causes of a watchdog reset kept in the crash record */
+#define MCU_u8CRASH_TASK_WINDOW		(uint8)1		/* a task did not check in within its window (WDG_supervisor) */
+#define MCU_u8CRASH_RESET_REQUEST	(uint8)2		/* MCU_vidResetCpu */
+
+/* crash record task ID when no task was running (main loop, idle or an ISR) */
+#define MCU_u8NO_TASK				(uint8)0xFF
+
+/*------------------------------------------ Type Definitions  --------------------------------------------*/
+
+/* written just before a watchdog reset, survives it in the .noinit section */
+typedef struct{
+	uint8	u8Cause;			/* MCU_u8CRASH_TASK_WINDOW or MCU_u8CRASH_RESET_REQUEST				*/
+	uint8	u8TaskId;			/* task that missed its window or MCU_u8NO_TASK						*/
+	uint8	u8RunningTaskId;	/* task running when the miss was detected or MCU_u8NO_TASK			*/
+	uint16	u16Pc;				/* word address of the interrupted instruction (x2 in the .lss)		*/
+	uint32	u32TickMs;			/* TIM_u32GetMillis when the record was written, 0 on a request	*/
+}MCU_tstrCrashRecord;
 
 /*---------------------------------------------- Global Variables -------------------------------------------*/
 
@@ -138,7 +163,8 @@ defined(__AVR_ATmega323__)
 
 /*************************************************************************************************************
 * Function				: MCU_vidResetSrcCheck
-* Description			: Check the source of last reset and perform necessary actions
+* Description			: Check the source of last reset and perform necessary actions, a watchdog reset also
+						  reports the crash record saved before it (if any)
 * Parameters[in]		: None
 * Parameters[in/out]	: None
 * Parameters[out]		: None.
@@ -168,6 +194,22 @@ extern void MCU_vidEnableInterrupts( void );
 **************************************************************************************************************/
 extern void MCU_vidDisableInterrupts(void);
 
+/*************************************************************************************************************
+* Function				: MCU_eSleep
+* Description			: Put the CPU in the given sleep mode until the next interrupt. Must be called inside
+						  exactly one MCU_vidDisableInterrupts section, interrupts are enabled only by the
+						  sleep instruction itself so a wake up event that fires after the caller's last check
+						  can not be missed. The section is still active (interrupts disabled) on return.
+						  Refuses to sleep if the interrupts were already disabled when the section was entered
+						  (ISR or start up code): the sleep would enable them.
+* Parameters[in]		: [u8SleepMode] SLEEP_MODE_IDLE, SLEEP_MODE_ADC, SLEEP_MODE_PWR_SAVE, ... (avr/sleep.h)
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if not called from a single (non nested) critical section
+						  entered with the interrupts enabled
+*
+**************************************************************************************************************/
+extern STD_ERR_T MCU_eSleep(uint8 u8SleepMode);
+
 /*************************************************************************************************************
 * Function				: MCU_vidDelay_1_us
 * Description			: Cause a delay of almost 1 us 
@@ -190,7 +232,8 @@ extern void MCU_vidDelay_10_us(void);
 
 /*************************************************************************************************************
 * Function				: MCU_vidResetCpu
-* Description			: Cause a reset for the MCU
+* Description			: Cause a reset for the MCU through the watchdog (15 ms), does not return. Reported as
+						  MCU_u8CRASH_RESET_REQUEST after the reboot.
 * Parameters[in]		: None
 * Parameters[in/out]	: None
 * Parameters[out]		: None.
@@ -198,5 +241,16 @@ extern void MCU_vidDelay_10_us(void);
 **************************************************************************************************************/
 extern void MCU_vidResetCpu(void);
 
+/*************************************************************************************************************
+* Function				: MCU_vidSaveCrashRecord
+* Description			: Keep a crash record for MCU_vidResetSrcCheck across the next watchdog reset, replaces
+						  the previous one. May be called from an ISR.
+* Parameters[in]		: [pstrRecord] the record
+* Parameters[in/out]	: None
+* Parameters[out]		: None.
+*
+**************************************************************************************************************/
+extern void MCU_vidSaveCrashRecord(const MCU_tstrCrashRecord *pstrRecord);
+
 
 #endif /* MCU_H_ */
\ No newline at end of file
@@ -7,32 +7,333 @@
 
 
 #include "SCH_scheduler.h"
+#include "SWT_softTimers.h"
+#include "WDG_supervisor.h"
+#include "LOG_uartLogger.h"
 
 
+static SCH_tstrTask astrSchTasks[SCH_u8MAX_TASKS];
+/* milli seconds count seen by the last tick, a stretched tick covers several ms */
+static uint32 u32SchLastTickMs;
+
+#if (SCH_PROFILING == 1)
+/* raw statistics, the average is derived from the sum when read */
+typedef struct{
+	uint16	u16Runs;
+	uint16	u16ExecMinUs;
+	uint16	u16ExecMaxUs;
+	uint32	u32ExecSumUs;
+	uint16	u16LatencyMinUs;
+	uint16	u16LatencyMaxUs;
+	uint16	u16Overruns;
+	uint16	u16Missed;
+}SCH_tstrProfile;
+
+static SCH_tstrProfile astrSchProfile[SCH_u8MAX_TASKS];
+/* tick (ms) of the last release of every task, written by the tick ISR */
+static volatile uint32 au32SchReleaseMs[SCH_u8MAX_TASKS];
+
+static uint16 SCH_u16Saturate(uint32 u32Value)
+{
+	return (u32Value > 0xFFFFUL) ? 0xFFFFU : (uint16)u32Value;
+}
+
+static void SCH_vidProfileClear(SCH_tstrProfile *pstrProfile)
+{
+	pstrProfile->u16Runs = 0U;
+	pstrProfile->u16ExecMinUs = 0xFFFFU;
+	pstrProfile->u16ExecMaxUs = 0U;
+	pstrProfile->u32ExecSumUs = 0UL;
+	pstrProfile->u16LatencyMinUs = 0xFFFFU;
+	pstrProfile->u16LatencyMaxUs = 0U;
+	pstrProfile->u16Overruns = 0U;
+	pstrProfile->u16Missed = 0U;
+}
+
+static void SCH_vidProfileUpdate(uint8 u8TaskId, uint32 u32ReleaseUs, uint32 u32StartUs, uint32 u32EndUs)
+{
+	SCH_tstrProfile *pstrProfile = &astrSchProfile[u8TaskId];
+	uint16 u16Exec = SCH_u16Saturate(u32EndUs - u32StartUs);
+	uint16 u16Latency = SCH_u16Saturate(u32StartUs - u32ReleaseUs);
+
+	if (pstrProfile->u16Runs == 0xFFFFU){
+		/* keep the average meaningful, restart the accumulation */
+		pstrProfile->u16Runs = 0U;
+		pstrProfile->u32ExecSumUs = 0UL;
+	}
+	pstrProfile->u16Runs++;
+	pstrProfile->u32ExecSumUs += u16Exec;
+	if (u16Exec < pstrProfile->u16ExecMinUs){
+		pstrProfile->u16ExecMinUs = u16Exec;
+	}
+	if (u16Exec > pstrProfile->u16ExecMaxUs){
+		pstrProfile->u16ExecMaxUs = u16Exec;
+	}
+	if (u16Latency < pstrProfile->u16LatencyMinUs){
+		pstrProfile->u16LatencyMinUs = u16Latency;
+	}
+	if (u16Latency > pstrProfile->u16LatencyMaxUs){
+		pstrProfile->u16LatencyMaxUs = u16Latency;
+	}
+	/* deadline = next release of the task */
+	if ((u32EndUs - u32ReleaseUs) > ((uint32)astrSchTasks[u8TaskId].u16Period * 1000UL)){
+		if (pstrProfile->u16Overruns != 0xFFFFU){
+			pstrProfile->u16Overruns++;
+		}
+	}
+}
+#endif
+
 
 extern void SCH_vidSchInit(void)
 {
+	uint8 u8TaskId;
+
+	for (u8TaskId = 0; u8TaskId < SCH_u8MAX_TASKS; u8TaskId++){
+		astrSchTasks[u8TaskId].pfTask = NULL;
+		astrSchTasks[u8TaskId].u8Ready = FALSE;
+	}
+
+	SWT_vidInit();
+#if (SCH_SUPERVISOR == 1)
+	WDG_vidInit();
+#endif
 	TIM_vidInitT0();
+	u32SchLastTickMs = TIM_u32GetMillis();
 	
-	TIM_vidT0AttachInterrupt(SCH_vidTimIsr);
+	/* every tick, the tasks periods are counted here */
+	(void)TIM_u8T0Subscribe(SCH_vidTimIsr, 1U);
+
+#if (SCH_PROFILING == 1) && (SCH_u16PROF_DUMP_PERIOD != 0U)
+	SCH_u8AddTask(SCH_vidDumpStats, SCH_u16PROF_DUMP_PERIOD, SCH_u16PROF_DUMP_PERIOD - 1U);
+#endif
 	
 }
 
+extern uint8 SCH_u8AddTask(TaskFunction pfTask, uint16 u16Period, uint16 u16Offset)
+{
+	uint8 u8TaskId;
+	uint8 u8RetVal = SCH_u8INVALID_TASK;
+#if (SCH_SUPERVISOR == 1)
+	uint32 u32WindowMs = (uint32)u16Period + WDG_u16DEFAULT_SLACK_MS;
+#endif
+
+	if ((pfTask != NULL) && (u16Period != 0U) && (u16Offset != 0xFFFFU)){
+		MCU_vidDisableInterrupts();
+		for (u8TaskId = 0; u8TaskId < SCH_u8MAX_TASKS; u8TaskId++){
+			if (astrSchTasks[u8TaskId].pfTask == NULL){
+				astrSchTasks[u8TaskId].u16Period = u16Period;
+				astrSchTasks[u8TaskId].u16Offset = u16Offset;
+				/* released on the tick number u16Offset, the tick ISR decrements before checking */
+				astrSchTasks[u8TaskId].u16Countdown = u16Offset + 1U;
+				astrSchTasks[u8TaskId].u8Ready = FALSE;
+#if (SCH_PROFILING == 1)
+				SCH_vidProfileClear(&astrSchProfile[u8TaskId]);
+#endif
+#if (SCH_SUPERVISOR == 1)
+				/* the window opens with the first release, not now */
+				(void)WDG_eSetWindow(u8TaskId, (u32WindowMs > 0xFFFFUL) ? 0xFFFFU : (uint16)u32WindowMs, u16Offset);
+#endif
+				astrSchTasks[u8TaskId].pfTask = pfTask;
+				u8RetVal = u8TaskId;
+				break;
+			}
+		}
+		MCU_vidEnableInterrupts();
+	}
+	return u8RetVal;
+}
+
+extern void SCH_vidRemoveTask(uint8 u8TaskId)
+{
+	if (u8TaskId < SCH_u8MAX_TASKS){
+		MCU_vidDisableInterrupts();
+		astrSchTasks[u8TaskId].pfTask = NULL;
+		astrSchTasks[u8TaskId].u8Ready = FALSE;
+#if (SCH_SUPERVISOR == 1)
+		(void)WDG_eSetWindow(u8TaskId, WDG_u16NO_WINDOW, 0U);
+#endif
+		MCU_vidEnableInterrupts();
+	}
+}
+
+extern void SCH_vidDispatch(void)
+{
+	SCH_tstrTask *pstrTask = astrSchTasks;
+	TaskFunction pfTask;
+	uint8 u8TaskId;
+#if (SCH_PROFILING == 1)
+	uint32 u32ReleaseUs;
+	uint32 u32StartUs;
+#endif
+
+	for (u8TaskId = 0; u8TaskId < SCH_u8MAX_TASKS; u8TaskId++, pstrTask++){
+		if (pstrTask->u8Ready != FALSE){
+			/* single byte store, no need to lock out the tick ISR */
+			pstrTask->u8Ready = FALSE;
+			pfTask = pstrTask->pfTask;
+			if (pfTask != NULL){
+#if (SCH_SUPERVISOR == 1)
+				WDG_vidTaskStart(u8TaskId);
+#endif
+#if (SCH_PROFILING == 1)
+				MCU_vidDisableInterrupts();
+				u32ReleaseUs = au32SchReleaseMs[u8TaskId] * 1000UL;
+				MCU_vidEnableInterrupts();
+				u32StartUs = TIM_u32GetMicros();
+				pfTask();
+				SCH_vidProfileUpdate(u8TaskId, u32ReleaseUs, u32StartUs, TIM_u32GetMicros());
+#else
+				pfTask();
+#endif
+#if (SCH_SUPERVISOR == 1)
+				WDG_vidCheckIn(u8TaskId);
+#endif
+			}
+		}
+	}
+	/* call backs of the expired SWT_u8CTX_DEFERRED timers */
+	SWT_vidDispatch();
+}
+
+extern void SCH_vidIdle(void)
+{
+	SCH_tstrTask *pstrTask = astrSchTasks;
+	uint16 u16NextRelease;
+	uint8 u8TaskId;
+
+	MCU_vidDisableInterrupts();
+	/* the first software timer expiry bounds the sleep as a task release does */
+	u16NextRelease = SWT_u16GetNextExpiry();
+	for (u8TaskId = 0; u8TaskId < SCH_u8MAX_TASKS; u8TaskId++, pstrTask++){
+		if (pstrTask->pfTask != NULL){
+			if (pstrTask->u8Ready != FALSE){
+				/* released while the dispatcher was busy, do not sleep */
+				u16NextRelease = 0U;
+				break;
+			}
+			if (pstrTask->u16Countdown < u16NextRelease){
+				u16NextRelease = pstrTask->u16Countdown;
+			}
+		}
+	}
+	if (u16NextRelease != 0U){
+#if (SCH_TICKLESS_IDLE == 1)
+		if (u16NextRelease >= SCH_u8IDLE_MIN_TICKS){
+			/* wake up one tick early, the release itself happens on a normal 1 ms tick */
+			u16NextRelease--;
+			if (u16NextRelease > TIM_u8T0_STRETCH_MAX_MS){
+				u16NextRelease = TIM_u8T0_STRETCH_MAX_MS;
+			}
+			TIM_vidT0StretchTick((uint8)u16NextRelease);
+		}
+#endif
+		/* the timers and the UART keep running in idle mode */
+		MCU_eSleep(SLEEP_MODE_IDLE);
+#if (SCH_TICKLESS_IDLE == 1)
+		/* woken by another interrupt before the end of the stretched tick */
+		TIM_vidT0EndStretch();
+#endif
+	}
+	MCU_vidEnableInterrupts();
+}
+
 void SCH_vidTimIsr(void)
 {
-	static uint32 u32SysTicks = 0;
-	
-	if (u32SysTicks % SCH_u32TASK1_PERIOD == 0){
-		SCH_vidTask1();
+	SCH_tstrTask *pstrTask = astrSchTasks;
+	uint32 u32NowMs = TIM_u32GetMillis();
+	uint16 u16Elapsed;
+	uint16 u16Late;
+	uint8 u8TaskId;
+
+	/* 1 on a normal tick, the whole stretch (or the time accounted by TIM_vidT0EndStretch) otherwise */
+	u16Elapsed = (uint16)(u32NowMs - u32SchLastTickMs);
+	u32SchLastTickMs = u32NowMs;
+
+	/* O(1) per task: a 16-bit subtract and compare, no division */
+	for (u8TaskId = 0; u8TaskId < SCH_u8MAX_TASKS; u8TaskId++, pstrTask++){
+		if (pstrTask->pfTask != NULL){
+			if (pstrTask->u16Countdown > u16Elapsed){
+				pstrTask->u16Countdown -= u16Elapsed;
+			} else {
+				/* keep the release grid if the tick came late, collapse whole periods into one release */
+				u16Late = u16Elapsed - pstrTask->u16Countdown;
+				pstrTask->u16Countdown = (u16Late < pstrTask->u16Period) ? (pstrTask->u16Period - u16Late) : 1U;
+#if (SCH_PROFILING == 1)
+				if (pstrTask->u8Ready != FALSE){
+					/* the previous release did not start yet, this one is lost */
+					if (astrSchProfile[u8TaskId].u16Missed != 0xFFFFU){
+						astrSchProfile[u8TaskId].u16Missed++;
+					}
+				} else {
+					au32SchReleaseMs[u8TaskId] = TIM_u32GetMillis();
+				}
+#endif
+				pstrTask->u8Ready = TRUE;
+			}
+		}
 	}
-	
-	if (u32SysTicks % SCH_u32TASK2_PERIOD == 0){
-		SCH_vidTask2();
+	SWT_vidTickIsr(u16Elapsed);
+#if (SCH_SUPERVISOR == 1)
+	WDG_vidTickIsr(u16Elapsed);
+#endif
+}
+
+extern STD_ERR_T SCH_eGetTaskStats(uint8 u8TaskId, SCH_tstrTaskStats *pstrStats)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+#if (SCH_PROFILING == 1)
+	SCH_tstrProfile strProfile;
+
+	if ((u8TaskId < SCH_u8MAX_TASKS) && (pstrStats != NULL)){
+		/* the missed counter is written by the tick ISR */
+		MCU_vidDisableInterrupts();
+		strProfile = astrSchProfile[u8TaskId];
+		MCU_vidEnableInterrupts();
+		if (strProfile.u16Runs != 0U){
+			pstrStats->u16Runs = strProfile.u16Runs;
+			pstrStats->u16ExecMinUs = strProfile.u16ExecMinUs;
+			pstrStats->u16ExecMaxUs = strProfile.u16ExecMaxUs;
+			pstrStats->u16ExecAvgUs = (uint16)(strProfile.u32ExecSumUs / strProfile.u16Runs);
+			pstrStats->u16LatencyMinUs = strProfile.u16LatencyMinUs;
+			pstrStats->u16LatencyMaxUs = strProfile.u16LatencyMaxUs;
+			pstrStats->u16Overruns = strProfile.u16Overruns;
+			pstrStats->u16Missed = strProfile.u16Missed;
+			errRetVal = STD_ERR_OK;
+		}
 	}
-	
-	if (u32SysTicks % SCH_u32TASK3_PERIOD == 0){
-		SCH_vidTask3();
+#else
+	(void)u8TaskId;
+	(void)pstrStats;
+#endif
+	return errRetVal;
+}
+
+extern void SCH_vidResetStats(void)
+{
+#if (SCH_PROFILING == 1)
+	uint8 u8TaskId;
+
+	MCU_vidDisableInterrupts();
+	for (u8TaskId = 0; u8TaskId < SCH_u8MAX_TASKS; u8TaskId++){
+		SCH_vidProfileClear(&astrSchProfile[u8TaskId]);
 	}
+	MCU_vidEnableInterrupts();
+#endif
+}
 
-	//TODO:: reset u32SysTicks upon reaching the slowest task 
+extern void SCH_vidDumpStats(void)
+{
+	SCH_tstrTaskStats strStats;
+	uint8 u8TaskId;
+
+	for (u8TaskId = 0; u8TaskId < SCH_u8MAX_TASKS; u8TaskId++){
+		if (SCH_eGetTaskStats(u8TaskId, &strStats) == STD_ERR_OK){
+			INFO("T%u exec us min %u avg %u max %u", u8TaskId, strStats.u16ExecMinUs,
+				 strStats.u16ExecAvgUs, strStats.u16ExecMaxUs);
+			INFO("T%u jitter us %u overruns %u missed %u", u8TaskId,
+				 strStats.u16LatencyMaxUs - strStats.u16LatencyMinUs, strStats.u16Overruns, strStats.u16Missed);
+		}
+	}
+	INFO("tick isr max us %u", TIM_u16T0GetIsrMaxUs());
 }
@@ -13,7 +13,164 @@
 #include "TIM_timers.h"
 #include "SCH_tasks.h"
 
+/* tasks left to the application by SCH_u8AddTask */
+#define SCH_u8APP_TASKS			4U
+/* returned by SCH_u8AddTask when the table is full or the parameters are invalid */
+#define SCH_u8INVALID_TASK		0xFFU
+
+/* per task execution time / release jitter / overrun statistics (1 = enabled, 0 = compiled out) */
+#ifndef SCH_PROFILING
+#define SCH_PROFILING			1
+#endif
+/* watchdog supervisor: every task must complete a run within its window (1 = enabled, 0 = compiled out),
+   see WDG_supervisor.h */
+#ifndef SCH_SUPERVISOR
+#define SCH_SUPERVISOR			1
+#endif
+/* sleep between ticks in SCH_vidIdle and replace the 1 ms ticks by one long timer tick when the next release
+   is far away (1 = tickless idle, 0 = the CPU still sleeps but wakes on every 1 ms tick) */
+#ifndef SCH_TICKLESS_IDLE
+#define SCH_TICKLESS_IDLE		1
+#endif
+/* shortest wait (ticks) worth reprogramming Timer 0 for */
+#define SCH_u8IDLE_MIN_TICKS	3U
+
+/* period of the statistics dump to LOG_uartLogger in ticks (ms), 0 = no periodic dump */
+#define SCH_u16PROF_DUMP_PERIOD	10000U
+
+/* size of the task table: the periodic dump gets its own slot on top of the application tasks */
+#if (SCH_PROFILING == 1) && (SCH_u16PROF_DUMP_PERIOD != 0U)
+#define SCH_u8MAX_TASKS			(SCH_u8APP_TASKS + 1U)
+#else
+#define SCH_u8MAX_TASKS			SCH_u8APP_TASKS
+#endif
+
 typedef void (*TaskFunction)();
+
+/* one entry of the task table, the count down replaces a modulo of the tick counter */
+typedef struct{
+	TaskFunction		pfTask;			/* NULL marks a free slot								*/
+	uint16				u16Period;		/* release period in ticks (ms)							*/
+	uint16				u16Offset;		/* ticks before the first release						*/
+	volatile uint16		u16Countdown;	/* ticks left until the next release, reloaded by ISR	*/
+	volatile uint8		u8Ready;		/* set by the tick ISR, cleared by the dispatcher		*/
+}SCH_tstrTask;
+
+/* statistics of one task, times in us measured with Timer 0 (8 us resolution) */
+typedef struct{
+	uint16				u16Runs;			/* completed runs, restarts with the average at 65535	*/
+	uint16				u16ExecMinUs;		/* shortest execution time								*/
+	uint16				u16ExecMaxUs;		/* longest execution time								*/
+	uint16				u16ExecAvgUs;		/* average execution time								*/
+	uint16				u16LatencyMinUs;	/* shortest delay from release (tick) to start			*/
+	uint16				u16LatencyMaxUs;	/* longest delay from release (tick) to start			*/
+	uint16				u16Overruns;		/* runs that finished after their next release time		*/
+	uint16				u16Missed;			/* releases lost because the previous one still waited	*/
+}SCH_tstrTaskStats;
+
+/*************************************************************************************************************
+* Function				: SCH_vidSchInit
+* Description			: Clear the task table and the software timers, start the 1 ms tick of Timer 0 and hook
+						  the scheduler on it. Starts the watchdog supervisor (SCH_SUPERVISOR).
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void SCH_vidSchInit(void);
+
+/*************************************************************************************************************
+* Function				: SCH_u8AddTask
+* Description			: Register a periodic task in the first free slot of the task table, supervised with a
+						  window of u16Period + WDG_u16DEFAULT_SLACK_MS (SCH_SUPERVISOR) that first opens at
+						  the offset.
+* Parameters[in]		: [pfTask] the task routine
+						  [u16Period] release period in ticks (ms), Range (1 .. 65535)
+						  [u16Offset] ticks before the first release, used to spread tasks of the same
+						  period over different ticks, Range (0 .. 65534)
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 the task ID (index in the table) or SCH_u8INVALID_TASK
+*
+**************************************************************************************************************/
+extern uint8 SCH_u8AddTask(TaskFunction pfTask, uint16 u16Period, uint16 u16Offset);
+
+/*************************************************************************************************************
+* Function				: SCH_vidRemoveTask
+* Description			: Remove a task from the table, a pending release of it is discarded.
+* Parameters[in]		: [u8TaskId] ID returned by SCH_u8AddTask
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void SCH_vidRemoveTask(uint8 u8TaskId);
+
+/*************************************************************************************************************
+* Function				: SCH_vidDispatch
+* Description			: Run every task released by the tick ISR and the deferred software timer call backs, to
+						  be called continuously from the main loop.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void SCH_vidDispatch(void);
+
+/*************************************************************************************************************
+* Function				: SCH_vidIdle
+* Description			: Sleep (SLEEP_MODE_IDLE) until the next task release, software timer expiry or any other
+						  interrupt, to be called from the main loop after SCH_vidDispatch. With SCH_TICKLESS_IDLE
+						  the 1 ms ticks up to the next release are replaced by a single stretched Timer 0 tick, the milli seconds
+						  count stays correct (see TIM_vidT0StretchTick).
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void SCH_vidIdle(void);
+
+/*************************************************************************************************************
+* Function				: SCH_eGetTaskStats
+* Description			: Read the profiling statistics of one task, the release jitter is
+						  u16LatencyMaxUs - u16LatencyMinUs.
+* Parameters[in]		: [u8TaskId] ID returned by SCH_u8AddTask
+* Parameters[in/out]	: [pstrStats] filled with the statistics
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the ID is invalid, the task never ran or profiling is off
+*
+**************************************************************************************************************/
+extern STD_ERR_T SCH_eGetTaskStats(uint8 u8TaskId, SCH_tstrTaskStats *pstrStats);
+
+/*************************************************************************************************************
+* Function				: SCH_vidResetStats
+* Description			: Clear the profiling statistics of all tasks.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void SCH_vidResetStats(void);
+
+/*************************************************************************************************************
+* Function				: SCH_vidDumpStats
+* Description			: Print the profiling statistics of all tasks and the longest tick ISR through
+						  LOG_uartLogger. Runs periodically (SCH_u16PROF_DUMP_PERIOD) as a scheduler task when
+						  profiling is enabled.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void SCH_vidDumpStats(void);
+
+/*************************************************************************************************************
+* Function				: SCH_vidTimIsr
+* Description			: Scheduler tick, called from the Timer 0 overflow ISR every 1 ms. Only counts down and
+						  flags the released tasks, the tasks themselves run in SCH_vidDispatch. Ticks the
+						  software timers (SWT_vidTickIsr) and the watchdog supervisor (WDG_vidTickIsr).
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
 extern void SCH_vidTimIsr(void);
 
-#endif /* SCH_SCHEDULER_H_ */
\ No newline at end of file
+#endif /* SCH_SCHEDULER_H_ */
@@ -6,6 +6,8 @@
  */ 
 
 #include "SCH_scheduler.h"
+#include "LOG_uartLogger.h"
+#include "SPI.h"
 
 
 void SCH_vidTask1()
@@ -17,6 +19,7 @@ void SCH_vidTask1()
 void SCH_vidTask2()
 {
 	INFO("TASK 2");
+	SPI_eSendByte(0x01);
 }
 
 void SCH_vidTask3()
@@ -24,3 +27,9 @@ void SCH_vidTask3()
 	INFO("TASK 3");	
 }
 
+/* deferred software timer call back, logs from the main loop instead of the tick ISR */
+void SCH_vidHeartBeat()
+{
+	INFO("1 second passed");
+}
+
@@ -13,6 +13,8 @@
 #define SCH_u32TASK1_PERIOD    (uint32)5
 #define SCH_u32TASK2_PERIOD    (uint32)1000
 #define SCH_u32TASK3_PERIOD    (uint32)2000
+/* software timer period of the heart beat */
+#define SCH_u16HEARTBEAT_PERIOD (uint16)1000
 
 
 
@@ -22,4 +24,6 @@ void SCH_vidTask2();
 
 void SCH_vidTask3();
 
+void SCH_vidHeartBeat();
+
 #endif /* SCH_TASKS_H_ */
\ No newline at end of file
@@ -0,0 +1,314 @@
+/*! \file SWT_softTimers.c \brief One shot and periodic software timers on the scheduler tick. */
+/************************************************************************************************************
+*
+* File Name		: 'SWT_softTimers.c'
+* Title			: One shot and periodic software timers on the scheduler tick
+* Version		: 1.0
+* Target MCU	: Atmel AVR Series
+*
+************************************************************************************************************/
+
+
+/*------------------------------------------------- INCLUDES ----------------------------------------------*/
+#include "Common_Macros.h"
+
+#include "SWT_softTimers.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+/* end of the list */
+#define SWT_u8END				0xFFU
+
+/* timer flags */
+#define SWT_u8FLAG_USED			0x01U
+#define SWT_u8FLAG_PERIODIC		0x02U
+#define SWT_u8FLAG_DEFERRED		0x04U
+#define SWT_u8FLAG_RUNNING		0x08U		/* in the list, or expired in the tick being processed		*/
+#define SWT_u8FLAG_EXPIRED		0x10U		/* taken out of the list by the tick being processed		*/
+#define SWT_u8FLAG_PENDING		0x20U		/* deferred call back waiting for SWT_vidDispatch			*/
+
+#if (SWT_u8MAX_TIMERS >= SWT_u8END)
+#error "SWT_u8MAX_TIMERS must be lower than 255"
+#endif
+
+/*------------------------------------------ Type Definitions  --------------------------------------------*/
+
+typedef struct{
+	SWT_tpfvidClbk		pfvClbk;
+	uint16				u16PeriodMs;	/* last started period, 0 = never started					*/
+	uint16				u16Delta;		/* ticks left after the expiry of the entry before it		*/
+	uint8				u8Next;			/* next entry of the list, SWT_u8END for the last one		*/
+	volatile uint8		u8Flags;
+}SWT_tstrTimer;
+
+/*---------------------------------------------- Global Variables -----------------------------------------*/
+
+static SWT_tstrTimer astrSwtTimers[SWT_u8MAX_TIMERS];
+static uint8 u8SwtHead = SWT_u8END;
+
+/*-------------------------------------Static functions Definitions ---------------------------------------*/
+
+/* link a timer u16Delay ticks from now, after the timers with the same expiry; interrupts disabled */
+static void SWT_vidInsert(uint8 u8TimerId, uint16 u16Delay)
+{
+	uint8 u8Prev = SWT_u8END;
+	uint8 u8Cur = u8SwtHead;
+
+	while ((u8Cur != SWT_u8END) && (u16Delay >= astrSwtTimers[u8Cur].u16Delta)){
+		u16Delay -= astrSwtTimers[u8Cur].u16Delta;
+		u8Prev = u8Cur;
+		u8Cur = astrSwtTimers[u8Cur].u8Next;
+	}
+	astrSwtTimers[u8TimerId].u16Delta = u16Delay;
+	astrSwtTimers[u8TimerId].u8Next = u8Cur;
+	if (u8Cur != SWT_u8END){
+		/* the next entry now counts from the new one */
+		astrSwtTimers[u8Cur].u16Delta -= u16Delay;
+	}
+	if (u8Prev == SWT_u8END){
+		u8SwtHead = u8TimerId;
+	} else {
+		astrSwtTimers[u8Prev].u8Next = u8TimerId;
+	}
+}
+
+/* unlink a timer of the list, its ticks go to the next entry; interrupts disabled */
+static void SWT_vidRemove(uint8 u8TimerId)
+{
+	uint8 u8Prev = SWT_u8END;
+	uint8 u8Cur = u8SwtHead;
+	uint8 u8Next;
+
+	while ((u8Cur != SWT_u8END) && (u8Cur != u8TimerId)){
+		u8Prev = u8Cur;
+		u8Cur = astrSwtTimers[u8Cur].u8Next;
+	}
+	if (u8Cur != SWT_u8END){
+		u8Next = astrSwtTimers[u8Cur].u8Next;
+		if (u8Next != SWT_u8END){
+			astrSwtTimers[u8Next].u16Delta += astrSwtTimers[u8Cur].u16Delta;
+		}
+		if (u8Prev == SWT_u8END){
+			u8SwtHead = u8Next;
+		} else {
+			astrSwtTimers[u8Prev].u8Next = u8Next;
+		}
+	}
+}
+
+/* stop a running timer; interrupts disabled */
+static void SWT_vidStop(uint8 u8TimerId)
+{
+	SWT_tstrTimer *pstrTimer = &astrSwtTimers[u8TimerId];
+
+	if ((pstrTimer->u8Flags & (SWT_u8FLAG_RUNNING | SWT_u8FLAG_EXPIRED)) == SWT_u8FLAG_RUNNING){
+		SWT_vidRemove(u8TimerId);
+	}
+	pstrTimer->u8Flags &= (uint8)~(SWT_u8FLAG_RUNNING | SWT_u8FLAG_EXPIRED | SWT_u8FLAG_PENDING);
+}
+
+/*-------------------------------------------- FUNCTION Definitions ---------------------------------------*/
+
+extern void SWT_vidInit(void)
+{
+	uint8 u8Sreg = SREG;
+	uint8 u8TimerId;
+
+	cli();
+	for (u8TimerId = 0; u8TimerId < SWT_u8MAX_TIMERS; u8TimerId++){
+		astrSwtTimers[u8TimerId].pfvClbk = NULL;
+		astrSwtTimers[u8TimerId].u8Flags = 0U;
+	}
+	u8SwtHead = SWT_u8END;
+	SREG = u8Sreg;
+}
+
+extern uint8 SWT_u8Create(SWT_tpfvidClbk pfvClbk, uint8 u8Mode, uint8 u8Context)
+{
+	uint8 u8Sreg;
+	uint8 u8TimerId = SWT_u8INVALID_TIMER;
+	uint8 u8Index;
+
+	if ((pfvClbk != NULL) && (u8Mode <= SWT_u8PERIODIC) && (u8Context <= SWT_u8CTX_DEFERRED)){
+		u8Sreg = SREG;
+		cli();
+		for (u8Index = 0; u8Index < SWT_u8MAX_TIMERS; u8Index++){
+			if ((astrSwtTimers[u8Index].u8Flags & SWT_u8FLAG_USED) == 0U){
+				astrSwtTimers[u8Index].pfvClbk = pfvClbk;
+				astrSwtTimers[u8Index].u16PeriodMs = 0U;
+				astrSwtTimers[u8Index].u8Flags = SWT_u8FLAG_USED |
+												 ((u8Mode == SWT_u8PERIODIC) ? SWT_u8FLAG_PERIODIC : 0U) |
+												 ((u8Context == SWT_u8CTX_DEFERRED) ? SWT_u8FLAG_DEFERRED : 0U);
+				u8TimerId = u8Index;
+				break;
+			}
+		}
+		SREG = u8Sreg;
+	}
+	return u8TimerId;
+}
+
+extern STD_ERR_T SWT_eDelete(uint8 u8TimerId)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint8 u8Sreg;
+
+	if (u8TimerId < SWT_u8MAX_TIMERS){
+		u8Sreg = SREG;
+		cli();
+		if (astrSwtTimers[u8TimerId].u8Flags & SWT_u8FLAG_USED){
+			SWT_vidStop(u8TimerId);
+			astrSwtTimers[u8TimerId].u8Flags = 0U;
+			errRetVal = STD_ERR_OK;
+		}
+		SREG = u8Sreg;
+	}
+	return errRetVal;
+}
+
+extern STD_ERR_T SWT_eStart(uint8 u8TimerId, uint16 u16PeriodMs)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	SWT_tstrTimer *pstrTimer;
+	uint8 u8Sreg;
+
+	if ((u8TimerId < SWT_u8MAX_TIMERS) && (u16PeriodMs != 0U) && (u16PeriodMs != SWT_u16NO_EXPIRY)){
+		pstrTimer = &astrSwtTimers[u8TimerId];
+		u8Sreg = SREG;
+		cli();
+		if ((pstrTimer->u8Flags & (SWT_u8FLAG_USED | SWT_u8FLAG_RUNNING)) == SWT_u8FLAG_USED){
+			pstrTimer->u16PeriodMs = u16PeriodMs;
+			pstrTimer->u8Flags |= SWT_u8FLAG_RUNNING;
+			SWT_vidInsert(u8TimerId, u16PeriodMs);
+			errRetVal = STD_ERR_OK;
+		}
+		SREG = u8Sreg;
+	}
+	return errRetVal;
+}
+
+extern STD_ERR_T SWT_eStop(uint8 u8TimerId)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	uint8 u8Sreg;
+
+	if (u8TimerId < SWT_u8MAX_TIMERS){
+		u8Sreg = SREG;
+		cli();
+		if (astrSwtTimers[u8TimerId].u8Flags & SWT_u8FLAG_USED){
+			SWT_vidStop(u8TimerId);
+			errRetVal = STD_ERR_OK;
+		}
+		SREG = u8Sreg;
+	}
+	return errRetVal;
+}
+
+extern STD_ERR_T SWT_eRestart(uint8 u8TimerId)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+	SWT_tstrTimer *pstrTimer;
+	uint8 u8Sreg;
+
+	if (u8TimerId < SWT_u8MAX_TIMERS){
+		pstrTimer = &astrSwtTimers[u8TimerId];
+		u8Sreg = SREG;
+		cli();
+		if ((pstrTimer->u8Flags & SWT_u8FLAG_USED) && (pstrTimer->u16PeriodMs != 0U)){
+			SWT_vidStop(u8TimerId);
+			pstrTimer->u8Flags |= SWT_u8FLAG_RUNNING;
+			SWT_vidInsert(u8TimerId, pstrTimer->u16PeriodMs);
+			errRetVal = STD_ERR_OK;
+		}
+		SREG = u8Sreg;
+	}
+	return errRetVal;
+}
+
+extern boolean SWT_bIsRunning(uint8 u8TimerId)
+{
+	return ((u8TimerId < SWT_u8MAX_TIMERS) && (astrSwtTimers[u8TimerId].u8Flags & SWT_u8FLAG_RUNNING)) ? TRUE : FALSE;
+}
+
+extern uint16 SWT_u16GetNextExpiry(void)
+{
+	uint8 u8TimerId;
+
+	for (u8TimerId = 0; u8TimerId < SWT_u8MAX_TIMERS; u8TimerId++){
+		if (astrSwtTimers[u8TimerId].u8Flags & SWT_u8FLAG_PENDING){
+			return 0U;
+		}
+	}
+	return (u8SwtHead != SWT_u8END) ? astrSwtTimers[u8SwtHead].u16Delta : SWT_u16NO_EXPIRY;
+}
+
+extern void SWT_vidDispatch(void)
+{
+	SWT_tstrTimer *pstrTimer = astrSwtTimers;
+	SWT_tpfvidClbk pfvClbk;
+	uint8 u8TimerId;
+	uint8 u8Sreg;
+
+	for (u8TimerId = 0; u8TimerId < SWT_u8MAX_TIMERS; u8TimerId++, pstrTimer++){
+		if (pstrTimer->u8Flags & SWT_u8FLAG_PENDING){
+			/* the flags byte is shared with the tick ISR */
+			u8Sreg = SREG;
+			cli();
+			pfvClbk = (pstrTimer->u8Flags & SWT_u8FLAG_PENDING) ? pstrTimer->pfvClbk : NULL;
+			pstrTimer->u8Flags &= (uint8)~SWT_u8FLAG_PENDING;
+			SREG = u8Sreg;
+			if (pfvClbk != NULL){
+				pfvClbk();
+			}
+		}
+	}
+}
+
+extern void SWT_vidTickIsr(uint16 u16ElapsedMs)
+{
+	uint8 au8Expired[SWT_u8MAX_TIMERS];
+	uint16 au16Late[SWT_u8MAX_TIMERS];
+	SWT_tstrTimer *pstrTimer;
+	uint8 u8NoOfExpired = 0U;
+	uint8 u8Index;
+	uint8 u8TimerId;
+
+	/* O(1) when nothing expires: one subtract on the head */
+	while (u8SwtHead != SWT_u8END){
+		pstrTimer = &astrSwtTimers[u8SwtHead];
+		if (pstrTimer->u16Delta > u16ElapsedMs){
+			pstrTimer->u16Delta -= u16ElapsedMs;
+			break;
+		}
+		u16ElapsedMs -= pstrTimer->u16Delta;
+		au8Expired[u8NoOfExpired] = u8SwtHead;
+		au16Late[u8NoOfExpired] = u16ElapsedMs;
+		u8NoOfExpired++;
+		pstrTimer->u8Flags |= SWT_u8FLAG_EXPIRED;
+		/* the next entry counts from this expiry, the rest of the elapsed ticks apply to it */
+		u8SwtHead = pstrTimer->u8Next;
+	}
+
+	/* the list is consistent again, the call backs may start or stop any timer */
+	for (u8Index = 0; u8Index < u8NoOfExpired; u8Index++){
+		u8TimerId = au8Expired[u8Index];
+		pstrTimer = &astrSwtTimers[u8TimerId];
+		if ((pstrTimer->u8Flags & SWT_u8FLAG_EXPIRED) == 0U){
+			/* stopped or restarted by an earlier call back of this tick */
+			continue;
+		}
+		pstrTimer->u8Flags &= (uint8)~SWT_u8FLAG_EXPIRED;
+		if (pstrTimer->u8Flags & SWT_u8FLAG_PERIODIC){
+			/* keep the period grid if the tick came late, collapse whole periods into one expiry */
+			SWT_vidInsert(u8TimerId, (au16Late[u8Index] < pstrTimer->u16PeriodMs) ?
+									 (uint16)(pstrTimer->u16PeriodMs - au16Late[u8Index]) : 1U);
+		} else {
+			pstrTimer->u8Flags &= (uint8)~SWT_u8FLAG_RUNNING;
+		}
+		if (pstrTimer->u8Flags & SWT_u8FLAG_DEFERRED){
+			pstrTimer->u8Flags |= SWT_u8FLAG_PENDING;
+		} else {
+			pstrTimer->pfvClbk();
+		}
+	}
+}
@@ -0,0 +1,160 @@
+/*! \file SWT_softTimers.h \brief One shot and periodic software timers on the scheduler tick. */
+/*************************************************************************************************************
+*
+* File Name		: 'SWT_softTimers.h'
+* Title			: One shot and periodic software timers on the scheduler tick
+* Version		: 1.0
+* Target MCU	: Atmel AVR Series
+*
+*  The running timers are kept in a delta list sorted by expiry: every entry holds the ticks left after the
+*  entry before it, so the Timer 0 tick (SCH_vidTimIsr --> SWT_vidTickIsr) only counts down the head entry,
+*  whatever the number of timers. Starting a timer walks the list (O(n), main context, n <= SWT_u8MAX_TIMERS).
+*
+*  A timer created with SWT_u8CTX_ISR calls back from the tick ISR (keep it short), SWT_u8CTX_DEFERRED flags
+*  it and SWT_vidDispatch (run by SCH_vidDispatch) calls it from the main loop.
+*
+*************************************************************************************************************/
+#ifndef SWT_SOFTTIMERS_H_
+#define SWT_SOFTTIMERS_H_
+
+
+/*---------------------------------------------------- INCLUDES --------------------------------------------*/
+
+#include "MCU.h"
+#include "Std_Types.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+/* size of the timer pool */
+#define SWT_u8MAX_TIMERS		8U
+
+/* returned by SWT_u8Create when the pool is full or the parameters are invalid */
+#define SWT_u8INVALID_TIMER		0xFFU
+
+/* modes */
+#define SWT_u8ONE_SHOT			0U
+#define SWT_u8PERIODIC			1U
+
+/* call back context */
+#define SWT_u8CTX_ISR			0U
+#define SWT_u8CTX_DEFERRED		1U
+
+/* returned by SWT_u16GetNextExpiry when no timer is running */
+#define SWT_u16NO_EXPIRY		0xFFFFU
+
+/*------------------------------------------ Type Definitions  --------------------------------------------*/
+
+typedef void (*SWT_tpfvidClbk)(void);
+
+/*--------------------------------------------- FUNCTION Definitions ----------------------------------------*/
+
+/*************************************************************************************************************
+* Function				: SWT_vidInit
+* Description			: Free all the timers, called by SCH_vidSchInit.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void SWT_vidInit(void);
+
+/*************************************************************************************************************
+* Function				: SWT_u8Create
+* Description			: Take a timer from the pool, it is stopped until SWT_eStart.
+* Parameters[in]		: [pfvClbk] call back run on expiry
+						  [u8Mode] SWT_u8ONE_SHOT or SWT_u8PERIODIC
+						  [u8Context] SWT_u8CTX_ISR or SWT_u8CTX_DEFERRED
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 timer id, SWT_u8INVALID_TIMER if the pool is full or a parameter is invalid
+*
+**************************************************************************************************************/
+extern uint8 SWT_u8Create(SWT_tpfvidClbk pfvClbk, uint8 u8Mode, uint8 u8Context);
+
+/*************************************************************************************************************
+* Function				: SWT_eDelete
+* Description			: Stop a timer and give it back to the pool.
+* Parameters[in]		: [u8TimerId] id returned by SWT_u8Create
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on an invalid id
+*
+**************************************************************************************************************/
+extern STD_ERR_T SWT_eDelete(uint8 u8TimerId);
+
+/*************************************************************************************************************
+* Function				: SWT_eStart
+* Description			: Start a stopped timer, it expires u16PeriodMs ticks from now (then every u16PeriodMs
+						  ticks in periodic mode). May be called from a call back.
+* Parameters[in]		: [u8TimerId] id returned by SWT_u8Create
+						  [u16PeriodMs] Range (1 - 65534) ms
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on invalid parameters or if the timer is running
+*
+**************************************************************************************************************/
+extern STD_ERR_T SWT_eStart(uint8 u8TimerId, uint16 u16PeriodMs);
+
+/*************************************************************************************************************
+* Function				: SWT_eStop
+* Description			: Stop a timer, a deferred call back already flagged is dropped. Stopping a stopped
+						  timer does nothing. May be called from a call back.
+* Parameters[in]		: [u8TimerId] id returned by SWT_u8Create
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on an invalid id
+*
+**************************************************************************************************************/
+extern STD_ERR_T SWT_eStop(uint8 u8TimerId);
+
+/*************************************************************************************************************
+* Function				: SWT_eRestart
+* Description			: Start a timer again from now with the period of its last SWT_eStart, running or not
+						  (e.g. a receive time out pushed back on every byte).
+* Parameters[in]		: [u8TimerId] id returned by SWT_u8Create
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK on an invalid id or a timer never started
+*
+**************************************************************************************************************/
+extern STD_ERR_T SWT_eRestart(uint8 u8TimerId);
+
+/*************************************************************************************************************
+* Function				: SWT_bIsRunning
+* Description			: Tell if a timer is started and did not expire yet (one shot) or was not stopped.
+* Parameters[in]		: [u8TimerId] id returned by SWT_u8Create
+* Parameters[in/out]	: None
+* Parameters[out]		: boolean TRUE if running
+*
+**************************************************************************************************************/
+extern boolean SWT_bIsRunning(uint8 u8TimerId);
+
+/*************************************************************************************************************
+* Function				: SWT_u16GetNextExpiry
+* Description			: Ticks until the first running timer expires, used by the tickless idle of SCH_vidIdle.
+						  Call with interrupts disabled.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint16 ticks, 0 if a deferred call back waits, SWT_u16NO_EXPIRY if no timer runs
+*
+**************************************************************************************************************/
+extern uint16 SWT_u16GetNextExpiry(void);
+
+/*************************************************************************************************************
+* Function				: SWT_vidDispatch
+* Description			: Run the deferred call backs of the expired timers, called from the main loop by
+						  SCH_vidDispatch. Expiries that pile up before the dispatch give a single call.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void SWT_vidDispatch(void);
+
+/*************************************************************************************************************
+* Function				: SWT_vidTickIsr
+* Description			: Count down the head of the list and expire the timers that reach 0, called from the
+						  Timer 0 ISR by SCH_vidTimIsr.
+* Parameters[in]		: [u16ElapsedMs] ticks since the previous call (more than 1 after a stretched tick)
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void SWT_vidTickIsr(uint16 u16ElapsedMs);
+
+#endif /* SWT_SOFTTIMERS_H_ */
@@ -0,0 +1,214 @@
+/*! \file WDG_supervisor.c \brief Watchdog supervisor of the scheduler tasks. */
+/************************************************************************************************************
+*
+* File Name		: 'WDG_supervisor.c'
+* Title			: Watchdog supervisor of the scheduler tasks
+* Version		: 1.0
+* Target MCU	: Atmel AVR Series
+*
+************************************************************************************************************/
+
+
+/*------------------------------------------------- INCLUDES ----------------------------------------------*/
+#include "Common_Macros.h"
+
+#include "WDG_supervisor.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+/* supervisor states */
+#define WDG_u8STATE_STOPPED		0U		/* WDG_vidStop or never started							*/
+#define WDG_u8STATE_RUNNING		1U		/* kicking while all the windows are open				*/
+#define WDG_u8STATE_PAUSED		2U		/* WDG_vidPause, watchdog off until WDG_vidResume		*/
+#define WDG_u8STATE_EXPIRED		3U		/* a window closed, the watchdog reset is on its way	*/
+
+/*------------------------------------------ Type Definitions  --------------------------------------------*/
+
+typedef struct{
+	uint16				u16WindowMs;	/* WDG_u16NO_WINDOW = unsupervised							*/
+	volatile uint32		u32LeftMs;		/* ms left before the window closes, counted by the tick,
+										   the first one holds the release offset as well			*/
+}WDG_tstrTask;
+
+/*---------------------------------------------- Global Variables -----------------------------------------*/
+
+static WDG_tstrTask astrWdgTasks[SCH_u8MAX_TASKS];
+/* task run in progress, MCU_u8NO_TASK between two runs */
+static volatile uint8 u8WdgRunningTask = MCU_u8NO_TASK;
+static volatile uint8 u8WdgState = WDG_u8STATE_STOPPED;
+
+/*-------------------------------------------- FUNCTION Definitions ---------------------------------------*/
+
+/*************************************************************************************************************
+* Function				: WDG_vidInit
+* Description			: Unsupervise all the tasks and start the hardware watchdog, called by SCH_vidSchInit.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WDG_vidInit(void)
+{
+	uint8 u8TaskId;
+
+	MCU_vidDisableInterrupts();
+	for (u8TaskId = 0; u8TaskId < SCH_u8MAX_TASKS; u8TaskId++){
+		astrWdgTasks[u8TaskId].u16WindowMs = WDG_u16NO_WINDOW;
+	}
+	u8WdgRunningTask = MCU_u8NO_TASK;
+	wdt_enable(WDG_u8HW_TIMEOUT);
+	u8WdgState = WDG_u8STATE_RUNNING;
+	MCU_vidEnableInterrupts();
+}
+
+/*************************************************************************************************************
+* Function				: WDG_vidStop
+* Description			: Stop the hardware watchdog and the supervision until WDG_vidInit, the windows are kept.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WDG_vidStop(void)
+{
+	MCU_vidDisableInterrupts();
+	/* a closed window keeps its reset */
+	if ((u8WdgState == WDG_u8STATE_RUNNING) || (u8WdgState == WDG_u8STATE_PAUSED)){
+		u8WdgState = WDG_u8STATE_STOPPED;
+		wdt_disable();
+	}
+	MCU_vidEnableInterrupts();
+}
+
+/*************************************************************************************************************
+* Function				: WDG_vidPause / WDG_vidResume
+* Description			: Stop the hardware watchdog around a sleep that halts Timer 0 (power save, power down)
+						  and restart it after, the windows keep the time left (they are not counted while
+						  Timer 0 is stopped). Called by RTC_ePowerSave. Do nothing unless the supervisor runs /
+						  was paused.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WDG_vidPause(void)
+{
+	MCU_vidDisableInterrupts();
+	if (u8WdgState == WDG_u8STATE_RUNNING){
+		u8WdgState = WDG_u8STATE_PAUSED;
+		wdt_disable();
+	}
+	MCU_vidEnableInterrupts();
+}
+
+extern void WDG_vidResume(void)
+{
+	MCU_vidDisableInterrupts();
+	if (u8WdgState == WDG_u8STATE_PAUSED){
+		/* a full timeout from now */
+		wdt_enable(WDG_u8HW_TIMEOUT);
+		u8WdgState = WDG_u8STATE_RUNNING;
+	}
+	MCU_vidEnableInterrupts();
+}
+
+/*************************************************************************************************************
+* Function				: WDG_eSetWindow
+* Description			: Set the window of a task, the first one closes u16DelayMs + u16WindowMs from now.
+						  SCH_u8AddTask gives every task its period + WDG_u16DEFAULT_SLACK_MS, delayed by the
+						  offset of its first release.
+* Parameters[in]		: [u8TaskId] ID returned by SCH_u8AddTask
+						  [u16WindowMs] longest time between two completed runs in ms, WDG_u16NO_WINDOW to stop
+						  supervising the task
+						  [u16DelayMs] extra time given to the first run in ms (release offset of the task)
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the ID is invalid
+*
+**************************************************************************************************************/
+extern STD_ERR_T WDG_eSetWindow(uint8 u8TaskId, uint16 u16WindowMs, uint16 u16DelayMs)
+{
+	STD_ERR_T errRetVal = STD_ERR_NOK;
+
+	if (u8TaskId < SCH_u8MAX_TASKS){
+		MCU_vidDisableInterrupts();
+		astrWdgTasks[u8TaskId].u16WindowMs = u16WindowMs;
+		astrWdgTasks[u8TaskId].u32LeftMs = (uint32)u16DelayMs + u16WindowMs;
+		MCU_vidEnableInterrupts();
+		errRetVal = STD_ERR_OK;
+	}
+	return errRetVal;
+}
+
+/*************************************************************************************************************
+* Function				: WDG_vidTaskStart
+* Description			: A task run starts, called by SCH_vidDispatch.
+* Parameters[in]		: [u8TaskId] ID returned by SCH_u8AddTask
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WDG_vidTaskStart(uint8 u8TaskId)
+{
+	/* single byte store, no need to lock out the tick ISR */
+	u8WdgRunningTask = u8TaskId;
+}
+
+/*************************************************************************************************************
+* Function				: WDG_vidCheckIn
+* Description			: A task run returns, called by SCH_vidDispatch. A long task may also check itself in
+						  between two steps of its work.
+* Parameters[in]		: [u8TaskId] ID returned by SCH_u8AddTask
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WDG_vidCheckIn(uint8 u8TaskId)
+{
+	if (u8TaskId < SCH_u8MAX_TASKS){
+		MCU_vidDisableInterrupts();
+		astrWdgTasks[u8TaskId].u32LeftMs = astrWdgTasks[u8TaskId].u16WindowMs;
+		u8WdgRunningTask = MCU_u8NO_TASK;
+		MCU_vidEnableInterrupts();
+	}
+}
+
+/*************************************************************************************************************
+* Function				: WDG_vidTickIsr
+* Description			: Count the windows down and kick the watchdog, called from the Timer 0 tick ISR by
+						  SCH_vidTimIsr. On the first closed window the crash record is saved and the watchdog
+						  is set to reset the CPU in 15 ms.
+* Parameters[in]		: [u16ElapsedMs] ms since the previous tick (more than 1 after a stretched tick)
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WDG_vidTickIsr(uint16 u16ElapsedMs)
+{
+	WDG_tstrTask *pstrTask = astrWdgTasks;
+	MCU_tstrCrashRecord strRecord;
+	uint8 u8TaskId;
+
+	if (u8WdgState == WDG_u8STATE_RUNNING){
+		for (u8TaskId = 0; u8TaskId < SCH_u8MAX_TASKS; u8TaskId++, pstrTask++){
+			if (pstrTask->u16WindowMs != WDG_u16NO_WINDOW){
+				if (pstrTask->u32LeftMs > u16ElapsedMs){
+					pstrTask->u32LeftMs -= u16ElapsedMs;
+				} else {
+					strRecord.u8Cause = MCU_u8CRASH_TASK_WINDOW;
+					strRecord.u8TaskId = u8TaskId;
+					strRecord.u8RunningTaskId = u8WdgRunningTask;
+					strRecord.u16Pc = TIM_u16T0GetInterruptedPc();
+					strRecord.u32TickMs = TIM_u32GetMillis();
+					MCU_vidSaveCrashRecord(&strRecord);
+					/* no more kicks, do not wait for the whole timeout */
+					wdt_enable(WDTO_15MS);
+					u8WdgState = WDG_u8STATE_EXPIRED;
+					break;
+				}
+			}
+		}
+		if (u8WdgState == WDG_u8STATE_RUNNING){
+			wdt_reset();
+		}
+	}
+}
@@ -0,0 +1,122 @@
+/*! \file WDG_supervisor.h \brief Watchdog supervisor of the scheduler tasks. */
+/*************************************************************************************************************
+*
+* File Name		: 'WDG_supervisor.h'
+* Title			: Watchdog supervisor of the scheduler tasks
+* Version		: 1.0
+* Target MCU	: Atmel AVR Series
+*
+*  Every supervised task has a window: the longest time allowed between two completed runs. SCH_vidDispatch
+*  checks a task in when its run returns, the Timer 0 tick (SCH_vidTimIsr --> WDG_vidTickIsr) counts the
+*  windows down and kicks the hardware watchdog only while all of them are open:
+*
+*	task run returns --> WDG_vidCheckIn --> window reloaded
+*	1 ms tick --> WDG_vidTickIsr --> all windows open --> wdt_reset
+*	                             --> a window closed  --> crash record (.noinit) --> watchdog reset in 15 ms
+*
+*  A task stuck in a loop keeps the tick running, the record then holds the task and the interrupted program
+*  counter. A hang with the interrupts disabled stops the kicks as well, it is reported as a watchdog reset
+*  without record. The record is printed by MCU_vidResetSrcCheck after the reboot.
+*
+*  Timer 0 stops in power save / power down while the watchdog keeps counting: pause the supervisor around
+*  such a sleep (WDG_vidPause / WDG_vidResume, done by RTC_ePowerSave).
+*
+*************************************************************************************************************/
+#ifndef WDG_SUPERVISOR_H_
+#define WDG_SUPERVISOR_H_
+
+
+/*---------------------------------------------------- INCLUDES --------------------------------------------*/
+
+#include "MCU.h"
+#include "Std_Types.h"
+#include "SCH_scheduler.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+/* hardware watchdog timeout (avr/wdt.h), longer than a stretched tick (TIM_u8T0_STRETCH_MAX_MS) */
+#define WDG_u8HW_TIMEOUT		WDTO_500MS
+
+/* window given by SCH_u8AddTask: the task period plus this slack for the execution time and the jitter */
+#define WDG_u16DEFAULT_SLACK_MS	500U
+
+/* window of an unsupervised task */
+#define WDG_u16NO_WINDOW		0U
+
+/*--------------------------------------------- FUNCTION Definitions ----------------------------------------*/
+
+/*************************************************************************************************************
+* Function				: WDG_vidInit
+* Description			: Unsupervise all the tasks and start the hardware watchdog, called by SCH_vidSchInit.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WDG_vidInit(void);
+
+/*************************************************************************************************************
+* Function				: WDG_vidStop
+* Description			: Stop the hardware watchdog and the supervision until WDG_vidInit, the windows are kept.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WDG_vidStop(void);
+
+/*************************************************************************************************************
+* Function				: WDG_vidPause / WDG_vidResume
+* Description			: Stop the hardware watchdog around a sleep that halts Timer 0 (power save, power down)
+						  and restart it after, the windows keep the time left (they are not counted while
+						  Timer 0 is stopped). Called by RTC_ePowerSave. Do nothing unless the supervisor runs /
+						  was paused.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WDG_vidPause(void);
+extern void WDG_vidResume(void);
+
+/*************************************************************************************************************
+* Function				: WDG_eSetWindow
+* Description			: Set the window of a task, the first one closes u16DelayMs + u16WindowMs from now.
+						  SCH_u8AddTask gives every task its period + WDG_u16DEFAULT_SLACK_MS, delayed by the
+						  offset of its first release.
+* Parameters[in]		: [u8TaskId] ID returned by SCH_u8AddTask
+						  [u16WindowMs] longest time between two completed runs in ms, WDG_u16NO_WINDOW to stop
+						  supervising the task
+						  [u16DelayMs] extra time given to the first run in ms (release offset of the task)
+* Parameters[in/out]	: None
+* Parameters[out]		: STD_ERR_T STD_ERR_NOK if the ID is invalid
+*
+**************************************************************************************************************/
+extern STD_ERR_T WDG_eSetWindow(uint8 u8TaskId, uint16 u16WindowMs, uint16 u16DelayMs);
+
+/*************************************************************************************************************
+* Function				: WDG_vidTaskStart / WDG_vidCheckIn
+* Description			: A task run starts / returns, called by SCH_vidDispatch around every run. A long task
+						  may also check itself in between two steps of its work.
+* Parameters[in]		: [u8TaskId] ID returned by SCH_u8AddTask
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WDG_vidTaskStart(uint8 u8TaskId);
+extern void WDG_vidCheckIn(uint8 u8TaskId);
+
+/*************************************************************************************************************
+* Function				: WDG_vidTickIsr
+* Description			: Count the windows down and kick the watchdog, called from the Timer 0 tick ISR by
+						  SCH_vidTimIsr. On the first closed window the crash record is saved and the watchdog
+						  is set to reset the CPU in 15 ms.
+* Parameters[in]		: [u16ElapsedMs] ms since the previous tick (more than 1 after a stretched tick)
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+**************************************************************************************************************/
+extern void WDG_vidTickIsr(uint16 u16ElapsedMs);
+
+
+#endif /* WDG_SUPERVISOR_H_ */
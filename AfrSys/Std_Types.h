@@ -9,6 +9,7 @@
 #ifndef STD_TYPES_H_
 #define STD_TYPES_H_
 
+#include <stdint.h>
 #include "Common_Macros.h"
 
 
@@ -23,12 +24,13 @@
 
 typedef unsigned char         boolean;       /*        TRUE .. FALSE           */
 
-typedef signed char           sint8;         /*        -128 .. +127            */
-typedef unsigned char         uint8;         /*           0 .. 255             */
-typedef signed short          sint16;        /*      -32768 .. +32767          */
-typedef unsigned short        uint16;        /*           0 .. 65535           */
-typedef signed long           sint32;        /* -2147483648 .. +2147483647     */
-typedef unsigned long         uint32;        /*           0 .. 4294967295      */
+/* exact width types, the same on avr-gcc (long is 32 bits) and on a 64 bits host build */
+typedef int8_t                sint8;         /*        -128 .. +127            */
+typedef uint8_t               uint8;         /*           0 .. 255             */
+typedef int16_t               sint16;        /*      -32768 .. +32767          */
+typedef uint16_t              uint16;        /*           0 .. 65535           */
+typedef int32_t               sint32;        /* -2147483648 .. +2147483647     */
+typedef uint32_t              uint32;        /*           0 .. 4294967295      */
 
 
 typedef uint8	STD_ERR_T;
@@ -17,8 +17,10 @@
 #include "SCI_uart.h"
 #include "SPI.h"
 #include "LOG_uartLogger.h"
-#include "adc.h"
+#include "ADC.h"
 #include "TIM_timers.h"
+#include "OS/SCH_scheduler.h"
+#include "OS/SWT_softTimers.h"
 
 
 int main(void)
@@ -45,6 +47,13 @@ int main(void)
 
 	//ADC_vidInit();
 	
+	SCH_vidSchInit();
+	SCH_u8AddTask(SCH_vidTask1, SCH_u32TASK1_PERIOD, 0);
+	SCH_u8AddTask(SCH_vidTask2, SCH_u32TASK2_PERIOD, 0);
+	/* half a period apart from task 2 so the two loggers never share a tick */
+	SCH_u8AddTask(SCH_vidTask3, SCH_u32TASK3_PERIOD, 500);
+	(void)SWT_eStart(SWT_u8Create(SCH_vidHeartBeat, SWT_u8PERIODIC, SWT_u8CTX_DEFERRED), SCH_u16HEARTBEAT_PERIOD);
+	
 	MCU_vidEnableInterrupts();
 
 
@@ -56,10 +65,12 @@ int main(void)
 	MCU_vidResetSrcCheck();
 
 	while(1) {
-		INFO("logger test! \n");
-		SPI_eSendByte(0x01);
-				
-		_delay_ms(1000);
+		/* the tick ISR only flags released tasks, they run here */
+		SCH_vidDispatch();
+		/* hand the deferred log records (if any) to the UART */
+		LOG_vidDrain();
+		/* sleep until the next release or any other interrupt */
+		SCH_vidIdle();
 	}
 	//uint32 temp;
 
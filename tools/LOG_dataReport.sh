@@ -0,0 +1,51 @@
+#!/bin/sh
+#
+# LOG_dataReport.sh - report the SRAM (.data) saved by keeping the log format strings in flash.
+#
+# Usage : tools/LOG_dataReport.sh [build dir]      (default: AfrSys/Debug)
+#
+# Every INFO / LOG_vidPrint literal is emitted through PSTR as a static __c array; before that, avr-libc
+# copied each one into .data at start up. With -fdata-sections (set by the AfrSys build) each literal gets
+# its own .progmem.data.__c.<n> section, summing those over the objects gives the number of .data bytes
+# saved. The other PROGMEM data (the waveform tables, the switch tables of gcc, or literals built without
+# -fdata-sections) is summed apart. The final .data/.bss of the firmware are printed for reference.
+# Needs the AVR binutils in PATH (or AVR_OBJDUMP / AVR_SIZE pointing at them).
+
+BUILD_DIR=${1:-AfrSys/Debug}
+OBJDUMP=${AVR_OBJDUMP:-avr-objdump}
+SIZE=${AVR_SIZE:-avr-size}
+RAM_SIZE=${RAM_SIZE:-1024}
+
+if [ ! -d "$BUILD_DIR" ]; then
+	echo "no build directory '$BUILD_DIR'" >&2
+	exit 1
+fi
+
+echo "Log format strings (PSTR literals) moved from .data to flash:"
+TOTAL=0
+OTHER=0
+for OBJ in $(find "$BUILD_DIR" -name '*.o' | sort); do
+	BYTES=0
+	for HEX in $("$OBJDUMP" -h "$OBJ" | awk '$2 ~ /^\.progmem\.data\.__c\./ { print $3 }'); do
+		BYTES=$((BYTES + 0x$HEX))
+	done
+	if [ "$BYTES" -ne 0 ]; then
+		printf "  %-40s %6d bytes\n" "${OBJ#$BUILD_DIR/}" "$BYTES"
+		TOTAL=$((TOTAL + BYTES))
+	fi
+	for HEX in $("$OBJDUMP" -h "$OBJ" | awk '$2 ~ /^\.progmem/ && $2 !~ /^\.progmem\.data\.__c\./ { print $3 }'); do
+		OTHER=$((OTHER + 0x$HEX))
+	done
+done
+printf "  %-40s %6d bytes\n" "total .data saved" "$TOTAL"
+printf "  %-40s %6d bytes\n" "other PROGMEM data (tables, not counted)" "$OTHER"
+
+ELF=$(find "$BUILD_DIR" -maxdepth 1 -name '*.elf' | head -n 1)
+if [ -n "$ELF" ]; then
+	"$SIZE" -A "$ELF" | awk -v ram="$RAM_SIZE" -v elf="$ELF" '
+		$1 == ".data" { data = $2 }
+		$1 == ".bss"  { bss = $2 }
+		END {
+			printf "%s: .data %d bytes, .bss %d bytes, static SRAM %d of %d bytes\n", elf, data, bss, data + bss, ram
+		}'
+fi
@@ -0,0 +1,278 @@
+/*! \file LOG_decoder.c \brief Host decoder for the deferred binary frames of LOG_uartLogger. */
+/************************************************************************************************************
+*
+* File Name		: 'LOG_decoder.c'
+* Title			: Host decoder for the deferred binary frames of LOG_uartLogger
+* Target		: Linux host (any C99 compiler)
+*
+* Usage			: LOG_decoder <firmware.hex> [capture file]
+*				  The format strings are read from the flash image (Intel HEX as produced by the AfrSys
+*				  build) at the FMT_ID address of every frame. The frames are read from the capture file or
+*				  stdin (e.g. a serial port configured with stty). Bytes outside frames are echoed as text.
+*
+************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/*----------------------------------------- MACROS Definitions --------------------------------------------*/
+
+/* must match LOG_uartLogger.h */
+#define LOG_FRAME_SYNC		0xA5U
+#define LOG_FRAME_HEADER	7U
+#define LOG_MAX_ARGS		4U
+#define LOG_MAX_LEN			(LOG_FRAME_HEADER + (LOG_MAX_ARGS * 4U))
+
+#define FLASH_MAX_SIZE		(256UL * 1024UL)
+#define TEXT_MAX_SIZE		512U
+
+/*------------------------------------------ Global Variables ---------------------------------------------*/
+
+static uint8_t au8Flash[FLASH_MAX_SIZE];
+static uint32_t u32FlashSize = 0;
+
+/*-------------------------------------Static functions Definitions ---------------------------------------*/
+
+static int hexByte(const char *pcText)
+{
+	unsigned int uValue;
+
+	if (sscanf(pcText, "%2x", &uValue) != 1){
+		return -1;
+	}
+	return (int)uValue;
+}
+
+/* Load an Intel HEX file into au8Flash, returns 0 on success */
+static int loadHex(const char *pcPath)
+{
+	FILE *pFile = fopen(pcPath, "r");
+	char acLine[600];
+	uint32_t u32Base = 0;
+
+	if (pFile == NULL){
+		perror(pcPath);
+		return -1;
+	}
+	while (fgets(acLine, sizeof(acLine), pFile) != NULL){
+		int iCount, iAddr, iType, iIndex;
+
+		if (acLine[0] != ':'){
+			continue;
+		}
+		iCount = hexByte(&acLine[1]);
+		iAddr = (hexByte(&acLine[3]) << 8) | hexByte(&acLine[5]);
+		iType = hexByte(&acLine[7]);
+		if ((iCount < 0) || (iAddr < 0) || (iType < 0)){
+			fprintf(stderr, "%s: malformed record\n", pcPath);
+			fclose(pFile);
+			return -1;
+		}
+		switch (iType){
+			case 0x00:
+				for (iIndex = 0; iIndex < iCount; iIndex++){
+					uint32_t u32Addr = u32Base + (uint32_t)iAddr + (uint32_t)iIndex;
+					if (u32Addr < FLASH_MAX_SIZE){
+						au8Flash[u32Addr] = (uint8_t)hexByte(&acLine[9 + (2 * iIndex)]);
+						if (u32Addr >= u32FlashSize){
+							u32FlashSize = u32Addr + 1U;
+						}
+					}
+				}
+			break;
+			case 0x02:
+				u32Base = (uint32_t)((hexByte(&acLine[9]) << 8) | hexByte(&acLine[11])) << 4;
+			break;
+			case 0x04:
+				u32Base = (uint32_t)((hexByte(&acLine[9]) << 8) | hexByte(&acLine[11])) << 16;
+			break;
+			default:
+			break;
+		}
+	}
+	fclose(pFile);
+	return 0;
+}
+
+/* Render one record with the AVR data model (int = 16 bit, long = 32 bit, pointers = 16 bit) */
+static void renderRecord(uint16_t u16FmtId, uint8_t u8Sig, const uint8_t *pu8Args, char *pcOut, size_t uSize)
+{
+	uint32_t au32Args[LOG_MAX_ARGS];
+	uint8_t au8Long[LOG_MAX_ARGS];
+	unsigned int uArgCount = u8Sig >> 4;
+	unsigned int uArg;
+	unsigned int uNext = 0;
+	size_t uLen = 0;
+	const char *pcFmt;
+
+	for (uArg = 0; uArg < uArgCount; uArg++){
+		au8Long[uArg] = (uint8_t)((u8Sig >> uArg) & 0x01U);
+		if (au8Long[uArg]){
+			au32Args[uArg] = (uint32_t)pu8Args[0] | ((uint32_t)pu8Args[1] << 8) |
+							 ((uint32_t)pu8Args[2] << 16) | ((uint32_t)pu8Args[3] << 24);
+			pu8Args += 4;
+		} else {
+			au32Args[uArg] = (uint32_t)pu8Args[0] | ((uint32_t)pu8Args[1] << 8);
+			pu8Args += 2;
+		}
+	}
+
+	if (u16FmtId == 0U){
+		snprintf(pcOut, uSize, "<%u log records lost>", (unsigned int)au32Args[0]);
+		return;
+	}
+	if (u16FmtId >= u32FlashSize){
+		snprintf(pcOut, uSize, "<unknown format 0x%04X>", u16FmtId);
+		return;
+	}
+
+	pcFmt = (const char *)&au8Flash[u16FmtId];
+	while ((*pcFmt != '\0') && (uLen + 1U < uSize)){
+		char acSpec[32];
+		size_t uSpecLen = 0;
+		long long llValue;
+		char cConv;
+
+		if (*pcFmt != '%'){
+			pcOut[uLen++] = *pcFmt++;
+			continue;
+		}
+		/* copy flags, width and precision, drop the length modifiers */
+		acSpec[uSpecLen++] = *pcFmt++;
+		while ((*pcFmt != '\0') && (strchr("-+ #0123456789.", *pcFmt) != NULL) && (uSpecLen < 20U)){
+			acSpec[uSpecLen++] = *pcFmt++;
+		}
+		while ((*pcFmt == 'l') || (*pcFmt == 'h')){
+			pcFmt++;
+		}
+		cConv = *pcFmt;
+		if (cConv == '\0'){
+			break;
+		}
+		pcFmt++;
+		if (cConv == '%'){
+			pcOut[uLen++] = '%';
+			continue;
+		}
+		if (uNext >= uArgCount){
+			uLen += (size_t)snprintf(&pcOut[uLen], uSize - uLen, "<missing>");
+			continue;
+		}
+		uArg = uNext++;
+		switch (cConv){
+			case 'd':
+			case 'i':
+				llValue = au8Long[uArg] ? (long long)(int32_t)au32Args[uArg] : (long long)(int16_t)au32Args[uArg];
+				memcpy(&acSpec[uSpecLen], "lld", 4);
+				uLen += (size_t)snprintf(&pcOut[uLen], uSize - uLen, acSpec, llValue);
+			break;
+			case 'u':
+			case 'x':
+			case 'X':
+			case 'o':
+				acSpec[uSpecLen++] = 'l';
+				acSpec[uSpecLen++] = 'l';
+				acSpec[uSpecLen++] = cConv;
+				acSpec[uSpecLen] = '\0';
+				uLen += (size_t)snprintf(&pcOut[uLen], uSize - uLen, acSpec, (unsigned long long)au32Args[uArg]);
+			break;
+			case 'c':
+				memcpy(&acSpec[uSpecLen], "c", 2);
+				uLen += (size_t)snprintf(&pcOut[uLen], uSize - uLen, acSpec, (int)(uint8_t)au32Args[uArg]);
+			break;
+			case 'S':
+				/* avr-libc: string located in flash, readable from the image */
+				if (au32Args[uArg] < u32FlashSize){
+					memcpy(&acSpec[uSpecLen], "s", 2);
+					uLen += (size_t)snprintf(&pcOut[uLen], uSize - uLen, acSpec, (const char *)&au8Flash[au32Args[uArg]]);
+					break;
+				}
+				/* fall through */
+			default:
+				/* %s, %p and anything else: only the address/raw value was recorded */
+				uLen += (size_t)snprintf(&pcOut[uLen], uSize - uLen, "<%c@0x%04X>", cConv, (unsigned int)au32Args[uArg]);
+			break;
+		}
+	}
+	/* snprintf returns the untruncated length, every branch of the loop may leave uLen past the buffer */
+	if (uLen >= uSize){
+		uLen = uSize - 1U;
+	}
+	/* INFO prints one line, strip the line endings of the format string */
+	while ((uLen > 0U) && ((pcOut[uLen - 1U] == '\n') || (pcOut[uLen - 1U] == '\r'))){
+		uLen--;
+	}
+	pcOut[uLen] = '\0';
+}
+
+/*------------------------------------ Global Functions Definitions----------------------------------------*/
+
+int main(int argc, char **argv)
+{
+	FILE *pIn = stdin;
+	uint8_t au8Body[LOG_MAX_LEN];
+	char acText[TEXT_MAX_SIZE];
+	int iByte;
+
+	if ((argc < 2) || (argc > 3)){
+		fprintf(stderr, "usage: %s <firmware.hex> [capture file]\n", argv[0]);
+		return 2;
+	}
+	if (loadHex(argv[1]) != 0){
+		return 1;
+	}
+	if (argc == 3){
+		pIn = fopen(argv[2], "rb");
+		if (pIn == NULL){
+			perror(argv[2]);
+			return 1;
+		}
+	}
+
+	while ((iByte = fgetc(pIn)) != EOF){
+		int iLen;
+		int iIndex;
+		uint8_t u8Chk;
+
+		if (iByte != LOG_FRAME_SYNC){
+			/* plain text printed by LOG_vidPrint / LOG_vidPrintLn */
+			if (iByte != '\r'){
+				putchar(iByte);
+			}
+			continue;
+		}
+		iLen = fgetc(pIn);
+		if ((iLen < (int)LOG_FRAME_HEADER) || (iLen > (int)LOG_MAX_LEN)){
+			fprintf(stderr, "<bad frame length>\n");
+			continue;
+		}
+		u8Chk = (uint8_t)iLen;
+		for (iIndex = 0; iIndex < iLen; iIndex++){
+			iByte = fgetc(pIn);
+			if (iByte == EOF){
+				break;
+			}
+			au8Body[iIndex] = (uint8_t)iByte;
+			u8Chk ^= (uint8_t)iByte;
+		}
+		iByte = fgetc(pIn);
+		if ((iIndex != iLen) || (iByte == EOF)){
+			break;
+		}
+		if ((uint8_t)iByte != u8Chk){
+			fprintf(stderr, "<bad frame checksum>\n");
+			continue;
+		}
+		renderRecord((uint16_t)(au8Body[1] | (au8Body[2] << 8)), au8Body[0], &au8Body[LOG_FRAME_HEADER],
+					 acText, sizeof(acText));
+		printf("[%10lu ms] %s\n", (unsigned long)((uint32_t)au8Body[3] | ((uint32_t)au8Body[4] << 8) |
+				((uint32_t)au8Body[5] << 16) | ((uint32_t)au8Body[6] << 24)), acText);
+		fflush(stdout);
+	}
+	if (pIn != stdin){
+		fclose(pIn);
+	}
+	return 0;
+}
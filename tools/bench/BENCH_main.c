@@ -0,0 +1,117 @@
+/*! \file BENCH_main.c \brief Cycle benchmark firmware of the MCAL hot paths. */
+/************************************************************************************************************
+*
+* File Name		: 'BENCH_main.c'
+* Title			: Cycle benchmark firmware of the MCAL hot paths
+* Target		: ATmega8 under simavr (tools/bench/BENCH_simavr.c)
+*
+* Runs every case BENCH_u8ITER times between a START and a STOP marker (see BENCH_markers.h), then starts
+* the scheduler tick and the waveform generator for BENCH_u16ISR_PHASE_MS so the harness can time the
+* TIMER0_OVF_vect and TIMER1_OVF_vect ISRs. Only the peripherals of the running case have their interrupts
+* enabled.
+*
+************************************************************************************************************/
+
+/*------------------------------------------------- INCLUDES ----------------------------------------------*/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "MCU.h"
+#include "DIO.h"
+#include "SCI_uart.h"
+#include "SPI.h"
+#include "ADC.h"
+#include "LOG_uartLogger.h"
+#include "TIM_timers.h"
+#include "WAV_waveGen.h"
+#include "OS/SCH_scheduler.h"
+#include "BENCH_markers.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+#define BENCH_MARK(MARK, ARG)	do { TWAR = (uint8)(ARG); TWBR = (MARK); } while (0)
+
+/* keeps the calls in the loop and the empty loop identical to the others */
+#define BENCH_BARRIER()			__asm__ __volatile__ ("" ::: "memory")
+
+#define BENCH_RUN(CASE, BODY)	do { \
+									uint8 u8BenchIter; \
+									BENCH_MARK(BENCH_u8MARK_START, (CASE)); \
+									for (u8BenchIter = 0; u8BenchIter < BENCH_u8ITER; u8BenchIter++){ \
+										BODY; \
+										BENCH_BARRIER(); \
+									} \
+									BENCH_MARK(BENCH_u8MARK_STOP, BENCH_u8ITER); \
+								} while (0)
+
+/*-------------------------------------Static functions Definitions ---------------------------------------*/
+
+/* let the UDRE ISR send the bytes queued by a case */
+static void BENCH_vidUartFlush(void)
+{
+	MCU_vidEnableInterrupts();
+	while (UART_u8GetTxFree() < (u8TX_BUFFER_SIZE - 1U)){
+	}
+	MCU_vidDisableInterrupts();
+}
+
+/*------------------------------------------------- MAIN --------------------------------------------------*/
+
+int main(void)
+{
+	uint32 u32StartMs;
+
+	MCU_vidDisableInterrupts();
+
+	DIO_vidSetPinMode(DIO_PB1, OUTPUT);
+	LOG_vidInit();
+	SPI_vidMasterInit();
+	ADC_vidInit();
+
+	BENCH_RUN(BENCH_u8CASE_EMPTY, );
+	BENCH_RUN(BENCH_u8CASE_DIO_WRITE, DIO_vidDigitalPinWrite(DIO_PB1, u8BenchIter & 1U));
+	BENCH_RUN(BENCH_u8CASE_DIO_FAST, DIO_vidPinWriteFast(DIO_PB1, u8BenchIter & 1U));
+
+	/* ring enqueue only, the UDRE ISR runs after STOP */
+	BENCH_RUN(BENCH_u8CASE_UART_SEND, UART_sendByte('a' + u8BenchIter));
+	BENCH_vidUartFlush();
+
+	/* polled transfer, waits for the byte on the bus */
+	BENCH_RUN(BENCH_u8CASE_SPI_SEND, (void)SPI_eSendByte(u8BenchIter));
+
+	/* polled conversion (ADC_READ_MODE default), the interrupts are on for ADC_READ_NOISE_REDUCTION builds */
+	MCU_vidEnableInterrupts();
+	BENCH_RUN(BENCH_u8CASE_ADC_READ, (void)ADC_u16Read(0U));
+	MCU_vidDisableInterrupts();
+
+	BENCH_RUN(BENCH_u8CASE_LOG_PRINTLN, LOG_vidPrintLn("t=%u", u8BenchIter));
+	BENCH_vidUartFlush();
+
+	/* tick handler alone, the ISR phase below times it with the rest of the Timer0 ISR */
+	BENCH_RUN(BENCH_u8CASE_SCH_TIM_ISR, SCH_vidTimIsr());
+
+	/* per sample cost of the waveform generator, both channels */
+	(void)WAV_eSetTables(WAV_au8Sine, WAV_au8Sine, WAV_u8PHASE_90_DEG);
+	(void)WAV_eSetFrequency(50000UL);
+	BENCH_RUN(BENCH_u8CASE_WAV_STEP, WAV_vidStep());
+
+	/* both ISRs together, each one adds to the latency of the other */
+	SCH_vidSchInit();
+	WAV_vidInit(TIM1_CHA_CHB_NON_INVERTING);
+	WAV_vidStart();
+	MCU_vidEnableInterrupts();
+	u32StartMs = TIM_u32GetMillis();
+	while ((TIM_u32GetMillis() - u32StartMs) < BENCH_u16ISR_PHASE_MS){
+	}
+	MCU_vidDisableInterrupts();
+	WAV_vidStop();
+
+	BENCH_MARK(BENCH_u8MARK_END, 0U);
+	/* sleeping with the interrupts disabled ends the simavr run */
+	cli();
+	sleep_enable();
+	sleep_cpu();
+	while (1){
+	}
+}
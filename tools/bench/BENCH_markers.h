@@ -0,0 +1,47 @@
+/*! \file BENCH_markers.h \brief Marker protocol between the benchmark firmware and the simavr harness. */
+/************************************************************************************************************
+*
+* File Name		: 'BENCH_markers.h'
+* Title			: Marker protocol between the benchmark firmware and the simavr harness
+* Target		: ATmega8 firmware / Linux host
+*
+* The firmware writes the argument to TWAR then the marker to TWBR, the harness hooks the TWBR writes and
+* takes the simulated cycle counter. The TWI is not used by AfrSys so both registers are free.
+*	START	arg = case id, cycles counted from here
+*	STOP	arg = calls done since START
+*	END		all cases done, the harness prints its table
+*
+************************************************************************************************************/
+
+#ifndef BENCH_MARKERS_H_
+#define BENCH_MARKERS_H_
+
+/*----------------------------------------- MACROS Definitions --------------------------------------------*/
+
+/* data space addresses */
+#define BENCH_u8MARK_ADDR			0x20U		/* TWBR */
+#define BENCH_u8ARG_ADDR			0x22U		/* TWAR */
+
+#define BENCH_u8MARK_START			0x01U
+#define BENCH_u8MARK_STOP			0x02U
+#define BENCH_u8MARK_END			0x03U
+
+/* cases, BENCH_u8CASE_EMPTY is the loop and marker overhead removed from the others */
+#define BENCH_u8CASE_EMPTY			0U
+#define BENCH_u8CASE_DIO_WRITE		1U
+#define BENCH_u8CASE_DIO_FAST		2U
+#define BENCH_u8CASE_UART_SEND		3U
+#define BENCH_u8CASE_SPI_SEND		4U
+#define BENCH_u8CASE_ADC_READ		5U
+#define BENCH_u8CASE_LOG_PRINTLN	6U
+#define BENCH_u8CASE_SCH_TIM_ISR	7U
+#define BENCH_u8CASE_WAV_STEP		8U
+#define BENCH_u8NO_OF_CASES			9U
+
+/* calls per START / STOP, the UART and LOG cases must fit the 64 bytes TX ring */
+#define BENCH_u8ITER				8U
+
+/* Timer0 ticks measured by the harness in the ISR phase */
+#define BENCH_u16ISR_PHASE_MS		250U
+
+#endif /* BENCH_MARKERS_H_ */
@@ -0,0 +1,352 @@
+/*! \file BENCH_simavr.c \brief simavr harness of the cycle benchmark firmware. */
+/************************************************************************************************************
+*
+* File Name		: 'BENCH_simavr.c'
+* Title			: simavr harness of the cycle benchmark firmware
+* Target		: Linux host, libsimavr
+*
+* Runs BENCH_main.c on a simulated ATmega8 at 1 MHz, takes the cycle counter at every marker write (see
+* BENCH_markers.h) and at the pending / entry / return events of the TIMER0_OVF and TIMER1_OVF vectors, then
+* prints the cycles per call of every case and compares them with a baseline file.
+*
+* Usage : BENCH_simavr <firmware.elf> [--baseline <file>] [--update-baseline] [--threshold <percent>]
+*		  exit 1 when a case is slower than its baseline by more than the threshold (default 10 %),
+*		  exit 2 when the firmware could not be run or the --baseline file can not be read (missing,
+*		  unreadable or without any case line) unless --update-baseline writes it.
+*
+* Baseline file: one "<case name> <cycles per call>" line per case, written by --update-baseline. The one of
+* the bench target, tools/bench/BENCH_baseline.txt, is not shipped: measure it once with the
+* bench_update_baseline target on a machine with avr-gcc and libsimavr and commit it, the bench target fails
+* until then.
+*
+************************************************************************************************************/
+
+/*------------------------------------------------- INCLUDES ----------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/sim_io.h>
+#include <simavr/sim_irq.h>
+#include <simavr/sim_interrupts.h>
+#include "BENCH_markers.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+#define BENCH_u32F_CPU				1000000UL
+#define BENCH_u8VECT_T1_OVF			8U			/* vector numbers on the ATmega8 */
+#define BENCH_u8VECT_T0_OVF			9U
+#define BENCH_u8NO_OF_VECTS			2U
+/* after the cases: a latency and a duration row per timed vector */
+#define BENCH_u8NO_OF_ROWS			(BENCH_u8NO_OF_CASES + (2U * BENCH_u8NO_OF_VECTS))
+#define BENCH_u8ROW_T0_LATENCY		BENCH_u8NO_OF_CASES
+#define BENCH_u8ROW_T0_ISR			(BENCH_u8NO_OF_CASES + 1U)
+#define BENCH_u8ROW_T1_LATENCY		(BENCH_u8NO_OF_CASES + 2U)
+#define BENCH_u8ROW_T1_ISR			(BENCH_u8NO_OF_CASES + 3U)
+#define BENCH_u32DEFAULT_THRESHOLD	10UL
+#define BENCH_u64CYCLE_LIMIT		(20ULL * BENCH_u32F_CPU)	/* 20 s of simulated time */
+#define BENCH_u8NAME_LEN			32U
+
+/*------------------------------------------ Type Definitions  --------------------------------------------*/
+
+typedef struct{
+	const char	*pcName;
+	uint64_t	u64Sum;			/* cycles, overhead removed for the cases */
+	uint32_t	u32Calls;
+	uint32_t	u32Min;			/* per call */
+	uint32_t	u32Max;
+	uint32_t	u32Base;		/* cycles per call of the baseline, 0 when none */
+}BENCH_tstrRow;
+
+typedef struct{
+	uint8_t				u8Vect;
+	uint8_t				u8RowLatency;	/* flag raised --> vector entered */
+	uint8_t				u8RowIsr;		/* vector entered --> reti */
+	avr_cycle_count_t	u64Pending;
+	avr_cycle_count_t	u64Entry;
+}BENCH_tstrVect;
+
+/*---------------------------------------------- Global Variables -----------------------------------------*/
+
+static BENCH_tstrRow astrBenchRows[BENCH_u8NO_OF_ROWS] = {
+	{"empty loop (overhead)"},
+	{"DIO_vidDigitalPinWrite"},
+	{"DIO_vidPinWriteFast"},
+	{"UART_sendByte"},
+	{"SPI_eSendByte"},
+	{"ADC_u16Read"},
+	{"LOG_vidPrintLn"},
+	{"SCH_vidTimIsr"},
+	{"WAV_vidStep"},
+	{"TIMER0_OVF latency"},
+	{"TIMER0_OVF_vect"},
+	{"TIMER1_OVF latency"},
+	{"TIMER1_OVF_vect"},
+};
+
+static BENCH_tstrVect astrBenchVects[BENCH_u8NO_OF_VECTS] = {
+	{BENCH_u8VECT_T0_OVF, BENCH_u8ROW_T0_LATENCY, BENCH_u8ROW_T0_ISR},
+	{BENCH_u8VECT_T1_OVF, BENCH_u8ROW_T1_LATENCY, BENCH_u8ROW_T1_ISR},
+};
+
+static uint8_t u8BenchCase = 0xFFU;
+static avr_cycle_count_t u64BenchStart;
+static uint32_t u32BenchOverhead = 0U;		/* cycles of one START / STOP pair of the empty case */
+static avr_t *pstrBenchAvr;
+static int iBenchEnd = 0;
+
+/*-------------------------------------Static functions Definitions ---------------------------------------*/
+
+static void BENCH_vidAddSample(BENCH_tstrRow *pstrRow, uint64_t u64Cycles, uint32_t u32Calls)
+{
+	uint32_t u32PerCall = (uint32_t)(u64Cycles / u32Calls);
+
+	if ((pstrRow->u32Calls == 0U) || (u32PerCall < pstrRow->u32Min)){
+		pstrRow->u32Min = u32PerCall;
+	}
+	if (u32PerCall > pstrRow->u32Max){
+		pstrRow->u32Max = u32PerCall;
+	}
+	pstrRow->u64Sum += u64Cycles;
+	pstrRow->u32Calls += u32Calls;
+}
+
+static uint32_t BENCH_u32Avg(const BENCH_tstrRow *pstrRow)
+{
+	return (pstrRow->u32Calls != 0U) ? (uint32_t)(pstrRow->u64Sum / pstrRow->u32Calls) : 0U;
+}
+
+/* TWBR write of the firmware */
+static void BENCH_vidOnMark(struct avr_t *pstrAvr, avr_io_addr_t u16Addr, uint8_t u8Mark, void *pvParam)
+{
+	uint8_t u8Arg = pstrAvr->data[BENCH_u8ARG_ADDR];
+	uint64_t u64Cycles;
+
+	(void)pvParam;
+	pstrAvr->data[u16Addr] = u8Mark;
+	switch (u8Mark){
+	case BENCH_u8MARK_START:
+		u8BenchCase = u8Arg;
+		u64BenchStart = pstrAvr->cycle;
+		break;
+	case BENCH_u8MARK_STOP:
+		if ((u8BenchCase < BENCH_u8NO_OF_CASES) && (u8Arg != 0U)){
+			u64Cycles = pstrAvr->cycle - u64BenchStart;
+			if (u8BenchCase == BENCH_u8CASE_EMPTY){
+				u32BenchOverhead = (uint32_t)u64Cycles;
+			} else {
+				u64Cycles = (u64Cycles > u32BenchOverhead) ? (u64Cycles - u32BenchOverhead) : 0U;
+			}
+			BENCH_vidAddSample(&astrBenchRows[u8BenchCase], u64Cycles, u8Arg);
+		}
+		u8BenchCase = 0xFFU;
+		break;
+	case BENCH_u8MARK_END:
+		iBenchEnd = 1;
+		break;
+	default:
+		break;
+	}
+}
+
+/* flag of a timed vector raised */
+static void BENCH_vidOnVectPending(struct avr_irq_t *pstrIrq, uint32_t u32Value, void *pvParam)
+{
+	BENCH_tstrVect *pstrVect = (BENCH_tstrVect *)pvParam;
+
+	(void)pstrIrq;
+	if (u32Value != 0U){
+		pstrVect->u64Pending = pstrBenchAvr->cycle;
+	}
+}
+
+/* timed vector entered (1) or returned with reti (0) */
+static void BENCH_vidOnVectRunning(struct avr_irq_t *pstrIrq, uint32_t u32Value, void *pvParam)
+{
+	BENCH_tstrVect *pstrVect = (BENCH_tstrVect *)pvParam;
+
+	(void)pstrIrq;
+	if (u32Value != 0U){
+		pstrVect->u64Entry = pstrBenchAvr->cycle;
+		BENCH_vidAddSample(&astrBenchRows[pstrVect->u8RowLatency], pstrVect->u64Entry - pstrVect->u64Pending, 1U);
+	} else {
+		BENCH_vidAddSample(&astrBenchRows[pstrVect->u8RowIsr], pstrBenchAvr->cycle - pstrVect->u64Entry, 1U);
+	}
+}
+
+/* returns the number of case lines found, -1 when the file can not be opened */
+static int BENCH_iReadBaseline(const char *pcPath)
+{
+	FILE *pstrFile = fopen(pcPath, "r");
+	char acLine[128];
+	char acName[BENCH_u8NAME_LEN];
+	unsigned long u32Cycles;
+	uint8_t u8Row;
+	int iNameEnd;
+	int iFound = 0;
+
+	if (pstrFile == NULL){
+		perror(pcPath);
+		return -1;
+	}
+	while (fgets(acLine, sizeof(acLine), pstrFile) != NULL){
+		/* the names hold spaces, the cycles are the last field */
+		char *pcLast = strrchr(acLine, ' ');
+
+		if ((acLine[0] == '#') || (pcLast == NULL) || (sscanf(pcLast, "%lu", &u32Cycles) != 1)){
+			continue;
+		}
+		iNameEnd = (int)(pcLast - acLine);
+		if (iNameEnd >= (int)BENCH_u8NAME_LEN){
+			continue;
+		}
+		memcpy(acName, acLine, (size_t)iNameEnd);
+		acName[iNameEnd] = '\0';
+		for (u8Row = 0; u8Row < BENCH_u8NO_OF_ROWS; u8Row++){
+			if (strcmp(acName, astrBenchRows[u8Row].pcName) == 0){
+				astrBenchRows[u8Row].u32Base = (uint32_t)u32Cycles;
+				iFound++;
+			}
+		}
+	}
+	if (ferror(pstrFile)){
+		perror(pcPath);
+		iFound = -1;
+	}
+	fclose(pstrFile);
+	return iFound;
+}
+
+static int BENCH_iWriteBaseline(const char *pcPath)
+{
+	FILE *pstrFile = fopen(pcPath, "w");
+	uint8_t u8Row;
+
+	if (pstrFile == NULL){
+		perror(pcPath);
+		return 0;
+	}
+	fprintf(pstrFile, "# cycles per call of tools/bench/BENCH_main.c on an ATmega8 at 1 MHz (simavr)\n");
+	for (u8Row = 0; u8Row < BENCH_u8NO_OF_ROWS; u8Row++){
+		if (astrBenchRows[u8Row].u32Calls != 0U){
+			fprintf(pstrFile, "%s %lu\n", astrBenchRows[u8Row].pcName, (unsigned long)BENCH_u32Avg(&astrBenchRows[u8Row]));
+		}
+	}
+	fclose(pstrFile);
+	return 1;
+}
+
+/* print the table, returns the number of rows over the threshold */
+static int BENCH_iReport(uint32_t u32Threshold)
+{
+	const BENCH_tstrRow *pstrRow;
+	uint32_t u32Avg;
+	uint8_t u8Row;
+	int iFailed = 0;
+	long s32Delta;
+
+	printf("%-24s %8s %8s %8s %8s %8s %9s\n", "case", "calls", "avg", "min", "max", "baseline", "delta");
+	for (u8Row = 0; u8Row < BENCH_u8NO_OF_ROWS; u8Row++){
+		pstrRow = &astrBenchRows[u8Row];
+		u32Avg = BENCH_u32Avg(pstrRow);
+		printf("%-24s %8lu %8lu %8lu %8lu", pstrRow->pcName, (unsigned long)pstrRow->u32Calls,
+			   (unsigned long)u32Avg, (unsigned long)pstrRow->u32Min, (unsigned long)pstrRow->u32Max);
+		if ((u8Row == BENCH_u8CASE_EMPTY) || (pstrRow->u32Base == 0U)){
+			printf(" %8s %9s\n", "-", "-");
+			continue;
+		}
+		s32Delta = (((long)u32Avg - (long)pstrRow->u32Base) * 100L) / (long)pstrRow->u32Base;
+		printf(" %8lu %8ld%%", (unsigned long)pstrRow->u32Base, s32Delta);
+		if ((pstrRow->u32Calls == 0U) || ((uint64_t)u32Avg * 100U > (uint64_t)pstrRow->u32Base * (100U + u32Threshold))){
+			printf("  REGRESSION");
+			iFailed++;
+		}
+		printf("\n");
+	}
+	return iFailed;
+}
+
+/*------------------------------------------------- MAIN --------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+	elf_firmware_t strFirmware;
+	avr_t *pstrAvr;
+	avr_irq_t *pstrIrq;
+	uint8_t u8Vect;
+	const char *pcElf = NULL;
+	const char *pcBaseline = NULL;
+	uint32_t u32Threshold = BENCH_u32DEFAULT_THRESHOLD;
+	int iUpdate = 0;
+	int iState = cpu_Running;
+	int iArg;
+	int iFailed;
+
+	for (iArg = 1; iArg < argc; iArg++){
+		if ((strcmp(argv[iArg], "--baseline") == 0) && ((iArg + 1) < argc)){
+			pcBaseline = argv[++iArg];
+		} else if (strcmp(argv[iArg], "--update-baseline") == 0){
+			iUpdate = 1;
+		} else if ((strcmp(argv[iArg], "--threshold") == 0) && ((iArg + 1) < argc)){
+			u32Threshold = (uint32_t)strtoul(argv[++iArg], NULL, 0);
+		} else {
+			pcElf = argv[iArg];
+		}
+	}
+	if (pcElf == NULL){
+		fprintf(stderr, "usage: %s <firmware.elf> [--baseline <file>] [--update-baseline] [--threshold <percent>]\n", argv[0]);
+		return 2;
+	}
+
+	/* a run without any comparison would pass every regression */
+	if ((pcBaseline != NULL) && (iUpdate == 0) && (BENCH_iReadBaseline(pcBaseline) <= 0)){
+		fprintf(stderr, "%s: no usable baseline, create it with --update-baseline\n", pcBaseline);
+		return 2;
+	}
+
+	memset(&strFirmware, 0, sizeof(strFirmware));
+	if (elf_read_firmware(pcElf, &strFirmware) != 0){
+		fprintf(stderr, "%s: cannot read the firmware\n", pcElf);
+		return 2;
+	}
+	pstrAvr = avr_make_mcu_by_name("atmega8");
+	if (pstrAvr == NULL){
+		fprintf(stderr, "simavr has no atmega8 core\n");
+		return 2;
+	}
+	avr_init(pstrAvr);
+	strFirmware.frequency = BENCH_u32F_CPU;
+	avr_load_firmware(pstrAvr, &strFirmware);
+
+	pstrBenchAvr = pstrAvr;
+	avr_register_io_write(pstrAvr, BENCH_u8MARK_ADDR, BENCH_vidOnMark, NULL);
+	for (u8Vect = 0; u8Vect < BENCH_u8NO_OF_VECTS; u8Vect++){
+		pstrIrq = avr_get_interrupt_irq(pstrAvr, astrBenchVects[u8Vect].u8Vect);
+		avr_irq_register_notify(pstrIrq + AVR_INT_IRQ_PENDING, BENCH_vidOnVectPending, &astrBenchVects[u8Vect]);
+		avr_irq_register_notify(pstrIrq + AVR_INT_IRQ_RUNNING, BENCH_vidOnVectRunning, &astrBenchVects[u8Vect]);
+	}
+
+	while ((iBenchEnd == 0) && (iState != cpu_Done) && (iState != cpu_Crashed) && (pstrAvr->cycle < BENCH_u64CYCLE_LIMIT)){
+		iState = avr_run(pstrAvr);
+	}
+	if (iBenchEnd == 0){
+		fprintf(stderr, "%s: no END marker after %llu cycles (state %d)\n", pcElf, (unsigned long long)pstrAvr->cycle, iState);
+		return 2;
+	}
+
+	if ((pcBaseline != NULL) && (iUpdate != 0)){
+		if (BENCH_iWriteBaseline(pcBaseline) == 0){
+			return 2;
+		}
+		printf("baseline written to %s\n", pcBaseline);
+	}
+	iFailed = BENCH_iReport(u32Threshold);
+	if (iFailed != 0){
+		printf("%d case(s) slower than the baseline by more than %lu %%\n", iFailed, (unsigned long)u32Threshold);
+		return 1;
+	}
+	return 0;
+}
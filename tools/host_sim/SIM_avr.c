@@ -0,0 +1,899 @@
+/*! \file SIM_avr.c \brief ATmega8 peripheral simulator for the host build. */
+/************************************************************************************************************
+*
+* File Name		: 'SIM_avr.c'
+* Title			: ATmega8 peripheral simulator for the host build
+* Target		: Linux host (gcc / clang)
+*
+************************************************************************************************************/
+
+/*------------------------------------------------- INCLUDES ----------------------------------------------*/
+
+#define SIM_REAL_STDIO
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SIM_avr.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+/* the side effect registers are used through their raw bytes here, their macros would run the models */
+#define SIM_R(ADDR)				(SIM_unMem.au8[(ADDR)])
+#define SIM_u8ADCSRA			0x26U
+#define SIM_u8UCSRA				0x2BU
+#define SIM_u8UDR				0x2CU
+#define SIM_u8SPSR				0x2EU
+#define SIM_u8SPDR				0x2FU
+#define SIM_u8TIFR				0x58U
+#define SIM_u8NO_ACCESS			0xFFU
+
+#define SIM_u64NO_EVENT			0xFFFFFFFFFFFFFFFFULL
+#define SIM_u32T2_ASYNC_HZ		32768UL
+
+/* longest clock advance of one SIM_vidIdleHook call (a main loop waiting on RAM) */
+#define SIM_u16IDLE_CYCLES		1000U
+
+#define SIM_u8SLEEP_MASK		((1U << SM0) | (1U << SM1) | (1U << SM2))
+
+/* weak default of a vector, the ISR() of the firmware replaces it */
+#define SIM_WEAK_ISR(VECTOR)	__attribute__((weak)) void SIM_ISR_##VECTOR(void) {}
+
+/*------------------------------------------ Type Definitions  --------------------------------------------*/
+
+typedef struct{
+	void	(*pfvIsr)(void);
+	uint8	u8FlagAddr;		/* 0: not raised by the simulator */
+	uint8	u8FlagBit;
+	uint8	u8EnableAddr;
+	uint8	u8EnableBit;
+	boolean	bAutoClear;		/* flag cleared when the ISR runs */
+}SIM_tstrVector;
+
+typedef struct{
+	uint64_t	u64Acc;		/* source clock ticks times F_CPU not yet counted */
+}SIM_tstrTimer;
+
+/*---------------------------------------------- Global Variables -----------------------------------------*/
+
+volatile SIM_tunMem SIM_unMem;
+
+SIM_WEAK_ISR(INT0_vect)
+SIM_WEAK_ISR(INT1_vect)
+SIM_WEAK_ISR(TIMER2_COMP_vect)
+SIM_WEAK_ISR(TIMER2_OVF_vect)
+SIM_WEAK_ISR(TIMER1_CAPT_vect)
+SIM_WEAK_ISR(TIMER1_COMPA_vect)
+SIM_WEAK_ISR(TIMER1_COMPB_vect)
+SIM_WEAK_ISR(TIMER1_OVF_vect)
+SIM_WEAK_ISR(TIMER0_OVF_vect)
+SIM_WEAK_ISR(SPI_STC_vect)
+SIM_WEAK_ISR(USART_RXC_vect)
+SIM_WEAK_ISR(USART_UDRE_vect)
+SIM_WEAK_ISR(USART_TXC_vect)
+SIM_WEAK_ISR(ADC_vect)
+SIM_WEAK_ISR(EE_RDY_vect)
+SIM_WEAK_ISR(ANA_COMP_vect)
+SIM_WEAK_ISR(TWI_vect)
+SIM_WEAK_ISR(SPM_RDY_vect)
+
+/* priority order, index + 1 is the vector number */
+static const SIM_tstrVector astrSimVectors[] = {
+	{SIM_ISR_INT0_vect,			0x5AU, INTF0,	0x5BU, INT0,	TRUE},
+	{SIM_ISR_INT1_vect,			0x5AU, INTF1,	0x5BU, INT1,	TRUE},
+	{SIM_ISR_TIMER2_COMP_vect,	0x58U, OCF2,	0x59U, OCIE2,	TRUE},
+	{SIM_ISR_TIMER2_OVF_vect,	0x58U, TOV2,	0x59U, TOIE2,	TRUE},
+	{SIM_ISR_TIMER1_CAPT_vect,	0x58U, ICF1,	0x59U, TICIE1,	TRUE},
+	{SIM_ISR_TIMER1_COMPA_vect,	0x58U, OCF1A,	0x59U, OCIE1A,	TRUE},
+	{SIM_ISR_TIMER1_COMPB_vect,	0x58U, OCF1B,	0x59U, OCIE1B,	TRUE},
+	{SIM_ISR_TIMER1_OVF_vect,	0x58U, TOV1,	0x59U, TOIE1,	TRUE},
+	{SIM_ISR_TIMER0_OVF_vect,	0x58U, TOV0,	0x59U, TOIE0,	TRUE},
+	{SIM_ISR_SPI_STC_vect,		0x2EU, SPIF,	0x2DU, SPIE,	TRUE},
+	{SIM_ISR_USART_RXC_vect,	0x2BU, RXC,		0x2AU, RXCIE,	FALSE},
+	{SIM_ISR_USART_UDRE_vect,	0x2BU, UDRE,	0x2AU, UDRIE,	FALSE},
+	{SIM_ISR_USART_TXC_vect,	0x2BU, TXC,		0x2AU, TXCIE,	TRUE},
+	{SIM_ISR_ADC_vect,			0x26U, ADIF,	0x26U, ADIE,	TRUE},
+	{SIM_ISR_EE_RDY_vect,		0x00U, 0,		0x00U, 0,		FALSE},
+	{SIM_ISR_ANA_COMP_vect,		0x28U, ACI,		0x28U, ACIE,	TRUE},
+	{SIM_ISR_TWI_vect,			0x56U, TWINT,	0x56U, TWIE,	FALSE},
+	{SIM_ISR_SPM_RDY_vect,		0x00U, 0,		0x00U, 0,		FALSE},
+};
+#define SIM_u8NO_OF_VECTORS		((uint8)(sizeof(astrSimVectors) / sizeof(astrSimVectors[0])))
+#define SIM_u8VECT_SPI			10U
+#define SIM_u8VECT_RXC			11U
+#define SIM_u8VECT_UDRE			12U
+
+/* clock and interrupts */
+static uint64_t u64SimCycles = 0;
+static uint64_t u64SimLimit = 0;
+static uint32 u32SimIsrCount = 0;
+static uint8 u8SimVector = 0;			/* running vector number, 0 in main */
+static boolean bSimIoHalted = FALSE;	/* asleep in a mode that stops the I/O clock (not idle) */
+
+/* side effect access waiting for its resolution */
+static uint8 u8SimPendAddr = SIM_u8NO_ACCESS;
+static uint8 u8SimPendValue;
+static uint8 u8SimPendSpsr;
+static boolean bSimPendIsrRead;
+
+/* timers */
+static SIM_tstrTimer strSimT0;
+static SIM_tstrTimer strSimT2;
+
+/* UART */
+static uint8 au8SimUartTx[SIM_u16UART_TX_SIZE];
+static uint16 u16SimUartTxHead = 0;
+static uint16 u16SimUartTxTail = 0;
+static uint8 au8SimUartRx[SIM_u16UART_RX_SIZE];
+static uint16 u16SimUartRxHead = 0;
+static uint16 u16SimUartRxTail = 0;
+static uint64_t u64SimUartBusy = 0;		/* cycles left of the byte in the shift register */
+static uint8 u8SimUartShift;
+static boolean bSimUartBufFull = FALSE;
+static uint8 u8SimUartBuf;
+static boolean bSimUartEcho = FALSE;
+
+/* SPI */
+static SIM_tpfu8SpiSlave pfu8SimSpiSlave = NULL;
+static uint64_t u64SimSpiBusy = 0;
+static uint8 u8SimSpiShift;
+static boolean bSimSpiArmed = FALSE;		/* SPSR read with SPIF set, the next SPDR access clears SPIF */
+static boolean bSimSpiIsrFirst = FALSE;	/* first SPDR access of the SPI ISR is a read */
+static boolean bSimSpiMaybeWrite = FALSE;	/* unchanged SPDR access with SPIF set, read or write */
+static uint8 u8SimSpiMaybeValue;
+static uint8 u8SimSpiPolls = 0;
+
+/* ADC */
+static uint16 au16SimAdcIn[8];
+static uint64_t u64SimAdcBusy = 0;
+static boolean bSimAdcFirst = TRUE;
+
+/* streams of the firmware */
+static void SIM_vidHostPut(char cChar, SIM_FILE *pstrStream);
+static char SIM_cHostGet(SIM_FILE *pstrStream);
+static SIM_FILE strSimHostOut = FDEV_SETUP_STREAM(SIM_vidHostPut, NULL, _FDEV_SETUP_WRITE);
+static SIM_FILE strSimHostIn = FDEV_SETUP_STREAM(NULL, SIM_cHostGet, _FDEV_SETUP_READ);
+SIM_FILE *SIM_pstrStdout = &strSimHostOut;
+SIM_FILE *SIM_pstrStdin = &strSimHostIn;
+
+/*-------------------------------------Static functions Definitions ---------------------------------------*/
+
+static void SIM_vidAdvance(uint64_t u64Cycles);
+
+static void SIM_vidHostPut(char cChar, SIM_FILE *pstrStream)
+{
+	(void)pstrStream;
+	(void)fputc(cChar, stdout);
+}
+
+static char SIM_cHostGet(SIM_FILE *pstrStream)
+{
+	(void)pstrStream;
+	return (char)fgetc(stdin);
+}
+
+static void SIM_vidSetRegs(void)
+{
+	memset((void *)&SIM_unMem, 0, sizeof(SIM_unMem));
+	SIM_R(SIM_u8UCSRA) = (1U << UDRE);
+	SIM_R(SIM_u8UCSRC_ADDR) = (1U << URSEL) | (1U << UCSZ1) | (1U << UCSZ0);
+	MCUCSR = (1U << PORF);
+	SPL = (uint8)RAMEND;
+	SPH = (uint8)(RAMEND >> 8);
+}
+
+/*------------------------------------------------- Timers ------------------------------------------------*/
+
+/* source clock of a timer in Hz and its prescaler, 0 when stopped */
+static uint32 SIM_u32T0Prescaler(void)
+{
+	static const uint16 au16Div[8] = {0U, 1U, 8U, 64U, 256U, 1024U, 0U, 0U};
+
+	/* clocked from the I/O clock */
+	return (bSimIoHalted != FALSE) ? 0U : au16Div[TCCR0 & 0x07U];
+}
+
+static uint32 SIM_u32T2Prescaler(void)
+{
+	static const uint16 au16Div[8] = {0U, 1U, 8U, 32U, 64U, 128U, 256U, 1024U};
+
+	return au16Div[TCCR2 & 0x07U];
+}
+
+static uint32 SIM_u32T2SourceHz(void)
+{
+	return (ASSR & (1U << AS2)) ? SIM_u32T2_ASYNC_HZ : (uint32)F_CPU;
+}
+
+/* cycles until the timer has counted u32Counts more times */
+static uint64_t SIM_u64TimerCycles(const SIM_tstrTimer *pstrTimer, uint32 u32Div, uint32 u32SrcHz, uint32 u32Counts)
+{
+	uint64_t u64Need = ((uint64_t)u32Counts * u32Div * F_CPU) - pstrTimer->u64Acc;
+
+	return (u64Need + u32SrcHz - 1U) / u32SrcHz;
+}
+
+/* counts done by the timer during u64Cycles */
+static uint32 SIM_u32TimerCounts(SIM_tstrTimer *pstrTimer, uint32 u32Div, uint32 u32SrcHz, uint64_t u64Cycles)
+{
+	uint64_t u64Period = (uint64_t)u32Div * F_CPU;
+	uint32 u32Counts;
+
+	pstrTimer->u64Acc += u64Cycles * u32SrcHz;
+	u32Counts = (uint32)(pstrTimer->u64Acc / u64Period);
+	pstrTimer->u64Acc %= u64Period;
+	return u32Counts;
+}
+
+static boolean SIM_bT2Ctc(void)
+{
+	return ((TCCR2 & ((1U << WGM21) | (1U << WGM20))) == (1U << WGM21)) ? TRUE : FALSE;
+}
+
+/* Timer2 counts up to its next flag */
+static uint32 SIM_u32T2CountsToEvent(void)
+{
+	uint8 u8Cnt = TCNT2;
+	uint8 u8Ocr = OCR2;
+	uint32 u32Match;
+	uint32 u32Ovf = 256U - u8Cnt;
+
+	if (SIM_bT2Ctc() != FALSE){
+		if (u8Cnt < u8Ocr){
+			u32Match = (uint32)u8Ocr - u8Cnt;
+		} else if (u8Cnt == u8Ocr){
+			u32Match = (uint32)u8Ocr + 1U;
+		} else {
+			u32Match = u32Ovf;
+		}
+	} else {
+		u32Match = (uint8)(u8Ocr - u8Cnt);
+		if (u32Match == 0U){
+			u32Match = 256U;
+		}
+	}
+	return (u32Match < u32Ovf) ? u32Match : u32Ovf;
+}
+
+static void SIM_vidT2Count(uint32 u32Counts)
+{
+	boolean bCtc = SIM_bT2Ctc();
+
+	while (u32Counts != 0U){
+		if ((bCtc != FALSE) && (TCNT2 == OCR2)){
+			TCNT2 = 0U;
+		} else {
+			TCNT2++;
+			if (TCNT2 == 0U){
+				SIM_R(SIM_u8TIFR) |= (1U << TOV2);
+			}
+		}
+		if (TCNT2 == OCR2){
+			SIM_R(SIM_u8TIFR) |= (1U << OCF2);
+		}
+		u32Counts--;
+	}
+}
+
+/*-------------------------------------------------- UART -------------------------------------------------*/
+
+static uint64_t SIM_u64UartByteCycles(void)
+{
+	uint16 u16Ubrr = (uint16)(((uint16)(UBRRH & 0x0FU) << 8) | UBRRL);
+	uint8 u8Bits = 10U;
+
+	if (SIM_R(SIM_u8UCSRC_ADDR) & (1U << USBS)){
+		u8Bits++;
+	}
+	if (SIM_R(SIM_u8UCSRC_ADDR) & (1U << UPM1)){
+		u8Bits++;
+	}
+	return (uint64_t)u8Bits * ((uint64_t)u16Ubrr + 1U) * ((SIM_R(SIM_u8UCSRA) & (1U << U2X)) ? 8U : 16U);
+}
+
+static void SIM_vidUartRxUpdate(void)
+{
+	if ((UCSRB & (1U << RXEN)) && (u16SimUartRxHead != u16SimUartRxTail)){
+		SIM_R(SIM_u8UCSRA) |= (1U << RXC);
+	} else {
+		SIM_R(SIM_u8UCSRA) &= (uint8)~(1U << RXC);
+	}
+}
+
+static void SIM_vidUartWrite(uint8 u8Data)
+{
+	if ((UCSRB & (1U << TXEN)) == 0U){
+		return;
+	}
+	if (u64SimUartBusy == 0U){
+		u8SimUartShift = u8Data;
+		u64SimUartBusy = SIM_u64UartByteCycles();
+	} else if (bSimUartBufFull == FALSE){
+		u8SimUartBuf = u8Data;
+		bSimUartBufFull = TRUE;
+		SIM_R(SIM_u8UCSRA) &= (uint8)~(1U << UDRE);
+	} else {
+		/* written without waiting for UDRE, lost */
+	}
+}
+
+static void SIM_vidUartTxDone(void)
+{
+	if ((uint16)(u16SimUartTxHead - u16SimUartTxTail) < SIM_u16UART_TX_SIZE){
+		au8SimUartTx[u16SimUartTxHead & (SIM_u16UART_TX_SIZE - 1U)] = u8SimUartShift;
+		u16SimUartTxHead++;
+	}
+	if (bSimUartEcho != FALSE){
+		(void)fputc(u8SimUartShift, stdout);
+	}
+	if (bSimUartBufFull != FALSE){
+		u8SimUartShift = u8SimUartBuf;
+		bSimUartBufFull = FALSE;
+		u64SimUartBusy = SIM_u64UartByteCycles();
+		SIM_R(SIM_u8UCSRA) |= (1U << UDRE);
+	} else {
+		SIM_R(SIM_u8UCSRA) |= (1U << TXC);
+	}
+}
+
+/*-------------------------------------------------- SPI --------------------------------------------------*/
+
+static boolean SIM_bSpiMaster(void)
+{
+	return ((SPCR & ((1U << SPE) | (1U << MSTR))) == ((1U << SPE) | (1U << MSTR))) ? TRUE : FALSE;
+}
+
+static void SIM_vidSpiStart(uint8 u8Data)
+{
+	static const uint8 au8Div[4] = {4U, 16U, 64U, 128U};
+	uint8 u8Div = au8Div[SPCR & 0x03U];
+
+	if (SIM_bSpiMaster() == FALSE){
+		return;
+	}
+	if (u64SimSpiBusy != 0U){
+		SIM_R(SIM_u8SPSR) |= (1U << WCOL);
+		return;
+	}
+	if (SIM_R(SIM_u8SPSR) & (1U << SPI2X)){
+		u8Div >>= 1;
+	}
+	u8SimSpiShift = u8Data;
+	u64SimSpiBusy = 8U * (uint64_t)u8Div;
+}
+
+static void SIM_vidSpiDone(void)
+{
+	SIM_R(SIM_u8SPDR) = (pfu8SimSpiSlave != NULL) ? pfu8SimSpiSlave(u8SimSpiShift) : 0xFFU;
+	SIM_R(SIM_u8SPSR) |= (1U << SPIF);
+}
+
+/*-------------------------------------------------- ADC --------------------------------------------------*/
+
+static void SIM_vidAdcStart(void)
+{
+	static const uint8 au8Div[8] = {2U, 2U, 4U, 8U, 16U, 32U, 64U, 128U};
+
+	u64SimAdcBusy = (uint64_t)((bSimAdcFirst != FALSE) ? 25U : 13U) * au8Div[SIM_R(SIM_u8ADCSRA) & 0x07U];
+	bSimAdcFirst = FALSE;
+	SIM_R(SIM_u8ADCSRA) = (uint8)((SIM_R(SIM_u8ADCSRA) | (1U << ADSC)) & ~(1U << ADIF));
+}
+
+static void SIM_vidAdcDone(void)
+{
+	uint8 u8Ch = ADMUX & 0x0FU;
+	uint16 u16Value;
+
+	if (u8Ch < 8U){
+		u16Value = au16SimAdcIn[u8Ch];
+	} else if (u8Ch == 14U){
+		u16Value = SIM_u16ADC_VBG;
+	} else {
+		u16Value = 0U;
+	}
+	u16Value &= 0x3FFU;
+	if (ADMUX & (1U << ADLAR)){
+		u16Value <<= 6;
+	}
+	ADCW = u16Value;
+	SIM_R(SIM_u8ADCSRA) |= (1U << ADIF);
+	if (SIM_R(SIM_u8ADCSRA) & (1U << ADFR)){
+		SIM_vidAdcStart();
+		SIM_R(SIM_u8ADCSRA) |= (1U << ADIF);
+	} else {
+		SIM_R(SIM_u8ADCSRA) &= (uint8)~(1U << ADSC);
+	}
+}
+
+/*----------------------------------------------- Scheduling ----------------------------------------------*/
+
+static uint64_t SIM_u64Min(uint64_t u64A, uint64_t u64B)
+{
+	return (u64A < u64B) ? u64A : u64B;
+}
+
+/* cycles until the next peripheral event */
+static uint64_t SIM_u64NextEvent(void)
+{
+	uint64_t u64Next = SIM_u64NO_EVENT;
+	uint32 u32Div;
+
+	u32Div = SIM_u32T0Prescaler();
+	if (u32Div != 0U){
+		u64Next = SIM_u64TimerCycles(&strSimT0, u32Div, F_CPU, 256U - TCNT0);
+	}
+	u32Div = SIM_u32T2Prescaler();
+	if (u32Div != 0U){
+		u64Next = SIM_u64Min(u64Next, SIM_u64TimerCycles(&strSimT2, u32Div, SIM_u32T2SourceHz(), SIM_u32T2CountsToEvent()));
+	}
+	if (u64SimUartBusy != 0U){
+		u64Next = SIM_u64Min(u64Next, u64SimUartBusy);
+	}
+	if (u64SimSpiBusy != 0U){
+		u64Next = SIM_u64Min(u64Next, u64SimSpiBusy);
+	}
+	if (u64SimAdcBusy != 0U){
+		u64Next = SIM_u64Min(u64Next, u64SimAdcBusy);
+	}
+	return u64Next;
+}
+
+/* run the peripherals for u64Cycles, no event happens before the last cycle */
+static void SIM_vidTick(uint64_t u64Cycles)
+{
+	uint32 u32Div;
+	uint32 u32Counts;
+
+	u32Div = SIM_u32T0Prescaler();
+	if (u32Div != 0U){
+		u32Counts = SIM_u32TimerCounts(&strSimT0, u32Div, F_CPU, u64Cycles);
+		if (((uint32)TCNT0 + u32Counts) > 0xFFU){
+			SIM_R(SIM_u8TIFR) |= (1U << TOV0);
+		}
+		TCNT0 = (uint8)(TCNT0 + u32Counts);
+	}
+	u32Div = SIM_u32T2Prescaler();
+	if (u32Div != 0U){
+		SIM_vidT2Count(SIM_u32TimerCounts(&strSimT2, u32Div, SIM_u32T2SourceHz(), u64Cycles));
+	}
+	if (u64SimUartBusy != 0U){
+		u64SimUartBusy -= u64Cycles;
+		if (u64SimUartBusy == 0U){
+			SIM_vidUartTxDone();
+		}
+	}
+	if (u64SimSpiBusy != 0U){
+		u64SimSpiBusy -= u64Cycles;
+		if (u64SimSpiBusy == 0U){
+			SIM_vidSpiDone();
+		}
+	}
+	if (u64SimAdcBusy != 0U){
+		u64SimAdcBusy -= u64Cycles;
+		if (u64SimAdcBusy == 0U){
+			SIM_vidAdcDone();
+		}
+	}
+}
+
+/* decide what the last side effect access was, u8NextAddr is the access that follows it */
+static void SIM_vidResolve(uint8 u8NextAddr)
+{
+	uint8 u8Addr = u8SimPendAddr;
+	uint8 u8Old = u8SimPendValue;
+	uint8 u8New;
+	boolean bWrite;
+
+	if (u8Addr == SIM_u8NO_ACCESS){
+		return;
+	}
+	u8SimPendAddr = SIM_u8NO_ACCESS;
+	u8New = SIM_R(u8Addr);
+	bWrite = (u8New != u8Old) ? TRUE : FALSE;
+
+	switch (u8Addr){
+	case SIM_u8UDR:
+		if ((bWrite == FALSE) && (u8SimVector != SIM_u8VECT_UDRE) &&
+			((u8SimVector == SIM_u8VECT_RXC) || (SIM_R(SIM_u8UCSRA) & (1U << RXC)))){
+			if (u16SimUartRxHead != u16SimUartRxTail){
+				u16SimUartRxTail++;
+			}
+			SIM_vidUartRxUpdate();
+		} else {
+			SIM_vidUartWrite(u8New);
+		}
+		break;
+	case SIM_u8SPDR:
+		if (SIM_bSpiMaster() == FALSE){
+			/* slave: the written byte is the next one shifted out, nothing to do */
+		} else if (bWrite != FALSE){
+			SIM_vidSpiStart(u8New);
+		} else if ((bSimPendIsrRead != FALSE) || (u8NextAddr == SIM_u8SPDR)){
+			/* read */
+		} else if (u8SimPendSpsr & (1U << SPIF)){
+			/* SPDR read to clear SPIF, or the same byte written: a poll of SPSR tells */
+			bSimSpiMaybeWrite = TRUE;
+			u8SimSpiMaybeValue = u8New;
+			u8SimSpiPolls = 0U;
+		} else {
+			SIM_vidSpiStart(u8New);
+		}
+		break;
+	case SIM_u8SPSR:
+		if (bWrite != FALSE){
+			SIM_R(u8Addr) = (uint8)((u8Old & 0xC0U) | (u8New & (1U << SPI2X)));
+		}
+		break;
+	case SIM_u8UCSRA:
+		if (bWrite != FALSE){
+			/* U2X and MPCM are written, TXC is cleared by a one */
+			SIM_R(u8Addr) = (uint8)(((u8Old & 0xFCU) & ~(u8New & (1U << TXC))) | (u8New & 0x03U));
+		}
+		break;
+	case SIM_u8ADCSRA:
+		if (bWrite != FALSE){
+			u8New = (uint8)((u8New & ~(1U << ADIF)) | (u8Old & ~u8New & (1U << ADIF)));
+			if ((u8New & (1U << ADEN)) == 0U){
+				u64SimAdcBusy = 0U;
+				bSimAdcFirst = TRUE;
+				u8New &= (uint8)~(1U << ADSC);
+			} else if (u64SimAdcBusy != 0U){
+				u8New |= (1U << ADSC);
+			} else {
+				/* idle */
+			}
+			SIM_R(u8Addr) = u8New;
+			if ((u8New & (1U << ADSC)) && (u64SimAdcBusy == 0U)){
+				SIM_vidAdcStart();
+			}
+		}
+		break;
+	case SIM_u8TIFR:
+		if (bWrite != FALSE){
+			/* flags are cleared by writing a one */
+			SIM_R(u8Addr) = (uint8)(u8Old & ~u8New);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/* run the ISRs that are pending and enabled */
+static void SIM_vidDispatch(void)
+{
+	const SIM_tstrVector *pstrVect;
+	uint8 u8Prev;
+	uint8 u8Idx;
+
+	while (SREG & (1U << SREG_I)){
+		for (u8Idx = 0U; u8Idx < SIM_u8NO_OF_VECTORS; u8Idx++){
+			pstrVect = &astrSimVectors[u8Idx];
+			if ((pstrVect->u8FlagAddr != 0U) && (SIM_R(pstrVect->u8FlagAddr) & (1U << pstrVect->u8FlagBit)) &&
+				(SIM_R(pstrVect->u8EnableAddr) & (1U << pstrVect->u8EnableBit))){
+				break;
+			}
+		}
+		if (u8Idx == SIM_u8NO_OF_VECTORS){
+			break;
+		}
+		if (pstrVect->bAutoClear != FALSE){
+			SIM_R(pstrVect->u8FlagAddr) &= (uint8)~(1U << pstrVect->u8FlagBit);
+		}
+		SREG &= (uint8)~(1U << SREG_I);
+		u8Prev = u8SimVector;
+		u8SimVector = (uint8)(u8Idx + 1U);
+		bSimSpiIsrFirst = (u8SimVector == SIM_u8VECT_SPI) ? TRUE : FALSE;
+		u32SimIsrCount++;
+		pstrVect->pfvIsr();
+		SIM_vidResolve(SIM_u8NO_ACCESS);
+		u8SimVector = u8Prev;
+		bSimSpiIsrFirst = FALSE;
+		/* reti */
+		SREG |= (1U << SREG_I);
+	}
+}
+
+static void SIM_vidAdvance(uint64_t u64Cycles)
+{
+	uint64_t u64Step;
+
+	SIM_vidDispatch();
+	while (u64Cycles != 0U){
+		u64Step = SIM_u64Min(u64Cycles, SIM_u64NextEvent());
+		SIM_vidTick(u64Step);
+		u64SimCycles += u64Step;
+		u64Cycles -= u64Step;
+		SIM_vidDispatch();
+		if ((u64SimLimit != 0U) && (u64SimCycles >= u64SimLimit)){
+			(void)fflush(stdout);
+			(void)fprintf(stderr, "\n[sim] run limit reached after %llu cycles, %lu ISRs\n",
+						  (unsigned long long)u64SimCycles, (unsigned long)u32SimIsrCount);
+			exit(0);
+		}
+	}
+}
+
+__attribute__((constructor)) static void SIM_vidHostInit(void)
+{
+	const char *pcEnv;
+
+	SIM_vidSetRegs();
+	pcEnv = getenv("SIM_RUN_MS");
+	if (pcEnv != NULL){
+		SIM_vidSetRunLimitMs((uint32)strtoul(pcEnv, NULL, 10));
+	}
+	pcEnv = getenv("SIM_UART_ECHO");
+	bSimUartEcho = ((pcEnv != NULL) && (pcEnv[0] == '1')) ? TRUE : FALSE;
+}
+
+/*-------------------------------------------- FUNCTION Definitions ---------------------------------------*/
+
+extern volatile uint8_t *SIM_pu8Access(uint8_t u8Addr)
+{
+	SIM_vidResolve(u8Addr);
+	if (u8Addr == SIM_u8SPSR){
+		if ((bSimSpiMaybeWrite != FALSE) && ((SIM_R(SIM_u8SPSR) & (1U << SPIF)) == 0U) && (u64SimSpiBusy == 0U)){
+			/* polled twice with nothing on the bus: the unchanged SPDR access was a write */
+			if (++u8SimSpiPolls >= 2U){
+				bSimSpiMaybeWrite = FALSE;
+				SIM_vidSpiStart(u8SimSpiMaybeValue);
+			}
+		} else {
+			bSimSpiMaybeWrite = FALSE;
+		}
+	} else {
+		bSimSpiMaybeWrite = FALSE;
+	}
+	SIM_vidAdvance(SIM_u8ACCESS_CYCLES);
+
+	switch (u8Addr){
+	case SIM_u8SPSR:
+		bSimSpiArmed = (SIM_R(SIM_u8SPSR) & (1U << SPIF)) ? TRUE : FALSE;
+		break;
+	case SIM_u8SPDR:
+		u8SimPendSpsr = SIM_R(SIM_u8SPSR);
+		bSimPendIsrRead = bSimSpiIsrFirst;
+		bSimSpiIsrFirst = FALSE;
+		if ((bSimSpiArmed != FALSE) && (SIM_R(SIM_u8SPSR) & (1U << SPIF))){
+			SIM_R(SIM_u8SPSR) &= (uint8)~((1U << SPIF) | (1U << WCOL));
+		}
+		bSimSpiArmed = FALSE;
+		break;
+	case SIM_u8UDR:
+		if (SIM_R(SIM_u8UCSRA) & (1U << RXC)){
+			SIM_R(SIM_u8UDR) = au8SimUartRx[u16SimUartRxTail & (SIM_u16UART_RX_SIZE - 1U)];
+		}
+		break;
+	default:
+		break;
+	}
+	u8SimPendAddr = u8Addr;
+	u8SimPendValue = SIM_R(u8Addr);
+	return &SIM_R(u8Addr);
+}
+
+extern void SIM_vidSei(void)
+{
+	/* the pending ISRs run after the next instruction (register access, delay or sleep) */
+	SREG |= (1U << SREG_I);
+}
+
+extern void SIM_vidCli(void)
+{
+	/* one cycle, so a main loop waiting on RAM around a critical section lets the ISRs run */
+	SIM_vidResolve(SIM_u8NO_ACCESS);
+	SIM_vidAdvance(1U);
+	SREG &= (uint8)~(1U << SREG_I);
+}
+
+extern void SIM_vidIdleHook(void)
+{
+	SIM_vidResolve(SIM_u8NO_ACCESS);
+	if (SREG & (1U << SREG_I)){
+		/* the chip runs the ISRs meanwhile: go to the next peripheral event, bounded as the loop may wait
+		   for a byte injected by the test */
+		SIM_vidAdvance(SIM_u64Min(SIM_u16IDLE_CYCLES, SIM_u64NextEvent() + 1U));
+	} else {
+		SIM_vidAdvance(SIM_u8ACCESS_CYCLES);
+	}
+}
+
+extern void SIM_vidSleepCpu(void)
+{
+	uint32 u32Isrs = u32SimIsrCount;
+	uint64_t u64Next;
+
+	SIM_vidResolve(SIM_u8NO_ACCESS);
+	if ((MCUCR & (1U << SE)) == 0U){
+		return;
+	}
+	if (((MCUCR & SIM_u8SLEEP_MASK) == (1U << SM0)) && (SIM_R(SIM_u8ADCSRA) & (1U << ADEN)) && (u64SimAdcBusy == 0U)){
+		SIM_vidAdcStart();
+	}
+	SIM_vidDispatch();
+	bSimIoHalted = ((MCUCR & SIM_u8SLEEP_MASK) != 0U) ? TRUE : FALSE;
+	while (u32SimIsrCount == u32Isrs){
+		u64Next = SIM_u64NextEvent();
+		if ((u64Next == SIM_u64NO_EVENT) || ((SREG & (1U << SREG_I)) == 0U)){
+			/* nothing can wake the CPU up */
+			(void)fprintf(stderr, "[sim] sleep without wake up source at cycle %llu\n", (unsigned long long)u64SimCycles);
+			break;
+		}
+		SIM_vidAdvance(u64Next);
+	}
+	bSimIoHalted = FALSE;
+}
+
+extern void SIM_vidReset(void)
+{
+	u8SimPendAddr = SIM_u8NO_ACCESS;
+	SIM_vidSetRegs();
+	u64SimCycles = 0U;
+	u32SimIsrCount = 0U;
+	u8SimVector = 0U;
+	bSimIoHalted = FALSE;
+	memset(&strSimT0, 0, sizeof(strSimT0));
+	memset(&strSimT2, 0, sizeof(strSimT2));
+	u16SimUartTxHead = u16SimUartTxTail = 0U;
+	u16SimUartRxHead = u16SimUartRxTail = 0U;
+	u64SimUartBusy = 0U;
+	bSimUartBufFull = FALSE;
+	u64SimSpiBusy = 0U;
+	bSimSpiArmed = FALSE;
+	bSimSpiIsrFirst = FALSE;
+	bSimSpiMaybeWrite = FALSE;
+	u64SimAdcBusy = 0U;
+	bSimAdcFirst = TRUE;
+	SIM_pstrStdout = &strSimHostOut;
+	SIM_pstrStdin = &strSimHostIn;
+}
+
+extern void SIM_vidRunCycles(uint64_t u64Cycles)
+{
+	SIM_vidResolve(SIM_u8NO_ACCESS);
+	SIM_vidAdvance(u64Cycles);
+}
+
+extern void SIM_vidDelayUs(uint32_t u32Us)
+{
+	SIM_vidRunCycles(((uint64_t)u32Us * F_CPU) / 1000000UL);
+}
+
+extern uint64_t SIM_u64GetCycles(void)
+{
+	return u64SimCycles;
+}
+
+extern uint32 SIM_u32GetIsrCount(void)
+{
+	return u32SimIsrCount;
+}
+
+extern void SIM_vidSetRunLimitMs(uint32 u32Ms)
+{
+	u64SimLimit = ((uint64_t)u32Ms * F_CPU) / 1000U;
+}
+
+extern void SIM_vidUartRxPush(const uint8 *pu8Data, uint16 u16Len)
+{
+	SIM_vidResolve(SIM_u8NO_ACCESS);
+	while ((u16Len != 0U) && ((uint16)(u16SimUartRxHead - u16SimUartRxTail) < SIM_u16UART_RX_SIZE)){
+		au8SimUartRx[u16SimUartRxHead & (SIM_u16UART_RX_SIZE - 1U)] = *pu8Data++;
+		u16SimUartRxHead++;
+		u16Len--;
+	}
+	SIM_vidUartRxUpdate();
+}
+
+extern uint16 SIM_u16UartTxRead(uint8 *pu8Data, uint16 u16Max)
+{
+	uint16 u16Len = 0U;
+
+	SIM_vidResolve(SIM_u8NO_ACCESS);
+	while ((u16Len < u16Max) && (u16SimUartTxTail != u16SimUartTxHead)){
+		pu8Data[u16Len++] = au8SimUartTx[u16SimUartTxTail & (SIM_u16UART_TX_SIZE - 1U)];
+		u16SimUartTxTail++;
+	}
+	return u16Len;
+}
+
+extern void SIM_vidUartEcho(boolean bEcho)
+{
+	bSimUartEcho = bEcho;
+}
+
+extern void SIM_vidSpiAttachSlave(SIM_tpfu8SpiSlave pfu8Slave)
+{
+	pfu8SimSpiSlave = pfu8Slave;
+}
+
+extern uint8 SIM_u8SpiMasterXfer(uint8 u8Mosi)
+{
+	uint8 u8Miso;
+
+	SIM_vidResolve(SIM_u8NO_ACCESS);
+	u8Miso = SIM_R(SIM_u8SPDR);
+	if ((SPCR & ((1U << SPE) | (1U << MSTR))) == (1U << SPE)){
+		SIM_R(SIM_u8SPDR) = u8Mosi;
+		SIM_R(SIM_u8SPSR) |= (1U << SPIF);
+		SIM_vidDispatch();
+	}
+	return u8Miso;
+}
+
+extern void SIM_vidAdcSetInput(uint8 u8Channel, uint16 u16Value)
+{
+	if (u8Channel < 8U){
+		au16SimAdcIn[u8Channel] = u16Value;
+	}
+}
+
+/*---------------------------------------- firmware stdio streams -----------------------------------------*/
+
+extern int SIM_vfprintf(SIM_FILE *pstrStream, const char *pcFormat, va_list ap)
+{
+	char acText[256];
+	char *pcText = acText;
+	va_list apCopy;
+	int iLen;
+	int iIdx;
+
+	if ((pstrStream == NULL) || (pstrStream->pfvPut == NULL)){
+		return -1;
+	}
+	va_copy(apCopy, ap);
+	iLen = vsnprintf(acText, sizeof(acText), pcFormat, ap);
+	if (iLen >= (int)sizeof(acText)){
+		pcText = malloc((size_t)iLen + 1U);
+		if (pcText != NULL){
+			(void)vsnprintf(pcText, (size_t)iLen + 1U, pcFormat, apCopy);
+		}
+	}
+	va_end(apCopy);
+	if (pcText == NULL){
+		return -1;
+	}
+	for (iIdx = 0; iIdx < iLen; iIdx++){
+		pstrStream->pfvPut(pcText[iIdx], pstrStream);
+	}
+	if (pcText != acText){
+		free(pcText);
+	}
+	return iLen;
+}
+
+extern int SIM_printf(const char *pcFormat, ...)
+{
+	va_list ap;
+	int iLen;
+
+	va_start(ap, pcFormat);
+	iLen = SIM_vfprintf(SIM_pstrStdout, pcFormat, ap);
+	va_end(ap);
+	return iLen;
+}
+
+extern int SIM_putchar(int iChar)
+{
+	if ((SIM_pstrStdout == NULL) || (SIM_pstrStdout->pfvPut == NULL)){
+		return EOF;
+	}
+	SIM_pstrStdout->pfvPut((char)iChar, SIM_pstrStdout);
+	return iChar;
+}
+
+extern int SIM_puts(const char *pcText)
+{
+	while (*pcText != '\0'){
+		(void)SIM_putchar(*pcText++);
+	}
+	return SIM_putchar('\n');
+}
+
+extern int SIM_getchar(void)
+{
+	if ((SIM_pstrStdin == NULL) || (SIM_pstrStdin->pfcGet == NULL)){
+		return EOF;
+	}
+	return (uint8)SIM_pstrStdin->pfcGet(SIM_pstrStdin);
+}
@@ -0,0 +1,198 @@
+/*! \file SIM_avr.h \brief ATmega8 peripheral simulator for the host build. */
+/************************************************************************************************************
+*
+* File Name		: 'SIM_avr.h'
+* Title			: ATmega8 peripheral simulator for the host build
+* Target		: Linux host (gcc / clang)
+*
+* The AfrSys sources are compiled unchanged against the headers of tools/host_sim/include. Registers are
+* bytes of a simulated register file; UDR, UCSRA, SPDR, SPSR, ADCSRA and TIFR go through SIM_pu8Access
+* which advances a cycle counter (SIM_u8ACCESS_CYCLES per access), runs the peripheral models and calls the
+* ISRs whose flag, enable bit and SREG I are set.
+*
+* Models:
+*	Timer0		: normal mode, all internal prescalers, TOV0
+*	Timer2		: normal and CTC modes, internal or asynchronous 32768 Hz clock (AS2), OCF2 / TOV2
+*	UART		: TX shift register + UDR buffer timed from UBRR/U2X, bytes captured for the test; RX bytes
+*				  injected by the test, RXC set while any is waiting
+*	SPI			: master transfers timed from SPR/SPI2X, MISO from a test call back; in slave mode the test
+*				  clocks the bytes with SIM_u8SpiMasterXfer
+*	ADC			: single and free running conversions timed from ADPS, inputs set by the test, ADLAR,
+*				  noise reduction sleep starts a conversion
+*	sleep		: advances the clock to the next interrupt, the modes other than idle stop Timer0 (I/O clock)
+*				  until the wake up, the other peripherals keep running
+* Timer1, the watchdog, EEPROM, TWI and the external interrupts are registers only; their ISRs run when the
+* test sets the flag (e.g. TIFR |= (1<<TOV1)) and the enable bit.
+*
+* The clock moves on register accesses, cli(), delays and sleep only, the simulated time never depends on the
+* host CPU. A firmware loop that waits on RAM written by an ISR (a ring index, a flag) calls MCU_IDLE_HOOK()
+* in its body: SIM_vidIdleHook advances the clock up to the next peripheral event (SIM_u16IDLE_CYCLES at
+* most) so the ISRs run as they would on the chip meanwhile.
+*
+* A C access to a register cannot tell a read from a write, so a side effect access is resolved at the next
+* one: a changed value is a write, an unchanged one is a read except where the hardware state leaves only
+* one choice (UDR in the UDRE ISR or with RXC clear is a write; SPDR with SPIF clear and not read in the SPI
+* ISR is a write). Two known limits: a write of the value just read from UDR while RXC is set is taken as a
+* read, and ADIF is also cleared when a conversion starts (the drivers always clear it before).
+*
+* Environment of the host programs:
+*	SIM_RUN_MS=<ms>		exit(0) after that much simulated time (firmware main never returns)
+*	SIM_UART_ECHO=1		copy the transmitted UART bytes to the host stdout
+*
+************************************************************************************************************/
+
+#ifndef SIM_AVR_H_
+#define SIM_AVR_H_
+
+#include <stdint.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "Std_Types.h"
+
+/*----------------------------------------- MACROS Definitions --------------------------------------------*/
+
+#ifndef F_CPU
+#define F_CPU					1000000UL
+#endif
+
+/* clock advance of one side effect register access (polling loops) */
+#define SIM_u8ACCESS_CYCLES		2U
+
+/* captured UART TX bytes and pending RX bytes, power of 2 */
+#define SIM_u16UART_TX_SIZE		1024U
+#define SIM_u16UART_RX_SIZE		256U
+
+/* ADC result of the 1.30 V band gap (MUX 14) with a 5 V reference */
+#define SIM_u16ADC_VBG			266U
+
+/*------------------------------------------ Type Definitions  --------------------------------------------*/
+
+/* SPI slave attached to the master: returns the MISO byte clocked with u8Mosi */
+typedef uint8 (*SIM_tpfu8SpiSlave)(uint8 u8Mosi);
+
+/*---------------------------------------- FUNCTION Definitions -------------------------------------------*/
+
+/************************************************************************************************************
+* Function				: SIM_vidReset
+* Description			: Power on reset: registers to their reset values, peripherals idle, clock 0. The call
+						  backs, ADC inputs and UART echo set by the test are kept.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void SIM_vidReset(void);
+
+/************************************************************************************************************
+* Function				: SIM_vidRunCycles
+* Description			: Advance the clock, the peripherals and the ISRs by a number of CPU cycles.
+* Parameters[in]		: [u64Cycles] CPU cycles
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void SIM_vidRunCycles(uint64_t u64Cycles);
+
+/************************************************************************************************************
+* Function				: SIM_vidDelayUs
+* Description			: Advance the clock by a duration (_delay_us / _delay_ms of the firmware).
+* Parameters[in]		: [u32Us] micro seconds
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void SIM_vidDelayUs(uint32_t u32Us);
+
+/************************************************************************************************************
+* Function				: SIM_u64GetCycles
+* Description			: CPU cycles simulated since the reset.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint64_t cycles
+*
+*************************************************************************************************************/
+extern uint64_t SIM_u64GetCycles(void);
+
+/************************************************************************************************************
+* Function				: SIM_u32GetIsrCount
+* Description			: Number of ISRs run since the reset.
+* Parameters[in]		: None
+* Parameters[in/out]	: None
+* Parameters[out]		: uint32 ISR calls
+*
+*************************************************************************************************************/
+extern uint32 SIM_u32GetIsrCount(void);
+
+/************************************************************************************************************
+* Function				: SIM_vidSetRunLimitMs
+* Description			: exit(0) once the simulated time reaches a limit, 0 removes it.
+* Parameters[in]		: [u32Ms] limit in ms of simulated time
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void SIM_vidSetRunLimitMs(uint32 u32Ms);
+
+/************************************************************************************************************
+* Function				: SIM_vidUartRxPush
+* Description			: Queue bytes on the UART RX line, RXC stays set until the firmware read them all.
+* Parameters[in]		: [pu8Data] bytes
+						  [u16Len] number of bytes, the ones that do not fit are dropped
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void SIM_vidUartRxPush(const uint8 *pu8Data, uint16 u16Len);
+
+/************************************************************************************************************
+* Function				: SIM_u16UartTxRead
+* Description			: Take the bytes transmitted by the UART since the last call.
+* Parameters[in]		: [u16Max] size of the buffer
+* Parameters[in/out]	: [pu8Data] bytes, oldest first
+* Parameters[out]		: uint16 number of bytes
+*
+*************************************************************************************************************/
+extern uint16 SIM_u16UartTxRead(uint8 *pu8Data, uint16 u16Max);
+
+/************************************************************************************************************
+* Function				: SIM_vidUartEcho
+* Description			: Copy the transmitted UART bytes to the host stdout (they are captured as well).
+* Parameters[in]		: [bEcho] TRUE / FALSE
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void SIM_vidUartEcho(boolean bEcho);
+
+/************************************************************************************************************
+* Function				: SIM_vidSpiAttachSlave
+* Description			: Device seen by the SPI master, NULL reads 0xFF (MISO pulled up).
+* Parameters[in]		: [pfu8Slave] call back run at the end of every master transfer
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void SIM_vidSpiAttachSlave(SIM_tpfu8SpiSlave pfu8Slave);
+
+/************************************************************************************************************
+* Function				: SIM_u8SpiMasterXfer
+* Description			: Clock one byte into the SPI in slave mode, the SPI ISR runs if enabled.
+* Parameters[in]		: [u8Mosi] byte sent by the master
+* Parameters[in/out]	: None
+* Parameters[out]		: uint8 byte shifted out by the firmware (MISO)
+*
+*************************************************************************************************************/
+extern uint8 SIM_u8SpiMasterXfer(uint8 u8Mosi);
+
+/************************************************************************************************************
+* Function				: SIM_vidAdcSetInput
+* Description			: Set the value converted on an ADC channel.
+* Parameters[in]		: [u8Channel] 0 .. 7
+						  [u16Value] 0 .. 1023
+* Parameters[in/out]	: None
+* Parameters[out]		: None
+*
+*************************************************************************************************************/
+extern void SIM_vidAdcSetInput(uint8 u8Channel, uint16 u16Value);
+
+#endif /* SIM_AVR_H_ */
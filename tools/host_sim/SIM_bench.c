@@ -0,0 +1,194 @@
+/*! \file SIM_bench.c \brief Host micro-benchmarks of the AfrSys drivers. */
+/************************************************************************************************************
+*
+* File Name		: 'SIM_bench.c'
+* Title			: Host micro-benchmarks of the AfrSys drivers
+* Target		: Linux host (gcc / clang)
+*
+* Runs the driver hot paths against the simulated register file and prints the host time per call. The
+* numbers only compare versions of the same code on the same machine, they are not AVR cycle counts. The
+* accesses to UDR, SPDR, ... run the peripheral models and cost more than a
+* plain register, which is why the UART cases drain the ring in the measured loop.
+*
+* Usage : SIM_bench [iterations]		(default 100000)
+*
+************************************************************************************************************/
+
+/*------------------------------------------------- INCLUDES ----------------------------------------------*/
+
+#define SIM_REAL_STDIO
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "SIM_avr.h"
+#include "DIO.h"
+#include "SCI_uart.h"
+#include "LOG_uartLogger.h"
+#include "SMP_adcSampler.h"
+#include "WAV_waveGen.h"
+#include "OS/SCH_scheduler.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+#define BENCH_u32DEFAULT_ITER	100000UL
+#define BENCH_u16UART_DRAIN		(16U * 1000U)	/* cycles of 16 bytes at the logger baud rate, ring kept busy */
+
+/*------------------------------------------ Type Definitions  --------------------------------------------*/
+
+typedef void (*BENCH_tpfvCase)(uint32 u32Index);
+
+/*---------------------------------------------- Global Variables -----------------------------------------*/
+
+static volatile uint16 u16BenchSink;
+static uint8 au8BenchDrain[SIM_u16UART_TX_SIZE];
+
+/*-------------------------------------Static functions Definitions ---------------------------------------*/
+
+static uint64_t BENCH_u64NowNs(void)
+{
+	struct timespec strNow;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &strNow);
+	return ((uint64_t)strNow.tv_sec * 1000000000ULL) + (uint64_t)strNow.tv_nsec;
+}
+
+/* run u32Iter calls of the case, print the time per call */
+static void BENCH_vidRun(const char *pcName, BENCH_tpfvCase pfvCase, uint32 u32Iter)
+{
+	uint64_t u64Start;
+	uint64_t u64Ns;
+	uint32 u32Index;
+
+	/* warm up the caches and the branch predictors */
+	for (u32Index = 0; u32Index < (u32Iter / 10U); u32Index++){
+		pfvCase(u32Index);
+	}
+	u64Start = BENCH_u64NowNs();
+	for (u32Index = 0; u32Index < u32Iter; u32Index++){
+		pfvCase(u32Index);
+	}
+	u64Ns = BENCH_u64NowNs() - u64Start;
+	printf("%-28s %10.1f ns/op\n", pcName, (double)u64Ns / (double)u32Iter);
+}
+
+/* let the UDRE ISR empty the TX ring, drop the bytes caught by the simulator */
+static void BENCH_vidUartDrain(void)
+{
+	while (UART_u8GetTxFree() < (u8TX_BUFFER_SIZE - 1U)){
+		SIM_vidRunCycles(BENCH_u16UART_DRAIN);
+		(void)SIM_u16UartTxRead(au8BenchDrain, SIM_u16UART_TX_SIZE);
+	}
+	(void)SIM_u16UartTxRead(au8BenchDrain, SIM_u16UART_TX_SIZE);
+}
+
+static void BENCH_vidDioWrite(uint32 u32Index)
+{
+	DIO_vidDigitalPinWrite(DIO_PB1, (uint8)(u32Index & 1U));
+}
+
+static void BENCH_vidDioWriteFast(uint32 u32Index)
+{
+	DIO_vidPinWriteFast(DIO_PB1, (uint8)(u32Index & 1U));
+}
+
+static void BENCH_vidDioRead(uint32 u32Index)
+{
+	(void)u32Index;
+	u16BenchSink = DIO_u8DigitalRead(DIO_PD2);
+}
+
+static void BENCH_vidFilterMovAvg(uint32 u32Index)
+{
+	u16BenchSink = SMP_u16FilterMovAvg((uint16)(u32Index & 0x3FFU));
+}
+
+static void BENCH_vidFilterIir(uint32 u32Index)
+{
+	u16BenchSink = SMP_u16FilterIir((uint16)(u32Index & 0x3FFU));
+}
+
+static void BENCH_vidFilterMedian3(uint32 u32Index)
+{
+	u16BenchSink = SMP_u16FilterMedian3((uint16)((u32Index * 37U) & 0x3FFU));
+}
+
+static void BENCH_vidWavStep(uint32 u32Index)
+{
+	(void)u32Index;
+	WAV_vidStep();
+}
+
+static void BENCH_vidTaskNop(void)
+{
+	u16BenchSink++;
+}
+
+static void BENCH_vidSchTick(uint32 u32Index)
+{
+	(void)u32Index;
+	SCH_vidTimIsr();
+	SCH_vidDispatch();
+}
+
+/* 16 bytes through the TX ring, drained every 48 bytes */
+static void BENCH_vidUartWrite(uint32 u32Index)
+{
+	static const uint8 au8Block[16] = "0123456789ABCDEF";
+
+	(void)UART_u8Write(au8Block, (uint8)sizeof(au8Block));
+	if ((u32Index % 3U) == 2U){
+		BENCH_vidUartDrain();
+	}
+}
+
+static void BENCH_vidLogInfo(uint32 u32Index)
+{
+	INFO("bench %u", (unsigned int)u32Index);
+	BENCH_vidUartDrain();
+}
+
+/*------------------------------------------------- MAIN --------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+	uint32 u32Iter = BENCH_u32DEFAULT_ITER;
+	uint8 u8Task;
+
+	if (argc > 1){
+		u32Iter = (uint32)strtoul(argv[1], NULL, 0);
+		if (u32Iter == 0U){
+			u32Iter = BENCH_u32DEFAULT_ITER;
+		}
+	}
+
+	SIM_vidReset();
+	printf("AfrSys host benchmarks, %lu iterations\n", (unsigned long)u32Iter);
+
+	DIO_vidSetPinMode(DIO_PB1, OUTPUT);
+	BENCH_vidRun("DIO_vidDigitalPinWrite", BENCH_vidDioWrite, u32Iter);
+	BENCH_vidRun("DIO_vidPinWriteFast", BENCH_vidDioWriteFast, u32Iter);
+	BENCH_vidRun("DIO_u8DigitalRead", BENCH_vidDioRead, u32Iter);
+
+	SMP_vidFilterReset();
+	BENCH_vidRun("SMP_u16FilterMovAvg", BENCH_vidFilterMovAvg, u32Iter);
+	BENCH_vidRun("SMP_u16FilterIir", BENCH_vidFilterIir, u32Iter);
+	BENCH_vidRun("SMP_u16FilterMedian3", BENCH_vidFilterMedian3, u32Iter);
+
+	(void)WAV_eSetTables(WAV_au8Sine, WAV_au8Sine, WAV_u8PHASE_90_DEG);
+	(void)WAV_eSetFrequency(50000UL);
+	BENCH_vidRun("WAV_vidStep", BENCH_vidWavStep, u32Iter);
+
+	/* every free slot released on each tick */
+	SCH_vidSchInit();
+	for (u8Task = 1U; u8Task < SCH_u8MAX_TASKS; u8Task++){
+		(void)SCH_u8AddTask(BENCH_vidTaskNop, 1U, 0U);
+	}
+	BENCH_vidRun("SCH tick + dispatch", BENCH_vidSchTick, u32Iter);
+
+	LOG_vidInit();
+	sei();
+	BENCH_vidRun("UART_u8Write 16 bytes", BENCH_vidUartWrite, u32Iter);
+	BENCH_vidRun("INFO + UART drain", BENCH_vidLogInfo, u32Iter / 10U);
+
+	return 0;
+}
@@ -0,0 +1,58 @@
+/*! \file interrupt.h \brief Interrupt handling of the host simulator. */
+/************************************************************************************************************
+*
+* File Name		: 'avr/interrupt.h'
+* Title			: Interrupt handling of the host simulator
+* Target		: Linux host (gcc / clang)
+*
+* ISR(vector) defines SIM_ISR_<vector>, the simulator calls it when the flag and the enable bit of the
+* vector are set and SREG I is set, see SIM_avr.h. sei() takes effect after the next instruction like on the
+* chip: the pending interrupts run at the next register access, delay or sleep.
+*
+************************************************************************************************************/
+
+#ifndef SIM_AVR_INTERRUPT_H_
+#define SIM_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+/*----------------------------------------- MACROS Definitions --------------------------------------------*/
+
+#define ISR(VECTOR, ...)		void SIM_ISR_##VECTOR(void)
+#define EMPTY_INTERRUPT(VECTOR)	void SIM_ISR_##VECTOR(void) {}
+#define ISR_BLOCK
+#define ISR_NOBLOCK
+#define ISR_NAKED
+#define reti()					return
+
+#define sei()					SIM_vidSei()
+#define cli()					SIM_vidCli()
+
+/*---------------------------------------- FUNCTION Definitions -------------------------------------------*/
+
+extern void SIM_vidSei(void);
+extern void SIM_vidCli(void);
+/* body of a firmware loop waiting on RAM written by an ISR (MCU_IDLE_HOOK), advances the clock */
+extern void SIM_vidIdleHook(void);
+
+/* vectors of the ATmega8, in priority order */
+extern void SIM_ISR_INT0_vect(void);
+extern void SIM_ISR_INT1_vect(void);
+extern void SIM_ISR_TIMER2_COMP_vect(void);
+extern void SIM_ISR_TIMER2_OVF_vect(void);
+extern void SIM_ISR_TIMER1_CAPT_vect(void);
+extern void SIM_ISR_TIMER1_COMPA_vect(void);
+extern void SIM_ISR_TIMER1_COMPB_vect(void);
+extern void SIM_ISR_TIMER1_OVF_vect(void);
+extern void SIM_ISR_TIMER0_OVF_vect(void);
+extern void SIM_ISR_SPI_STC_vect(void);
+extern void SIM_ISR_USART_RXC_vect(void);
+extern void SIM_ISR_USART_UDRE_vect(void);
+extern void SIM_ISR_USART_TXC_vect(void);
+extern void SIM_ISR_ADC_vect(void);
+extern void SIM_ISR_EE_RDY_vect(void);
+extern void SIM_ISR_ANA_COMP_vect(void);
+extern void SIM_ISR_TWI_vect(void);
+extern void SIM_ISR_SPM_RDY_vect(void);
+
+#endif /* SIM_AVR_INTERRUPT_H_ */
@@ -0,0 +1,364 @@
+/*! \file io.h \brief ATmega8 register file of the host simulator. */
+/************************************************************************************************************
+*
+* File Name		: 'avr/io.h'
+* Title			: ATmega8 register file of the host simulator
+* Target		: Linux host (gcc / clang)
+*
+* Replaces avr-libc <avr/io.h> in the host build. Every register is a byte of SIM_unMem at its ATmega8 data
+* space address, so _SFR_MEM8 and the DIO register tables work unchanged. The registers with hardware side
+* effects (data registers, flags, conversion start) go through SIM_pu8Access which runs the peripheral
+* models, see SIM_avr.h.
+*
+************************************************************************************************************/
+
+#ifndef SIM_AVR_IO_H_
+#define SIM_AVR_IO_H_
+
+#include <stdint.h>
+
+#ifndef __AVR_ATmega8__
+#define __AVR_ATmega8__ 1
+#endif
+
+/* host build, see MCU_IDLE_HOOK of MCU.h */
+#define SIM_HOST 1
+
+/*----------------------------------------- MACROS Definitions --------------------------------------------*/
+
+/* data space 0x00 .. 0x5F (registers), UCSRC has its own slot (it shares 0x40 with UBRRH on the chip) */
+#define SIM_u16MEM_SIZE			0x62U
+#define SIM_u8UCSRC_ADDR		0x60U
+
+/* plain register: reads and writes are memory accesses */
+#define SIM_IO8(ADDR)			(SIM_unMem.au8[(ADDR)])
+#define SIM_IO16(ADDR)			(SIM_unMem.au16[(ADDR) >> 1])
+/* register with side effects: the access runs the peripheral models */
+#define SIM_HOOK8(ADDR)			(*SIM_pu8Access(ADDR))
+
+#define _SFR_MEM8(ADDR)			SIM_IO8(ADDR)
+#define _SFR_MEM16(ADDR)		SIM_IO16(ADDR)
+#define _SFR_IO8(ADDR)			SIM_IO8((ADDR) + 0x20U)
+#define _SFR_IO16(ADDR)			SIM_IO16((ADDR) + 0x20U)
+#define __SFR_OFFSET			0x20U
+#define _BV(BIT)				(1U << (BIT))
+
+#define TWBR	SIM_IO8(0x20)
+#define TWSR	SIM_IO8(0x21)
+#define TWAR	SIM_IO8(0x22)
+#define TWDR	SIM_IO8(0x23)
+#define ADCW	SIM_IO16(0x24)
+#define ADC		SIM_IO16(0x24)
+#define ADCL	SIM_IO8(0x24)
+#define ADCH	SIM_IO8(0x25)
+#define ADCSRA	SIM_HOOK8(0x26)
+#define ADMUX	SIM_IO8(0x27)
+#define ACSR	SIM_IO8(0x28)
+#define UBRRL	SIM_IO8(0x29)
+#define UCSRB	SIM_IO8(0x2A)
+#define UCSRA	SIM_HOOK8(0x2B)
+#define UDR		SIM_HOOK8(0x2C)
+#define SPCR	SIM_IO8(0x2D)
+#define SPSR	SIM_HOOK8(0x2E)
+#define SPDR	SIM_HOOK8(0x2F)
+#define PIND	SIM_IO8(0x30)
+#define DDRD	SIM_IO8(0x31)
+#define PORTD	SIM_IO8(0x32)
+#define PINC	SIM_IO8(0x33)
+#define DDRC	SIM_IO8(0x34)
+#define PORTC	SIM_IO8(0x35)
+#define PINB	SIM_IO8(0x36)
+#define DDRB	SIM_IO8(0x37)
+#define PORTB	SIM_IO8(0x38)
+#define EECR	SIM_IO8(0x3C)
+#define EEDR	SIM_IO8(0x3D)
+#define EEAR	SIM_IO16(0x3E)
+#define EEARL	SIM_IO8(0x3E)
+#define EEARH	SIM_IO8(0x3F)
+#define UBRRH	SIM_IO8(0x40)
+#define UCSRC	SIM_IO8(SIM_u8UCSRC_ADDR)
+#define WDTCR	SIM_IO8(0x41)
+#define ASSR	SIM_IO8(0x42)
+#define OCR2	SIM_IO8(0x43)
+#define TCNT2	SIM_IO8(0x44)
+#define TCCR2	SIM_IO8(0x45)
+#define ICR1	SIM_IO16(0x46)
+#define ICR1L	SIM_IO8(0x46)
+#define ICR1H	SIM_IO8(0x47)
+#define OCR1B	SIM_IO16(0x48)
+#define OCR1BL	SIM_IO8(0x48)
+#define OCR1BH	SIM_IO8(0x49)
+#define OCR1A	SIM_IO16(0x4A)
+#define OCR1AL	SIM_IO8(0x4A)
+#define OCR1AH	SIM_IO8(0x4B)
+#define TCNT1	SIM_IO16(0x4C)
+#define TCNT1L	SIM_IO8(0x4C)
+#define TCNT1H	SIM_IO8(0x4D)
+#define TCCR1B	SIM_IO8(0x4E)
+#define TCCR1A	SIM_IO8(0x4F)
+#define SFIOR	SIM_IO8(0x50)
+#define OSCCAL	SIM_IO8(0x51)
+#define TCNT0	SIM_IO8(0x52)
+#define TCCR0	SIM_IO8(0x53)
+#define MCUCSR	SIM_IO8(0x54)
+#define MCUCR	SIM_IO8(0x55)
+#define TWCR	SIM_IO8(0x56)
+#define SPMCR	SIM_IO8(0x57)
+#define TIFR	SIM_HOOK8(0x58)
+#define TIMSK	SIM_IO8(0x59)
+#define GIFR	SIM_IO8(0x5A)
+#define GICR	SIM_IO8(0x5B)
+#define SPL		SIM_IO8(0x5D)
+#define SPH		SIM_IO8(0x5E)
+#define SREG	SIM_IO8(0x5F)
+
+/* TWCR */
+#define TWINT	7
+#define TWEA	6
+#define TWSTA	5
+#define TWSTO	4
+#define TWWC	3
+#define TWEN	2
+#define TWIE	0
+/* TWSR */
+#define TWPS1	1
+#define TWPS0	0
+/* TWAR */
+#define TWGCE	0
+/* ADMUX */
+#define REFS1	7
+#define REFS0	6
+#define ADLAR	5
+#define MUX3	3
+#define MUX2	2
+#define MUX1	1
+#define MUX0	0
+/* ADCSRA */
+#define ADEN	7
+#define ADSC	6
+#define ADFR	5
+#define ADIF	4
+#define ADIE	3
+#define ADPS2	2
+#define ADPS1	1
+#define ADPS0	0
+/* ACSR */
+#define ACD		7
+#define ACBG	6
+#define ACO		5
+#define ACI		4
+#define ACIE	3
+#define ACIC	2
+#define ACIS1	1
+#define ACIS0	0
+/* UCSRB */
+#define RXCIE	7
+#define TXCIE	6
+#define UDRIE	5
+#define RXEN	4
+#define TXEN	3
+#define UCSZ2	2
+#define RXB8	1
+#define TXB8	0
+/* UCSRA */
+#define RXC		7
+#define TXC		6
+#define UDRE	5
+#define FE		4
+#define DOR		3
+#define PE		2
+#define U2X		1
+#define MPCM	0
+/* UCSRC */
+#define URSEL	7
+#define UMSEL	6
+#define UPM1	5
+#define UPM0	4
+#define USBS	3
+#define UCSZ1	2
+#define UCSZ0	1
+#define UCPOL	0
+/* SPCR */
+#define SPIE	7
+#define SPE		6
+#define DORD	5
+#define MSTR	4
+#define CPOL	3
+#define CPHA	2
+#define SPR1	1
+#define SPR0	0
+/* SPSR */
+#define SPIF	7
+#define WCOL	6
+#define SPI2X	0
+/* EECR */
+#define EERIE	3
+#define EEMWE	2
+#define EEWE	1
+#define EERE	0
+/* WDTCR */
+#define WDCE	4
+#define WDE		3
+#define WDP2	2
+#define WDP1	1
+#define WDP0	0
+/* ASSR */
+#define AS2		3
+#define TCN2UB	2
+#define OCR2UB	1
+#define TCR2UB	0
+/* TCCR2 */
+#define FOC2	7
+#define WGM20	6
+#define COM21	5
+#define COM20	4
+#define WGM21	3
+#define CS22	2
+#define CS21	1
+#define CS20	0
+/* TCCR1A */
+#define COM1A1	7
+#define COM1A0	6
+#define COM1B1	5
+#define COM1B0	4
+#define FOC1A	3
+#define FOC1B	2
+#define WGM11	1
+#define WGM10	0
+/* TCCR1B */
+#define ICNC1	7
+#define ICES1	6
+#define WGM13	4
+#define WGM12	3
+#define CS12	2
+#define CS11	1
+#define CS10	0
+/* SFIOR */
+#define ACME	3
+#define PUD		2
+#define PSR2	1
+#define PSR10	0
+/* TCCR0 */
+#define CS02	2
+#define CS01	1
+#define CS00	0
+/* MCUCSR */
+#define WDRF	3
+#define BORF	2
+#define EXTRF	1
+#define PORF	0
+/* MCUCR */
+#define SE		7
+#define SM2		6
+#define SM1		5
+#define SM0		4
+#define ISC11	3
+#define ISC10	2
+#define ISC01	1
+#define ISC00	0
+/* TIFR */
+#define OCF2	7
+#define TOV2	6
+#define ICF1	5
+#define OCF1A	4
+#define OCF1B	3
+#define TOV1	2
+#define TOV0	0
+/* TIMSK */
+#define OCIE2	7
+#define TOIE2	6
+#define TICIE1	5
+#define OCIE1A	4
+#define OCIE1B	3
+#define TOIE1	2
+#define TOIE0	0
+/* GIFR */
+#define INTF1	7
+#define INTF0	6
+/* GICR */
+#define INT1	7
+#define INT0	6
+#define IVSEL	1
+#define IVCE	0
+/* SREG */
+#define SREG_I	7
+#define SREG_T	6
+#define SREG_H	5
+#define SREG_S	4
+#define SREG_V	3
+#define SREG_N	2
+#define SREG_Z	1
+#define SREG_C	0
+
+/* port pins */
+#define PB7	7
+#define PB6	6
+#define PB5	5
+#define PB4	4
+#define PB3	3
+#define PB2	2
+#define PB1	1
+#define PB0	0
+#define PC6	6
+#define PC5	5
+#define PC4	4
+#define PC3	3
+#define PC2	2
+#define PC1	1
+#define PC0	0
+#define PD7	7
+#define PD6	6
+#define PD5	5
+#define PD4	4
+#define PD3	3
+#define PD2	2
+#define PD1	1
+#define PD0	0
+#define DDB7	7
+#define DDB6	6
+#define DDB5	5
+#define DDB4	4
+#define DDB3	3
+#define DDB2	2
+#define DDB1	1
+#define DDB0	0
+#define DDC6	6
+#define DDC5	5
+#define DDC4	4
+#define DDC3	3
+#define DDC2	2
+#define DDC1	1
+#define DDC0	0
+#define DDD7	7
+#define DDD6	6
+#define DDD5	5
+#define DDD4	4
+#define DDD3	3
+#define DDD2	2
+#define DDD1	1
+#define DDD0	0
+
+#define RAMSTART	0x60
+#define RAMEND		0x45F
+#define FLASHEND	0x1FFF
+#define E2END		0x1FF
+#define SPM_PAGESIZE 64
+
+/*------------------------------------------ Type Definitions  --------------------------------------------*/
+
+typedef union{
+	uint8_t		au8[SIM_u16MEM_SIZE];
+	uint16_t	au16[SIM_u16MEM_SIZE / 2U];
+}SIM_tunMem;
+
+/*------------------------------------------ Global Variables ---------------------------------------------*/
+
+/* register file, defined by SIM_avr.c */
+extern volatile SIM_tunMem SIM_unMem;
+
+/*---------------------------------------- FUNCTION Definitions -------------------------------------------*/
+
+/* resolve the previous side effect access, advance the clock and prepare the access to ADDR */
+extern volatile uint8_t *SIM_pu8Access(uint8_t u8Addr);
+
+#endif /* SIM_AVR_IO_H_ */
@@ -0,0 +1,40 @@
+/*! \file pgmspace.h \brief Program memory access of the host simulator. */
+/************************************************************************************************************
+*
+* File Name		: 'avr/pgmspace.h'
+* Title			: Program memory access of the host simulator
+* Target		: Linux host (gcc / clang)
+*
+* Flash and RAM share the host address space, PROGMEM data stays in .rodata and the _P functions are the
+* plain ones.
+*
+************************************************************************************************************/
+
+#ifndef SIM_AVR_PGMSPACE_H_
+#define SIM_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+
+/*----------------------------------------- MACROS Definitions --------------------------------------------*/
+
+#define PROGMEM
+#define PGM_P					const char *
+#define PSTR(STR)				(STR)
+
+#define pgm_read_byte(ADDR)		(*(const uint8_t *)(ADDR))
+#define pgm_read_word(ADDR)		(*(const uint16_t *)(ADDR))
+#define pgm_read_dword(ADDR)	(*(const uint32_t *)(ADDR))
+#define pgm_read_ptr(ADDR)		(*(void * const *)(ADDR))
+
+#define memcpy_P				memcpy
+#define strlen_P				strlen
+#define strcpy_P				strcpy
+#define strcmp_P				strcmp
+#define vfprintf_P				vfprintf
+#define printf_P				printf
+#define sprintf_P				sprintf
+#define snprintf_P				snprintf
+
+#endif /* SIM_AVR_PGMSPACE_H_ */
@@ -0,0 +1,36 @@
+/*! \file sleep.h \brief Sleep modes of the host simulator. */
+/************************************************************************************************************
+*
+* File Name		: 'avr/sleep.h'
+* Title			: Sleep modes of the host simulator
+* Target		: Linux host (gcc / clang)
+*
+* sleep_cpu() advances the simulated clock up to the next interrupt. All the peripheral clocks keep running
+* whatever the mode, the ADC noise reduction mode starts a conversion like on the chip.
+*
+************************************************************************************************************/
+
+#ifndef SIM_AVR_SLEEP_H_
+#define SIM_AVR_SLEEP_H_
+
+#include <avr/io.h>
+
+/*----------------------------------------- MACROS Definitions --------------------------------------------*/
+
+#define SLEEP_MODE_IDLE			0x00U
+#define SLEEP_MODE_ADC			(1U << SM0)
+#define SLEEP_MODE_PWR_DOWN		(1U << SM1)
+#define SLEEP_MODE_PWR_SAVE		((1U << SM0) | (1U << SM1))
+#define SLEEP_MODE_STANDBY		((1U << SM1) | (1U << SM2))
+
+#define set_sleep_mode(MODE)	(MCUCR = (uint8_t)((MCUCR & ~((1U << SM0) | (1U << SM1) | (1U << SM2))) | (MODE)))
+#define sleep_enable()			(MCUCR |= (1U << SE))
+#define sleep_disable()			(MCUCR &= (uint8_t)~(1U << SE))
+#define sleep_cpu()				SIM_vidSleepCpu()
+#define sleep_mode()			do { sleep_enable(); sleep_cpu(); sleep_disable(); } while (0)
+
+/*---------------------------------------- FUNCTION Definitions -------------------------------------------*/
+
+extern void SIM_vidSleepCpu(void);
+
+#endif /* SIM_AVR_SLEEP_H_ */
@@ -0,0 +1,32 @@
+/*! \file wdt.h \brief Watchdog of the host simulator. */
+/************************************************************************************************************
+*
+* File Name		: 'avr/wdt.h'
+* Title			: Watchdog of the host simulator
+* Target		: Linux host (gcc / clang)
+*
+* The watchdog is not modelled, the calls only keep WDTCR up to date.
+*
+************************************************************************************************************/
+
+#ifndef SIM_AVR_WDT_H_
+#define SIM_AVR_WDT_H_
+
+#include <avr/io.h>
+
+/*----------------------------------------- MACROS Definitions --------------------------------------------*/
+
+#define WDTO_15MS	0
+#define WDTO_30MS	1
+#define WDTO_60MS	2
+#define WDTO_120MS	3
+#define WDTO_250MS	4
+#define WDTO_500MS	5
+#define WDTO_1S		6
+#define WDTO_2S		7
+
+#define wdt_reset()				do { } while (0)
+#define wdt_enable(TIMEOUT)		(WDTCR = (uint8_t)((1U << WDE) | ((TIMEOUT) & 0x07U)))
+#define wdt_disable()			(WDTCR = 0U)
+
+#endif /* SIM_AVR_WDT_H_ */
@@ -0,0 +1,65 @@
+/*! \file stdio.h \brief avr-libc stdio streams on top of the host stdio. */
+/************************************************************************************************************
+*
+* File Name		: 'stdio.h'
+* Title			: avr-libc stdio streams on top of the host stdio
+* Target		: Linux host (gcc / clang)
+*
+* The firmware sets up its own streams with FDEV_SETUP_STREAM and assigns them to stdout / stdin. In the
+* firmware sources FILE, stdout, stdin and the print functions are redirected to SIM_ equivalents that call
+* the put / get functions of those streams; until the firmware sets stdout it prints to the host stdout.
+* The simulator sources define SIM_REAL_STDIO to keep the host ones.
+*
+************************************************************************************************************/
+
+#include_next <stdio.h>
+
+#ifndef SIM_STDIO_H_
+#define SIM_STDIO_H_
+
+#include <stdarg.h>
+#include <stdint.h>
+
+/*----------------------------------------- MACROS Definitions --------------------------------------------*/
+
+#define _FDEV_SETUP_READ		0x01U
+#define _FDEV_SETUP_WRITE		0x02U
+#define _FDEV_SETUP_RW			(_FDEV_SETUP_READ | _FDEV_SETUP_WRITE)
+#define FDEV_SETUP_STREAM(PUT, GET, FLAGS)	{ (PUT), (GET), (FLAGS) }
+
+/*------------------------------------------ Type Definitions  --------------------------------------------*/
+
+typedef struct SIM_strFile{
+	void	(*pfvPut)(char cChar, struct SIM_strFile *pstrStream);
+	char	(*pfcGet)(struct SIM_strFile *pstrStream);
+	uint8_t	u8Flags;
+}SIM_FILE;
+
+/*------------------------------------------ Global Variables ---------------------------------------------*/
+
+extern SIM_FILE *SIM_pstrStdout;
+extern SIM_FILE *SIM_pstrStdin;
+
+/*---------------------------------------- FUNCTION Definitions -------------------------------------------*/
+
+extern int SIM_vfprintf(SIM_FILE *pstrStream, const char *pcFormat, va_list ap);
+extern int SIM_printf(const char *pcFormat, ...);
+extern int SIM_putchar(int iChar);
+extern int SIM_puts(const char *pcText);
+extern int SIM_getchar(void);
+
+#endif /* SIM_STDIO_H_ */
+
+#if !defined(SIM_REAL_STDIO) && !defined(SIM_STDIO_REDIRECT_)
+#define SIM_STDIO_REDIRECT_
+#undef stdout
+#undef stdin
+#define FILE					SIM_FILE
+#define stdout					SIM_pstrStdout
+#define stdin					SIM_pstrStdin
+#define vfprintf(...)			SIM_vfprintf(__VA_ARGS__)
+#define printf(...)				SIM_printf(__VA_ARGS__)
+#define putchar(...)			SIM_putchar(__VA_ARGS__)
+#define puts(...)				SIM_puts(__VA_ARGS__)
+#define getchar(...)			SIM_getchar(__VA_ARGS__)
+#endif
@@ -0,0 +1,26 @@
+/*! \file delay.h \brief Busy wait delays of the host simulator. */
+/************************************************************************************************************
+*
+* File Name		: 'util/delay.h'
+* Title			: Busy wait delays of the host simulator
+* Target		: Linux host (gcc / clang)
+*
+* The delays advance the simulated clock (F_CPU cycles per second), the interrupts run meanwhile.
+*
+************************************************************************************************************/
+
+#ifndef SIM_UTIL_DELAY_H_
+#define SIM_UTIL_DELAY_H_
+
+#include <stdint.h>
+
+/*----------------------------------------- MACROS Definitions --------------------------------------------*/
+
+#define _delay_us(US)			SIM_vidDelayUs((uint32_t)(US))
+#define _delay_ms(MS)			SIM_vidDelayUs((uint32_t)(MS) * 1000UL)
+
+/*---------------------------------------- FUNCTION Definitions -------------------------------------------*/
+
+extern void SIM_vidDelayUs(uint32_t u32Us);
+
+#endif /* SIM_UTIL_DELAY_H_ */
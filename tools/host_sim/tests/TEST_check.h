@@ -0,0 +1,57 @@
+/*! \file TEST_check.h \brief Assertions of the host unit tests. */
+/************************************************************************************************************
+*
+* File Name		: 'TEST_check.h'
+* Title			: Assertions of the host unit tests
+* Target		: Linux host (gcc / clang)
+*
+* Every test program includes this header once. TEST_CHECK reports a failed condition and goes on, so one
+* run lists all the failures; TEST_iResult gives the exit status seen by ctest.
+*
+************************************************************************************************************/
+
+#ifndef TEST_CHECK_H_
+#define TEST_CHECK_H_
+
+#define SIM_REAL_STDIO
+#include <stdio.h>
+#include "SIM_avr.h"
+
+/*----------------------------------------- MACROS Definitions --------------------------------------------*/
+
+#define TEST_CHECK(COND)		TEST_vidCheck((COND) ? TRUE : FALSE, #COND, __FILE__, __LINE__)
+#define TEST_CHECK_EQ(A, B)		TEST_vidCheckEq((long)(A), (long)(B), #A " == " #B, __FILE__, __LINE__)
+
+/*---------------------------------------------- Global Variables -----------------------------------------*/
+
+static uint32 u32TestChecks = 0;
+static uint32 u32TestFailures = 0;
+
+/*---------------------------------------- FUNCTION Definitions -------------------------------------------*/
+
+static void TEST_vidCheck(boolean bOk, const char *pcCond, const char *pcFile, int iLine)
+{
+	u32TestChecks++;
+	if (bOk == FALSE){
+		u32TestFailures++;
+		(void)fprintf(stderr, "%s:%d: check failed: %s\n", pcFile, iLine, pcCond);
+	}
+}
+
+static void TEST_vidCheckEq(long lA, long lB, const char *pcCond, const char *pcFile, int iLine)
+{
+	u32TestChecks++;
+	if (lA != lB){
+		u32TestFailures++;
+		(void)fprintf(stderr, "%s:%d: check failed: %s (%ld != %ld)\n", pcFile, iLine, pcCond, lA, lB);
+	}
+}
+
+/* summary line and exit status of the test program */
+static int TEST_iResult(const char *pcName)
+{
+	(void)printf("%s: %lu checks, %lu failed\n", pcName, (unsigned long)u32TestChecks, (unsigned long)u32TestFailures);
+	return (u32TestFailures == 0U) ? 0 : 1;
+}
+
+#endif /* TEST_CHECK_H_ */
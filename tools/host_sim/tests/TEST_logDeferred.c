@@ -0,0 +1,210 @@
+/*! \file TEST_logDeferred.c \brief Host unit test of the deferred log records. */
+/************************************************************************************************************
+*
+* File Name		: 'TEST_logDeferred.c'
+* Title			: Host unit test of the deferred log records
+* Target		: Linux host (gcc / clang)
+*
+* Built with LOG_MODE = LOG_MODE_DEFERRED (LOG_uartLogger.c is compiled into the test). Checks the frame
+* layout of LOG_uartLogger.h on the UART line, the argument signature, the lost records frame after a full
+* ring and that LOG_vidDrain only hands whole frames to the UART.
+*
+************************************************************************************************************/
+
+/*------------------------------------------------- INCLUDES ----------------------------------------------*/
+
+#include <string.h>
+#include "TEST_check.h"
+#include "LOG_uartLogger.h"
+#include "SCI_uart.h"
+#include "TIM_timers.h"
+
+#if (LOG_MODE != LOG_MODE_DEFERRED)
+#error "TEST_logDeferred needs LOG_MODE = LOG_MODE_DEFERRED"
+#endif
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+/* cycles to send the whole UART TX ring at the logger baud rate */
+#define TEST_u32DRAIN_CYCLES	((u8TX_BUFFER_SIZE + 1UL) * 1100UL)
+#define TEST_u8HEADER			7U
+
+/*---------------------------------------------- Global Variables -----------------------------------------*/
+
+static const char acTestFmtA[] = "a %d %ld";
+static const char acTestFmtB[] = "b";
+static uint8 au8TestLine[SIM_u16UART_TX_SIZE];
+static uint16 u16TestLineLen;
+static uint16 u16TestLinePos;
+/* ms count when the records were taken, the tick is held off meanwhile */
+static uint32 u32TestStamp;
+
+/*-------------------------------------Static functions Definitions ---------------------------------------*/
+
+/* take the records of one case at the same ms */
+static void TEST_vidRecordStart(void)
+{
+	cli();
+	u32TestStamp = TIM_u32GetMillis();
+}
+
+/* drain the records, send them and capture the UART line */
+static void TEST_vidFlush(void)
+{
+	uint8 u8Round;
+
+	for (u8Round = 0; u8Round < 4U; u8Round++){
+		LOG_vidDrain();
+		SIM_vidRunCycles(TEST_u32DRAIN_CYCLES);
+	}
+	u16TestLineLen = SIM_u16UartTxRead(au8TestLine, sizeof(au8TestLine));
+	u16TestLinePos = 0U;
+}
+
+static uint32 TEST_u32Le(const uint8 *pu8Data, uint8 u8Size)
+{
+	uint32 u32Value = 0UL;
+
+	while (u8Size != 0U){
+		u8Size--;
+		u32Value = (u32Value << 8) | pu8Data[u8Size];
+	}
+	return u32Value;
+}
+
+/* check the next frame of the captured line, return its arguments */
+static void TEST_vidExpectFrame(uint8 u8Sig, const char *pcFmt, uint32 *pu32Args)
+{
+	const uint8 *pu8Frame = &au8TestLine[u16TestLinePos];
+	uint8 u8ArgsLen = 0U;
+	uint8 u8Chk;
+	uint8 u8Index;
+
+	for (u8Index = 0; u8Index < (u8Sig >> 4); u8Index++){
+		u8ArgsLen += (u8Sig & (1U << u8Index)) ? 4U : 2U;
+	}
+	if ((uint16)(u16TestLinePos + 3U + TEST_u8HEADER + u8ArgsLen) > u16TestLineLen){
+		TEST_CHECK(FALSE);
+		return;
+	}
+	TEST_CHECK_EQ(pu8Frame[0], LOG_u8FRAME_SYNC);
+	TEST_CHECK_EQ(pu8Frame[1], TEST_u8HEADER + u8ArgsLen);
+	TEST_CHECK_EQ(pu8Frame[2], u8Sig);
+	TEST_CHECK_EQ(TEST_u32Le(&pu8Frame[3], 2U), (uint16)(uintptr_t)pcFmt);
+	TEST_CHECK_EQ(TEST_u32Le(&pu8Frame[5], 4U), u32TestStamp);
+	u8Chk = pu8Frame[1];
+	for (u8Index = 2U; u8Index < (uint8)(2U + TEST_u8HEADER + u8ArgsLen); u8Index++){
+		u8Chk ^= pu8Frame[u8Index];
+	}
+	TEST_CHECK_EQ(pu8Frame[2U + TEST_u8HEADER + u8ArgsLen], u8Chk);
+
+	pu8Frame += 2U + TEST_u8HEADER;
+	for (u8Index = 0; u8Index < (u8Sig >> 4); u8Index++){
+		if (u8Sig & (1U << u8Index)){
+			pu32Args[u8Index] = TEST_u32Le(pu8Frame, 4U);
+			pu8Frame += 4U;
+		} else {
+			pu32Args[u8Index] = TEST_u32Le(pu8Frame, 2U);
+			pu8Frame += 2U;
+		}
+	}
+	u16TestLinePos += 3U + TEST_u8HEADER + u8ArgsLen;
+}
+
+/*------------------------------------------------- Cases -------------------------------------------------*/
+
+static void TEST_vidSignature(void)
+{
+	char cChar = 'x';
+	long lLong = 1L;
+
+	TEST_CHECK_EQ(LOG_ARGS_SIG("f"), 0x00U);
+	TEST_CHECK_EQ(LOG_ARGS_SIG("f", cChar), 0x10U);
+	TEST_CHECK_EQ(LOG_ARGS_SIG("f", 1, lLong), 0x22U);
+	TEST_CHECK_EQ(LOG_ARGS_SIG("f", lLong, 2, lLong, cChar), 0x45U);
+}
+
+static void TEST_vidFrame(void)
+{
+	uint32 au32Args[LOG_u8MAX_ARGS];
+
+	TEST_vidRecordStart();
+	LOG_vidDeferredPrintLn(acTestFmtA, LOG_ARGS_SIG(acTestFmtA, 0x1234, 0x11223344L), 0x1234, 0x11223344L);
+	LOG_vidDeferredPrintLn(acTestFmtB, LOG_ARGS_SIG(acTestFmtB));
+	sei();
+	/* nothing is sent before the drain */
+	SIM_vidRunCycles(TEST_u32DRAIN_CYCLES);
+	TEST_CHECK_EQ(SIM_u16UartTxRead(au8TestLine, sizeof(au8TestLine)), 0U);
+
+	TEST_vidFlush();
+	TEST_CHECK_EQ(u16TestLineLen, (3U + TEST_u8HEADER + 6U) + (3U + TEST_u8HEADER));
+	TEST_vidExpectFrame(0x22U, acTestFmtA, au32Args);
+	TEST_CHECK_EQ(au32Args[0], 0x1234U);
+	TEST_CHECK_EQ(au32Args[1], 0x11223344UL);
+	TEST_vidExpectFrame(0x00U, acTestFmtB, au32Args);
+}
+
+static void TEST_vidLostRecords(void)
+{
+	uint32 au32Args[LOG_u8MAX_ARGS];
+	uint8 u8Index;
+
+	/* 10 bytes per frame: 12 fit in the 128 bytes ring, 3 are lost */
+	TEST_vidRecordStart();
+	for (u8Index = 0; u8Index < 15U; u8Index++){
+		LOG_vidDeferredPrintLn(acTestFmtB, 0x00U);
+	}
+	sei();
+	TEST_vidFlush();
+	TEST_CHECK_EQ(u16TestLineLen, 12U * (3U + TEST_u8HEADER));
+	for (u8Index = 0; u8Index < 12U; u8Index++){
+		TEST_vidExpectFrame(0x00U, acTestFmtB, au32Args);
+	}
+
+	/* the next record is preceded by the lost count, format ID 0 */
+	TEST_vidRecordStart();
+	LOG_vidDeferredPrintLn(acTestFmtA, 0x22U, 7, 8L);
+	sei();
+	TEST_vidFlush();
+	TEST_vidExpectFrame(0x10U, NULL, au32Args);
+	TEST_CHECK_EQ(au32Args[0], 3U);
+	TEST_vidExpectFrame(0x22U, acTestFmtA, au32Args);
+	TEST_CHECK_EQ(au32Args[0], 7U);
+	TEST_CHECK_EQ(au32Args[1], 8U);
+	TEST_CHECK_EQ(u16TestLinePos, u16TestLineLen);
+}
+
+static void TEST_vidWholeFrames(void)
+{
+	uint32 au32Args[LOG_u8MAX_ARGS];
+	uint8 au8Text[u8TX_BUFFER_SIZE];
+
+	/* UART ring almost full: the frame waits in the log ring, it is never split */
+	memset(au8Text, '.', sizeof(au8Text));
+	TEST_vidRecordStart();
+	(void)UART_u8Write(au8Text, u8TX_BUFFER_SIZE - 5U);
+	LOG_vidDeferredPrintLn(acTestFmtB, 0x00U);
+	LOG_vidDrain();
+	TEST_CHECK_EQ(UART_u8GetTxFree(), 5U);
+	sei();
+	SIM_vidRunCycles(TEST_u32DRAIN_CYCLES);
+	TEST_CHECK_EQ(SIM_u16UartTxRead(au8TestLine, sizeof(au8TestLine)), u8TX_BUFFER_SIZE - 5U);
+	TEST_vidFlush();
+	TEST_vidExpectFrame(0x00U, acTestFmtB, au32Args);
+	TEST_CHECK_EQ(u16TestLinePos, u16TestLineLen);
+}
+
+int main(void)
+{
+	LOG_vidInit();
+	TIM_vidInitT0();
+	sei();
+	/* a time stamp that uses more than one byte */
+	SIM_vidRunCycles(300000UL);
+
+	TEST_vidSignature();
+	TEST_vidFrame();
+	TEST_vidLostRecords();
+	TEST_vidWholeFrames();
+	return TEST_iResult("TEST_logDeferred");
+}
@@ -0,0 +1,178 @@
+/*! \file TEST_schTick.c \brief Host unit test of the scheduler tick count down. */
+/************************************************************************************************************
+*
+* File Name		: 'TEST_schTick.c'
+* Title			: Host unit test of the scheduler tick count down
+* Target		: Linux host (gcc / clang)
+*
+* Runs SCH_vidTimIsr from the simulated Timer 0 tick: first release on the offset tick, one release per
+* period, a stretched tick shorter than the period keeps the release grid, a longer one collapses the late
+* periods into a single release, and a release still waiting is counted as missed. The first watchdog window
+* of a task opens at its release offset.
+*
+************************************************************************************************************/
+
+/*------------------------------------------------- INCLUDES ----------------------------------------------*/
+
+#include <string.h>
+#include "TEST_check.h"
+#include "OS/SCH_scheduler.h"
+#include "OS/WDG_supervisor.h"
+#include "TIM_timers.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+/* main loop step: the task starts within 100 us of its release, on the same ms */
+#define TEST_u16STEP_CYCLES		100U
+#define TEST_u8MAX_RUNS			32U
+
+/*---------------------------------------------- Global Variables -----------------------------------------*/
+
+/* ms count seen by every run of the task */
+static uint32 au32TestRuns[TEST_u8MAX_RUNS];
+static uint8 u8TestNoOfRuns;
+
+/*-------------------------------------Static functions Definitions ---------------------------------------*/
+
+static void TEST_vidTask(void)
+{
+	if (u8TestNoOfRuns < TEST_u8MAX_RUNS){
+		au32TestRuns[u8TestNoOfRuns] = TIM_u32GetMillis();
+		u8TestNoOfRuns++;
+	}
+}
+
+/* main loop for u16Ms ms */
+static void TEST_vidRun(uint16 u16Ms)
+{
+	uint32 u32Steps = ((uint32)u16Ms * 1000UL) / TEST_u16STEP_CYCLES;
+
+	while (u32Steps != 0U){
+		SIM_vidRunCycles(TEST_u16STEP_CYCLES);
+		SCH_vidDispatch();
+		u32Steps--;
+	}
+}
+
+/* the runs from u8First on are u32Period ms apart, starting at u32Start */
+static void TEST_vidCheckGrid(uint8 u8First, uint8 u8Last, uint32 u32Start, uint32 u32Period)
+{
+	uint8 u8Run;
+
+	for (u8Run = u8First; u8Run <= u8Last; u8Run++){
+		TEST_CHECK_EQ(au32TestRuns[u8Run], u32Start + ((uint32)(u8Run - u8First) * u32Period));
+	}
+}
+
+/* stretch the next tick as SCH_vidIdle does and let it run to its end */
+static void TEST_vidStretch(uint8 u8Ms)
+{
+	cli();
+	TIM_vidT0StretchTick(u8Ms);
+	sei();
+	TEST_vidRun(u8Ms);
+}
+
+/*------------------------------------------------- Cases -------------------------------------------------*/
+
+static void TEST_vidCountdown(void)
+{
+	SCH_tstrTaskStats strStats;
+	uint8 u8TaskId;
+
+	SIM_vidReset();
+	SCH_vidSchInit();
+	u8TestNoOfRuns = 0U;
+	u8TaskId = SCH_u8AddTask(TEST_vidTask, 10U, 3U);
+	TEST_CHECK(u8TaskId != SCH_u8INVALID_TASK);
+	sei();
+
+	/* released on the tick number 3 (the first tick ends the ms 1), then every 10 ticks */
+	TEST_vidRun(55U);
+	TEST_CHECK_EQ(u8TestNoOfRuns, 6U);
+	TEST_vidCheckGrid(0U, 5U, 4U, 10U);
+
+	/* the tick ISR keeps counting while the main loop is busy: one release is lost, not delayed twice */
+	SIM_vidRunCycles(25000UL);
+	SCH_vidDispatch();
+	TEST_CHECK_EQ(u8TestNoOfRuns, 7U);
+	TEST_CHECK_EQ(SCH_eGetTaskStats(u8TaskId, &strStats), STD_ERR_OK);
+	TEST_CHECK_EQ(strStats.u16Runs, 7U);
+	TEST_CHECK_EQ(strStats.u16Missed, 1U);
+	TEST_vidRun(10U);
+	TEST_CHECK_EQ(au32TestRuns[7], 84U);
+
+	SCH_vidRemoveTask(u8TaskId);
+	TEST_vidRun(30U);
+	TEST_CHECK_EQ(u8TestNoOfRuns, 8U);
+	cli();
+}
+
+static void TEST_vidStretchedTicks(void)
+{
+	uint8 u8TaskId;
+
+	SIM_vidReset();
+	SCH_vidSchInit();
+	u8TestNoOfRuns = 0U;
+	u8TaskId = SCH_u8AddTask(TEST_vidTask, 10U, 0U);
+	sei();
+	TEST_vidRun(21U);
+	TEST_CHECK_EQ(u8TestNoOfRuns, 3U);
+	TEST_vidCheckGrid(0U, 2U, 1U, 10U);
+
+	/* 21 -> ~26 ms in one tick, shorter than the period: the release of 31 stays on the grid */
+	TEST_vidStretch(5U);
+	TEST_vidRun(25U);
+	TEST_CHECK_EQ(u8TestNoOfRuns, 5U);
+	TEST_vidCheckGrid(2U, 4U, 21U, 10U);
+
+	/* ~26 ms stretch from 51: the releases of 61 and 71 collapse into one at the end of the stretch, the next
+	   tick starts a new grid */
+	TEST_vidStretch(26U);
+	TEST_CHECK_EQ(u8TestNoOfRuns, 6U);
+	TEST_CHECK(au32TestRuns[5] > 71U);
+	TEST_vidRun(25U);
+	TEST_CHECK_EQ(u8TestNoOfRuns, 9U);
+	TEST_vidCheckGrid(6U, 8U, au32TestRuns[5] + 1U, 10U);
+
+	SCH_vidRemoveTask(u8TaskId);
+	cli();
+}
+
+static void TEST_vidFirstWindow(void)
+{
+	uint8 u8TaskId;
+
+	SIM_vidReset();
+	SCH_vidSchInit();
+	u8TestNoOfRuns = 0U;
+	/* offset longer than period + WDG_u16DEFAULT_SLACK_MS */
+	u8TaskId = SCH_u8AddTask(TEST_vidTask, 100U, 1000U);
+	sei();
+	TEST_vidRun(1250U);
+	TEST_CHECK_EQ(u8TestNoOfRuns, 3U);
+	TEST_vidCheckGrid(0U, 2U, 1001U, 100U);
+	TEST_CHECK_EQ(WDTCR, (uint8)((1U << WDE) | WDG_u8HW_TIMEOUT));
+
+	/* never dispatched: the first window closes at offset + period + slack, not before */
+	SIM_vidReset();
+	SCH_vidSchInit();
+	u8TaskId = SCH_u8AddTask(TEST_vidTask, 100U, 1000U);
+	sei();
+	SIM_vidRunCycles(1590000UL);
+	TEST_CHECK_EQ(WDTCR, (uint8)((1U << WDE) | WDG_u8HW_TIMEOUT));
+	SIM_vidRunCycles(20000UL);
+	TEST_CHECK_EQ(WDTCR, (uint8)((1U << WDE) | WDTO_15MS));
+
+	SCH_vidRemoveTask(u8TaskId);
+	cli();
+}
+
+int main(void)
+{
+	TEST_vidCountdown();
+	TEST_vidStretchedTicks();
+	TEST_vidFirstWindow();
+	return TEST_iResult("TEST_schTick");
+}
@@ -0,0 +1,211 @@
+/*! \file TEST_swtDeltaList.c \brief Host unit test of the software timers delta list. */
+/************************************************************************************************************
+*
+* File Name		: 'TEST_swtDeltaList.c'
+* Title			: Host unit test of the software timers delta list
+* Target		: Linux host (gcc / clang)
+*
+* Drives SWT_vidTickIsr by hand (no Timer 0): expiry order, equal expiries, stop in the middle of the list,
+* periodic grid, a late (stretched) tick, deferred call backs and the pool limits.
+*
+************************************************************************************************************/
+
+/*------------------------------------------------- INCLUDES ----------------------------------------------*/
+
+#include <string.h>
+#include "TEST_check.h"
+#include "OS/SWT_softTimers.h"
+
+/*---------------------------------------------- Global Variables -----------------------------------------*/
+
+/* tick number of the last expiry and number of expiries of the timers 0 .. 3 */
+static uint16 u16TestNow;
+static uint16 au16TestLast[4];
+static uint16 au16TestCount[4];
+
+/*-------------------------------------Static functions Definitions ---------------------------------------*/
+
+static void TEST_vidExpired(uint8 u8Index)
+{
+	au16TestLast[u8Index] = u16TestNow;
+	au16TestCount[u8Index]++;
+}
+
+static void TEST_vidClbk0(void) { TEST_vidExpired(0U); }
+static void TEST_vidClbk1(void) { TEST_vidExpired(1U); }
+static void TEST_vidClbk2(void) { TEST_vidExpired(2U); }
+static void TEST_vidClbk3(void) { TEST_vidExpired(3U); }
+
+static void TEST_vidSetUp(void)
+{
+	SWT_vidInit();
+	u16TestNow = 0U;
+	memset(au16TestLast, 0, sizeof(au16TestLast));
+	memset(au16TestCount, 0, sizeof(au16TestCount));
+}
+
+/* u16Ms ticks of 1 ms */
+static void TEST_vidTicks(uint16 u16Ms)
+{
+	while (u16Ms != 0U){
+		u16TestNow++;
+		SWT_vidTickIsr(1U);
+		u16Ms--;
+	}
+}
+
+/*------------------------------------------------- Cases -------------------------------------------------*/
+
+static void TEST_vidOrder(void)
+{
+	uint8 u8T0, u8T1, u8T2;
+
+	TEST_vidSetUp();
+	u8T0 = SWT_u8Create(TEST_vidClbk0, SWT_u8ONE_SHOT, SWT_u8CTX_ISR);
+	u8T1 = SWT_u8Create(TEST_vidClbk1, SWT_u8ONE_SHOT, SWT_u8CTX_ISR);
+	u8T2 = SWT_u8Create(TEST_vidClbk2, SWT_u8ONE_SHOT, SWT_u8CTX_ISR);
+	/* started out of order, equal expiries keep the start order */
+	TEST_CHECK_EQ(SWT_eStart(u8T0, 30U), STD_ERR_OK);
+	TEST_CHECK_EQ(SWT_eStart(u8T1, 10U), STD_ERR_OK);
+	TEST_CHECK_EQ(SWT_eStart(u8T2, 10U), STD_ERR_OK);
+	TEST_CHECK_EQ(SWT_u16GetNextExpiry(), 10U);
+	/* a running timer can not be started again */
+	TEST_CHECK_EQ(SWT_eStart(u8T1, 5U), STD_ERR_NOK);
+
+	TEST_vidTicks(9U);
+	TEST_CHECK_EQ(au16TestCount[1] + au16TestCount[2], 0U);
+	TEST_vidTicks(1U);
+	TEST_CHECK_EQ(au16TestLast[1], 10U);
+	TEST_CHECK_EQ(au16TestLast[2], 10U);
+	TEST_CHECK(SWT_bIsRunning(u8T1) == FALSE);
+	TEST_CHECK_EQ(SWT_u16GetNextExpiry(), 20U);
+	TEST_vidTicks(40U);
+	TEST_CHECK_EQ(au16TestLast[0], 30U);
+	TEST_CHECK_EQ(au16TestCount[0], 1U);
+	TEST_CHECK_EQ(au16TestCount[1], 1U);
+	TEST_CHECK_EQ(SWT_u16GetNextExpiry(), SWT_u16NO_EXPIRY);
+}
+
+static void TEST_vidStopMiddle(void)
+{
+	uint8 u8T0, u8T1, u8T2;
+
+	TEST_vidSetUp();
+	u8T0 = SWT_u8Create(TEST_vidClbk0, SWT_u8ONE_SHOT, SWT_u8CTX_ISR);
+	u8T1 = SWT_u8Create(TEST_vidClbk1, SWT_u8ONE_SHOT, SWT_u8CTX_ISR);
+	u8T2 = SWT_u8Create(TEST_vidClbk2, SWT_u8ONE_SHOT, SWT_u8CTX_ISR);
+	(void)SWT_eStart(u8T0, 10U);
+	(void)SWT_eStart(u8T1, 20U);
+	(void)SWT_eStart(u8T2, 30U);
+	TEST_vidTicks(5U);
+	/* the ticks of the removed entry go to the next one */
+	TEST_CHECK_EQ(SWT_eStop(u8T1), STD_ERR_OK);
+	TEST_CHECK(SWT_bIsRunning(u8T1) == FALSE);
+	TEST_vidTicks(30U);
+	TEST_CHECK_EQ(au16TestLast[0], 10U);
+	TEST_CHECK_EQ(au16TestCount[1], 0U);
+	TEST_CHECK_EQ(au16TestLast[2], 30U);
+
+	/* restart from now with the last period */
+	TEST_CHECK_EQ(SWT_eRestart(u8T1), STD_ERR_OK);
+	TEST_vidTicks(20U);
+	TEST_CHECK_EQ(au16TestLast[1], 55U);
+}
+
+static void TEST_vidPeriodic(void)
+{
+	uint8 u8T0, u8T1;
+
+	TEST_vidSetUp();
+	u8T0 = SWT_u8Create(TEST_vidClbk0, SWT_u8PERIODIC, SWT_u8CTX_ISR);
+	u8T1 = SWT_u8Create(TEST_vidClbk1, SWT_u8PERIODIC, SWT_u8CTX_ISR);
+	(void)SWT_eStart(u8T0, 7U);
+	(void)SWT_eStart(u8T1, 10U);
+	TEST_vidTicks(70U);
+	TEST_CHECK_EQ(au16TestCount[0], 10U);
+	TEST_CHECK_EQ(au16TestLast[0], 70U);
+	TEST_CHECK_EQ(au16TestCount[1], 7U);
+
+	/* a stretched tick of 9 ms: T0 (due at 77) is 2 ms late and stays on its grid */
+	u16TestNow += 9U;
+	SWT_vidTickIsr(9U);
+	TEST_CHECK_EQ(au16TestCount[0], 11U);
+	TEST_CHECK_EQ(SWT_u16GetNextExpiry(), 1U);
+	TEST_vidTicks(1U);
+	TEST_CHECK_EQ(au16TestLast[1], 80U);
+	TEST_CHECK_EQ(SWT_u16GetNextExpiry(), 4U);
+
+	/* 30 ms late covers several periods: one call each, then the next tick restarts the grids */
+	u16TestNow += 30U;
+	SWT_vidTickIsr(30U);
+	TEST_CHECK_EQ(au16TestCount[0], 12U);
+	TEST_CHECK_EQ(au16TestCount[1], 9U);
+	TEST_CHECK_EQ(SWT_u16GetNextExpiry(), 1U);
+	TEST_vidTicks(1U);
+	TEST_CHECK_EQ(au16TestCount[0], 13U);
+	TEST_CHECK_EQ(au16TestCount[1], 10U);
+	TEST_vidTicks(10U);
+	TEST_CHECK_EQ(au16TestLast[0], 118U);
+	TEST_CHECK_EQ(au16TestLast[1], 121U);
+}
+
+static void TEST_vidDeferred(void)
+{
+	uint8 u8T0;
+
+	TEST_vidSetUp();
+	u8T0 = SWT_u8Create(TEST_vidClbk3, SWT_u8PERIODIC, SWT_u8CTX_DEFERRED);
+	(void)SWT_eStart(u8T0, 4U);
+	TEST_vidTicks(4U);
+	/* flagged in the tick, called from the main loop */
+	TEST_CHECK_EQ(au16TestCount[3], 0U);
+	TEST_CHECK_EQ(SWT_u16GetNextExpiry(), 0U);
+	TEST_vidTicks(8U);
+	SWT_vidDispatch();
+	/* three expiries before the dispatch give a single call */
+	TEST_CHECK_EQ(au16TestCount[3], 1U);
+	TEST_CHECK_EQ(SWT_u16GetNextExpiry(), 4U);
+	SWT_vidDispatch();
+	TEST_CHECK_EQ(au16TestCount[3], 1U);
+
+	/* a stop drops the pending call */
+	TEST_vidTicks(4U);
+	(void)SWT_eStop(u8T0);
+	SWT_vidDispatch();
+	TEST_CHECK_EQ(au16TestCount[3], 1U);
+}
+
+static void TEST_vidPool(void)
+{
+	uint8 au8Ids[SWT_u8MAX_TIMERS];
+	uint8 u8Index;
+
+	TEST_vidSetUp();
+	for (u8Index = 0; u8Index < SWT_u8MAX_TIMERS; u8Index++){
+		au8Ids[u8Index] = SWT_u8Create(TEST_vidClbk0, SWT_u8ONE_SHOT, SWT_u8CTX_ISR);
+		TEST_CHECK(au8Ids[u8Index] != SWT_u8INVALID_TIMER);
+		(void)SWT_eStart(au8Ids[u8Index], (uint16)(SWT_u8MAX_TIMERS - u8Index));
+	}
+	TEST_CHECK_EQ(SWT_u8Create(TEST_vidClbk0, SWT_u8ONE_SHOT, SWT_u8CTX_ISR), SWT_u8INVALID_TIMER);
+	TEST_CHECK_EQ(SWT_u8Create(NULL, SWT_u8ONE_SHOT, SWT_u8CTX_ISR), SWT_u8INVALID_TIMER);
+	TEST_CHECK_EQ(SWT_eStart(au8Ids[0], 0U), STD_ERR_NOK);
+	TEST_CHECK_EQ(SWT_eStart(SWT_u8MAX_TIMERS, 5U), STD_ERR_NOK);
+
+	/* a deleted running timer leaves the list and its slot */
+	TEST_CHECK_EQ(SWT_eDelete(au8Ids[SWT_u8MAX_TIMERS - 1U]), STD_ERR_OK);
+	TEST_CHECK_EQ(SWT_u16GetNextExpiry(), 2U);
+	TEST_CHECK_EQ(SWT_eDelete(au8Ids[SWT_u8MAX_TIMERS - 1U]), STD_ERR_NOK);
+	TEST_CHECK(SWT_u8Create(TEST_vidClbk0, SWT_u8ONE_SHOT, SWT_u8CTX_ISR) == au8Ids[SWT_u8MAX_TIMERS - 1U]);
+	TEST_vidTicks(SWT_u8MAX_TIMERS);
+	TEST_CHECK_EQ(au16TestCount[0], SWT_u8MAX_TIMERS - 1U);
+}
+
+int main(void)
+{
+	TEST_vidOrder();
+	TEST_vidStopMiddle();
+	TEST_vidPeriodic();
+	TEST_vidDeferred();
+	TEST_vidPool();
+	return TEST_iResult("TEST_swtDeltaList");
+}
@@ -0,0 +1,151 @@
+/*! \file TEST_uartRing.c \brief Host unit test of the UART ring buffers. */
+/************************************************************************************************************
+*
+* File Name		: 'TEST_uartRing.c'
+* Title			: Host unit test of the UART ring buffers
+* Target		: Linux host (gcc / clang)
+*
+* TX: full and empty ring, the free running indices wrapping over 256, the polled drain with interrupts
+* disabled. RX: full ring drops the extra bytes, empty ring reads nothing, wrap.
+*
+************************************************************************************************************/
+
+/*------------------------------------------------- INCLUDES ----------------------------------------------*/
+
+#include <string.h>
+#include "TEST_check.h"
+#include "SCI_uart.h"
+
+/*--------------------------------------------- MACROS Definitions -----------------------------------------*/
+
+#define TEST_u16BAUD			9600U
+/* one 10 bit frame at 9600 bauds (U2X) is about 1042 cycles */
+#define TEST_u32FRAME_CYCLES	1100UL
+
+/*---------------------------------------------- Global Variables -----------------------------------------*/
+
+static uint8 au8TestData[300];
+static uint8 au8TestOut[SIM_u16UART_TX_SIZE];
+
+/*-------------------------------------Static functions Definitions ---------------------------------------*/
+
+static void TEST_vidSetUp(void)
+{
+	uint16 u16Index;
+
+	SIM_vidReset();
+	for (u16Index = 0; u16Index < sizeof(au8TestData); u16Index++){
+		au8TestData[u16Index] = (uint8)((u16Index * 7U) + 1U);
+	}
+	UART_init(TEST_u16BAUD);
+	/* nothing queued by a previous case */
+	while (UART_u8Read(au8TestOut, u8RX_BUFFER_SIZE) != 0U){
+	}
+}
+
+/*------------------------------------------------- Cases -------------------------------------------------*/
+
+static void TEST_vidTxFullEmpty(void)
+{
+	TEST_vidSetUp();
+	cli();
+	TEST_CHECK_EQ(UART_u8GetTxFree(), u8TX_BUFFER_SIZE);
+	/* an all or nothing write larger than the free space queues nothing */
+	TEST_CHECK_EQ(UART_u8WriteAll(au8TestData, u8TX_BUFFER_SIZE + 1U), 0U);
+	TEST_CHECK_EQ(UART_u8GetTxFree(), u8TX_BUFFER_SIZE);
+	/* interrupts disabled: nothing leaves the ring, the write stops when it is full */
+	TEST_CHECK_EQ(UART_u8Write(au8TestData, 100U), u8TX_BUFFER_SIZE);
+	TEST_CHECK_EQ(UART_u8GetTxFree(), 0U);
+	TEST_CHECK_EQ(UART_u8Write(au8TestData, 1U), 0U);
+	SIM_vidRunCycles(10UL * TEST_u32FRAME_CYCLES);
+	TEST_CHECK_EQ(SIM_u16UartTxRead(au8TestOut, sizeof(au8TestOut)), 0U);
+
+	sei();
+	SIM_vidRunCycles((u8TX_BUFFER_SIZE + 1UL) * TEST_u32FRAME_CYCLES);
+	TEST_CHECK_EQ(UART_u8GetTxFree(), u8TX_BUFFER_SIZE);
+	TEST_CHECK_EQ(SIM_u16UartTxRead(au8TestOut, sizeof(au8TestOut)), u8TX_BUFFER_SIZE);
+	TEST_CHECK(memcmp(au8TestOut, au8TestData, u8TX_BUFFER_SIZE) == 0);
+	/* the UDRE interrupt is off once the ring is empty */
+	TEST_CHECK((UCSRB & (1U << UDRIE)) == 0U);
+}
+
+static void TEST_vidTxWrap(void)
+{
+	uint16 u16Sent = 0U;
+	uint8 u8Round;
+
+	TEST_vidSetUp();
+	sei();
+	/* 12 * 50 bytes: the 8-bit indices wrap twice, the ring position many times */
+	for (u8Round = 0; u8Round < 12U; u8Round++){
+		TEST_CHECK_EQ(UART_u8Write(&au8TestData[u8Round * 23U], 50U), 50U);
+		SIM_vidRunCycles(51UL * TEST_u32FRAME_CYCLES);
+		TEST_CHECK_EQ(SIM_u16UartTxRead(au8TestOut, sizeof(au8TestOut)), 50U);
+		TEST_CHECK(memcmp(au8TestOut, &au8TestData[u8Round * 23U], 50U) == 0);
+		u16Sent += 50U;
+	}
+	TEST_CHECK_EQ(u16Sent, 600U);
+	TEST_CHECK_EQ(UART_u8GetTxFree(), u8TX_BUFFER_SIZE);
+}
+
+static void TEST_vidTxPolled(void)
+{
+	char acText[201];
+	uint16 u16Len;
+
+	TEST_vidSetUp();
+	memset(acText, 'x', 200U);
+	acText[200] = '\0';
+	/* longer than the ring with interrupts disabled: drained by polling UDRE, nothing lost */
+	cli();
+	UART_sendString(acText);
+	UART_vidTxFlush();
+	u16Len = SIM_u16UartTxRead(au8TestOut, sizeof(au8TestOut));
+	TEST_CHECK_EQ(u16Len, 200U);
+	TEST_CHECK(memcmp(au8TestOut, acText, 200U) == 0);
+	sei();
+}
+
+static void TEST_vidRxFullEmpty(void)
+{
+	uint8 au8Read[64];
+
+	TEST_vidSetUp();
+	sei();
+	TEST_CHECK_EQ(UART_u8Read(au8Read, sizeof(au8Read)), 0U);
+	/* more than the ring holds: the RXC ISR drops the bytes that do not fit */
+	SIM_vidUartRxPush(au8TestData, u8RX_BUFFER_SIZE + 8U);
+	SIM_vidRunCycles((u8RX_BUFFER_SIZE + 9UL) * TEST_u32FRAME_CYCLES);
+	TEST_CHECK_EQ(UART_u8Read(au8Read, 10U), 10U);
+	TEST_CHECK_EQ(UART_u8Read(&au8Read[10], sizeof(au8Read) - 10U), u8RX_BUFFER_SIZE - 10U);
+	TEST_CHECK(memcmp(au8Read, au8TestData, u8RX_BUFFER_SIZE) == 0);
+	TEST_CHECK_EQ(UART_u8Read(au8Read, sizeof(au8Read)), 0U);
+}
+
+static void TEST_vidRxWrap(void)
+{
+	uint8 au8Read[u8RX_BUFFER_SIZE];
+	uint8 u8Round;
+
+	TEST_vidSetUp();
+	sei();
+	for (u8Round = 0; u8Round < 15U; u8Round++){
+		SIM_vidUartRxPush(&au8TestData[u8Round * 13U], 20U);
+		SIM_vidRunCycles(21UL * TEST_u32FRAME_CYCLES);
+		TEST_CHECK_EQ(UART_u8Read(au8Read, sizeof(au8Read)), 20U);
+		TEST_CHECK(memcmp(au8Read, &au8TestData[u8Round * 13U], 20U) == 0);
+	}
+	/* blocking read of a byte already received */
+	SIM_vidUartRxPush((const uint8 *)"#", 1U);
+	TEST_CHECK_EQ(UART_recieveByte(), '#');
+}
+
+int main(void)
+{
+	TEST_vidTxFullEmpty();
+	TEST_vidTxWrap();
+	TEST_vidTxPolled();
+	TEST_vidRxFullEmpty();
+	TEST_vidRxWrap();
+	return TEST_iResult("TEST_uartRing");
+}